@@ -127,6 +127,42 @@ uint32_t bb_sys_timer_get_run_time_ticks(void)
     return ret;
 }
 
+/*
+ * Control-system sampling timer: generates an update interrupt every period.
+ * The interrupt routine (SYS_CTRL_ISR) is implemented by the application,
+ * it must call bb_sys_timer_ctrl_clear_it().
+ */
+void bb_sys_timer_ctrl_config(uint32_t period_us, uint32_t nvic_priority)
+{
+    TIM_TimeBaseInitTypeDef TIM_BaseStruct;
+
+    /* Enable timer clock */
+    SYS_CTRL_TIM_CLK_ENABLE();
+
+    /* Setup timer */
+    TIM_BaseStruct.TIM_ClockDivision        = TIM_CKD_DIV1;
+    TIM_BaseStruct.TIM_Prescaler            = SYS_CTRL_PRESCALER;
+    TIM_BaseStruct.TIM_Period               = period_us - 1;
+    TIM_BaseStruct.TIM_RepetitionCounter    = 0;
+    TIM_TimeBaseInit(SYS_CTRL_TIM, &TIM_BaseStruct);
+
+    /* Configure interrupt */
+    TIM_ClearITPendingBit(SYS_CTRL_TIM, TIM_IT_Update);
+    TIM_ITConfig(SYS_CTRL_TIM, TIM_IT_Update, ENABLE);
+    NVIC_SetPriority(SYS_CTRL_IRQn, nvic_priority);
+    NVIC_EnableIRQ(SYS_CTRL_IRQn);
+
+    /* Clear and start timer */
+    TIM_SetCounter(SYS_CTRL_TIM, 0);
+    TIM_Cmd(SYS_CTRL_TIM, ENABLE);
+}
+
+void bb_sys_timer_ctrl_clear_it(void)
+{
+    NVIC_ClearPendingIRQ(SYS_CTRL_IRQn);
+    TIM_ClearITPendingBit(SYS_CTRL_TIM, TIM_IT_Update);
+}
+
 /*
  * Run-Time Timer Interrupt Sub-routine
  * Required to implement a 32bits timer.
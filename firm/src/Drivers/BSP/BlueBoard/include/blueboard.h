@@ -61,6 +61,13 @@
  #define SYS_RUNSTATS_IRQn                   TIM6_DAC_IRQn
  #define SYS_RUNSTATS_ISR                    TIM6_DAC_IRQHandler
 
+ /* Timer to be used for sampling the motion control-system */
+ #define SYS_CTRL_TIM                        TIM7
+ #define SYS_CTRL_TIM_CLK_ENABLE()           RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM7, ENABLE)
+ #define SYS_CTRL_TIM_CLK_DISABLE()          RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM7, DISABLE)
+ #define SYS_CTRL_IRQn                       TIM7_IRQn
+ #define SYS_CTRL_ISR                        TIM7_IRQHandler
+
 /**
 ********************************************************************************
 **
@@ -173,6 +180,8 @@ void bb_system_clock_config(void);
 void bb_sys_cpu_cache_enable(void);
 void bb_sys_timer_run_time_config();
 uint32_t bb_sys_timer_get_run_time_ticks(void);
+void bb_sys_timer_ctrl_config(uint32_t period_us, uint32_t nvic_priority);
+void bb_sys_timer_ctrl_clear_it(void);
 
 /* Power modules */
 void bb_pwr_init(void);
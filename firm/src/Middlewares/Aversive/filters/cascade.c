@@ -0,0 +1,111 @@
+/*
+ *  Copyright I-Grebot (2026)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <string.h>
+
+#include <aversive.h>
+#include <cascade.h>
+
+void cascade_init(struct cascade_filter *c)
+{
+	memset(c, 0, sizeof(*c));
+	c->outer_divider = 1;
+}
+
+void cascade_reset(struct cascade_filter *c)
+{
+	c->outer_count = 0;
+	c->outer_value = 0;
+	c->speed_consign = 0;
+	c->speed_error = 0;
+}
+
+void cascade_set_outer_filter(struct cascade_filter *c,
+			      int32_t (*outer_filter)(void *, int32_t),
+			      void *outer_filter_params)
+{
+	c->outer_filter = outer_filter;
+	c->outer_filter_params = outer_filter_params;
+}
+
+void cascade_set_inner_filter(struct cascade_filter *c,
+			      int32_t (*inner_filter)(void *, int32_t),
+			      void *inner_filter_params)
+{
+	c->inner_filter = inner_filter;
+	c->inner_filter_params = inner_filter_params;
+}
+
+void cascade_set_speed_feedback(struct cascade_filter *c,
+				int32_t (*speed_feedback)(void *),
+				void *speed_feedback_params)
+{
+	c->speed_feedback = speed_feedback;
+	c->speed_feedback_params = speed_feedback_params;
+}
+
+void cascade_set_speed_feedforward(struct cascade_filter *c,
+				   int32_t (*speed_feedforward)(void *),
+				   void *speed_feedforward_params)
+{
+	c->speed_feedforward = speed_feedforward;
+	c->speed_feedforward_params = speed_feedforward_params;
+}
+
+void cascade_set_outer_divider(struct cascade_filter *c, uint16_t divider)
+{
+	c->outer_divider = divider ? divider : 1;
+}
+
+int32_t cascade_get_speed_consign(struct cascade_filter *c)
+{
+	return c->speed_consign;
+}
+
+int32_t cascade_get_speed_error(struct cascade_filter *c)
+{
+	return c->speed_error;
+}
+
+int32_t cascade_do_filter(void *data, int32_t in)
+{
+	struct cascade_filter *c = data;
+	int32_t speed = 0;
+
+	/* outer loop, at a lower rate: position error to speed consign */
+	if (c->outer_count == 0 && c->outer_filter)
+		c->outer_value = c->outer_filter(c->outer_filter_params, in);
+	if (++c->outer_count >= c->outer_divider)
+		c->outer_count = 0;
+
+	/* the planned speed changes at each call */
+	c->speed_consign = c->outer_value;
+	if (c->speed_feedforward)
+		c->speed_consign += c->speed_feedforward(c->speed_feedforward_params);
+
+	/* inner loop: speed error to command */
+	if (c->speed_feedback)
+		speed = c->speed_feedback(c->speed_feedback_params);
+	c->speed_error = c->speed_consign - speed;
+
+	if (c->inner_filter)
+		return c->inner_filter(c->inner_filter_params, c->speed_error);
+
+	return c->speed_error;
+}
@@ -29,6 +29,7 @@ void pid_init(struct pid_filter *p)
 	memset(p, 0, sizeof(*p));
 	p->gain_P = 1 ;
 	p->derivate_nb_samples = 1;
+	p->period_divider = 1;
 }
 
 /** this function will initialize all fieds of pid structure to 0,
@@ -73,6 +74,14 @@ int8_t pid_set_derivate_filter(struct pid_filter *p, uint8_t nb_samples)
 	return ret;
 }
 
+/** The gains are given for a period, the filter being called divider times
+ * in this period: the integral and derivate terms are scaled so that the
+ * same gains give the same behaviour at any sampling rate. */
+void pid_set_period_divider(struct pid_filter *p, uint16_t divider)
+{
+	p->period_divider = divider ? divider : 1;
+}
+
 int16_t pid_get_gain_P(struct pid_filter *p)
 {
 	return (p->gain_P);
@@ -115,6 +124,11 @@ uint8_t pid_get_derivate_filter(struct pid_filter *p)
 	return (p->derivate_nb_samples);
 }
 
+uint16_t pid_get_period_divider(struct pid_filter *p)
+{
+	return (p->period_divider);
+}
+
 int32_t pid_get_value_I(struct pid_filter *p)
 {
 	int32_t ret;
@@ -178,13 +192,15 @@ int32_t pid_do_filter(void * data, int32_t in)
 	derivate = in - p->prev_samples[prev_index];
 	p->integral += in ;
 
+	/* the integral grows divider times faster than in the period of
+	 * the gains, and the derivate is divider times smaller */
 	if (p->max_I)
-		S_MAX(p->integral, p->max_I) ;
+		S_MAX(p->integral, p->max_I * p->period_divider) ;
 
 	/* so, command = P.coef_P + I.coef_I + D.coef_D */
 	command = in * p->gain_P + 
-		p->integral * p->gain_I +
-		(derivate * p->gain_D) / p->derivate_nb_samples ;
+		(p->integral / p->period_divider) * p->gain_I +
+		(derivate * p->gain_D * p->period_divider) / p->derivate_nb_samples ;
 
 	if ( command < 0 )
 		command = -( -command >> p->out_shift );
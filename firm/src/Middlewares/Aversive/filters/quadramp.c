@@ -32,13 +32,16 @@
 void quadramp_init(struct quadramp_filter * q)
 {
 	memset(q, 0, sizeof(*q));
+	q->period_divider = 1;
 }
 
 
 void quadramp_reset(struct quadramp_filter * q)
 {
 	q->previous_var = 0;
+	q->previous_acc = 0;
 	q->previous_out = 0;
+	q->previous_frac = 0;
 	q->previous_in = 0;
 }
 
@@ -58,13 +61,214 @@ void quadramp_set_1st_order_vars(struct quadramp_filter * q,
 	q->var_1st_ord_neg = var_1st_ord_neg;
 }
 
+void quadramp_set_3rd_order_var(struct quadramp_filter * q, 
+				uint32_t var_3rd_ord)
+{
+	q->var_3rd_ord = var_3rd_ord;
+}
+
+void quadramp_set_end_var(struct quadramp_filter * q, uint32_t var_end)
+{
+	q->var_end = var_end;
+}
+
+/** The speed and acceleration vars are given for a period, the filter
+ * being called divider times in this period (e.g. vars are given per
+ * trajectory period, and the control system runs faster). */
+void quadramp_set_period_divider(struct quadramp_filter * q, uint16_t divider)
+{
+	q->period_divider = divider ? divider : 1;
+}
 
 uint8_t quadramp_is_finished(struct quadramp_filter *q)
 {
 	return (q->previous_out == q->previous_in &&
+		q->previous_frac == 0 &&
 		q->previous_var == 0);
 }
 
+/** With a jerk j, the deceleration a is reached after a/j and the
+ * braking from v to ve lasts a/j + (v-ve)/a, at a mean speed of
+ * (v+ve)/2 (symmetric S-curve). Shorter brakings never reach a and
+ * last 2.sqrt((v-ve)/j). */
+static float braking_distance(float v, float var_end, float var_2nd_ord,
+			      float var_3rd_ord)
+{
+	float dv = v - var_end;
+
+	if (dv <= 0 || var_2nd_ord == 0)
+		return 0;
+
+	if (var_3rd_ord == 0)
+		return (v * v - var_end * var_end) / (2 * var_2nd_ord);
+
+	if (dv >= var_2nd_ord * var_2nd_ord / var_3rd_ord)
+		return (v + var_end) / 2 * (var_2nd_ord / var_3rd_ord + dv / var_2nd_ord);
+
+	return (v + var_end) * sqrtf(dv / var_3rd_ord);
+}
+
+/** Same as above, from a state where the acceleration is acc: it is
+ * first ramped down to 0 (acc > 0), or the braking is considered from
+ * the point where it started (acc < 0). */
+static float braking_distance_acc(float v, float acc, float var_end,
+				  float var_2nd_ord, float var_3rd_ord)
+{
+	float t, s;
+
+	if (acc == 0 || var_3rd_ord == 0)
+		return braking_distance(v, var_end, var_2nd_ord, var_3rd_ord);
+
+	t = ABS(acc) / var_3rd_ord;
+	if (acc > 0) {
+		s = v * t + acc * t * t / 2 - var_3rd_ord * t * t * t / 6;
+		v += acc * acc / (2 * var_3rd_ord);
+		return s + braking_distance(v, var_end, var_2nd_ord, var_3rd_ord);
+	}
+
+	v += acc * acc / (2 * var_3rd_ord);
+	s = v * t - var_3rd_ord * t * t * t / 6;
+	s = braking_distance(v, var_end, var_2nd_ord, var_3rd_ord) - s;
+	return (s > 0) ? s : 0;
+}
+
+float quadramp_braking_var(float d, float var_end, float var_2nd_ord,
+			   float var_3rd_ord)
+{
+	float b, v, q, w;
+
+	if (var_2nd_ord == 0)
+		return INFINITY;
+
+	if (d <= 0)
+		return var_end;
+
+	if (var_3rd_ord == 0)
+		return sqrtf(var_end * var_end + 2 * var_2nd_ord * d);
+
+	/* solved from braking_distance(), long brakings: they reach
+	 * var_2nd_ord from v - var_end >= b, i.e. beyond the distance
+	 * (2.var_end + b).var_2nd_ord/var_3rd_ord */
+	b = var_2nd_ord * var_2nd_ord / var_3rd_ord;
+	if (d >= (2 * var_end + b) * var_2nd_ord / var_3rd_ord) {
+		v = (sqrtf((b - 2 * var_end) * (b - 2 * var_end) + 8 * var_2nd_ord * d) - b) / 2;
+		return (v > var_end) ? v : var_end;
+	}
+
+	/* short brakings: with s = sqrt(v - var_end), the distance gives
+	 * s^3 + 2.var_end.s = d.sqrt(var_3rd_ord), whose real root is
+	 * w - 2.var_end/(3.w) (Cardano) */
+	q = d * sqrtf(var_3rd_ord) / 2;
+	w = cbrtf(q + sqrtf(q * q + 8 * var_end * var_end * var_end / 27));
+	v = w - 2 * var_end / (3 * w);
+
+	return var_end + v * v;
+}
+
+/** S-curve ramp, used when a jerk limit or an end speed is set. The
+ * computations are done in the direction of the input: the speed tends
+ * to the max one, with an acceleration varying by var_3rd_ord at most,
+ * unless the braking distance to var_end would then exceed the distance
+ * left, in which case the filter brakes. */
+static int32_t quadramp_do_scurve(struct quadramp_filter * q, int32_t in)
+{
+	float divider = q->period_divider;
+	float var_3rd_ord = q->var_3rd_ord / (divider * divider * divider);
+	float var_end = q->var_end / divider;
+	float var_1st_ord, var_2nd_ord_up, var_2nd_ord_down;
+	float d, d_end, v, acc, prev_acc, dv, acc_max;
+	float pos_target;
+	float sign = 1;
+
+	d = (float)(in - q->previous_out) - q->previous_frac ;
+
+	/* on the input, the speed is brought to 0 in its own direction */
+	if (d < 0 || (d == 0 && q->previous_var < 0)) {
+		sign = -1;
+		var_1st_ord = q->var_1st_ord_neg / divider;
+		var_2nd_ord_up = q->var_2nd_ord_neg / (divider * divider);
+		var_2nd_ord_down = q->var_2nd_ord_pos / (divider * divider);
+	}
+	else {
+		var_1st_ord = q->var_1st_ord_pos / divider;
+		var_2nd_ord_up = q->var_2nd_ord_pos / (divider * divider);
+		var_2nd_ord_down = q->var_2nd_ord_neg / (divider * divider);
+	}
+	d *= sign;
+	v = q->previous_var * sign;
+	prev_acc = q->previous_acc * sign;
+	if (var_end > var_1st_ord)
+		var_end = var_1st_ord;
+
+	/* the input is only passed at var_end when it is moved further in
+	 * the meantime: var_end is reached where the filter can still stop
+	 * on the input, and the braking goes on to 0 from there */
+	d_end = d - braking_distance(var_end, 0, var_2nd_ord_down, var_3rd_ord);
+	if (d_end <= 0) {
+		d_end = d;
+		var_end = 0;
+	}
+
+	/* towards the max speed, the acceleration being ramped down in
+	 * time so that the speed does not overshoot: from acc, the steps
+	 * acc, acc - var_3rd_ord, ... add up to acc.(acc/var_3rd_ord + 1)/2 */
+	dv = var_1st_ord - v;
+	if (dv > 0) {
+		acc_max = var_2nd_ord_up;
+		if (var_3rd_ord && (acc_max == 0 || 2 * var_3rd_ord * dv < acc_max * (acc_max + var_3rd_ord)))
+			acc_max = sqrtf(var_3rd_ord * var_3rd_ord / 4 + 2 * var_3rd_ord * dv) - var_3rd_ord / 2;
+		acc = (acc_max && dv > acc_max) ? acc_max : dv;
+	}
+	else {
+		acc_max = var_2nd_ord_down;
+		if (var_3rd_ord && (acc_max == 0 || -2 * var_3rd_ord * dv < acc_max * (acc_max + var_3rd_ord)))
+			acc_max = sqrtf(var_3rd_ord * var_3rd_ord / 4 - 2 * var_3rd_ord * dv) - var_3rd_ord / 2;
+		acc = (acc_max && dv < -acc_max) ? -acc_max : dv;
+	}
+	if (var_3rd_ord) {
+		if (acc > prev_acc + var_3rd_ord)
+			acc = prev_acc + var_3rd_ord;
+		else if (acc < prev_acc - var_3rd_ord)
+			acc = prev_acc - var_3rd_ord;
+	}
+
+	/* brake if var_end cannot be reached in time after this step */
+	if (braking_distance_acc(v + acc, acc, var_end, var_2nd_ord_down, var_3rd_ord) >
+	    d_end - (v + acc)) {
+		if (var_3rd_ord)
+			acc = prev_acc - var_3rd_ord;
+		else	/* speed after the step, from which var_end is reached over what is left */
+			acc = sqrtf(var_end * var_end + var_2nd_ord_down * (var_2nd_ord_down + 2 * d_end)) -
+				var_2nd_ord_down - v;
+		if (var_2nd_ord_down && acc < -var_2nd_ord_down)
+			acc = -var_2nd_ord_down;
+	}
+
+	/* input reached within this step, or closer than the output
+	 * resolution (the braking is a bit early) at a speed which can be
+	 * stopped in one step */
+	if (v + acc >= d ||
+	    (d < 1 && (var_2nd_ord_down == 0 || v + acc <= var_2nd_ord_down))) {
+		q->previous_out = in;
+		q->previous_frac = 0;
+		v += acc;
+		if (v > d)
+			v = d;
+		q->previous_var = (v > 0) ? v * sign : 0;
+		q->previous_acc = 0;
+	}
+	else {
+		q->previous_var = (v + acc) * sign;
+		q->previous_acc = acc * sign;
+		pos_target = q->previous_frac + q->previous_var;
+		q->previous_out += (int32_t) floorf(pos_target);
+		q->previous_frac = pos_target - floorf(pos_target);
+	}
+	q->previous_in = in;
+
+	return q->previous_out;
+}
+
 /**
  * Process the ramp
  * 
@@ -75,48 +279,55 @@ uint8_t quadramp_is_finished(struct quadramp_filter *q)
 int32_t quadramp_do_filter(void * data, int32_t in)
 {
 	struct quadramp_filter * q = data;
-	int32_t d ;
-	int32_t pos_target;
-	int32_t var_1st_ord_pos = 0;
-	int32_t var_1st_ord_neg = 0;
-	int32_t var_2nd_ord_pos = 0;
-	int32_t var_2nd_ord_neg = 0;
-	int32_t previous_var, previous_out ;
+	float d ;
+	float pos_target;
+	float var_1st_ord_pos = 0;
+	float var_1st_ord_neg = 0;
+	float var_2nd_ord_pos = 0;
+	float var_2nd_ord_neg = 0;
+	float previous_var ;
+	float divider = q->period_divider;
+
+	if (q->var_3rd_ord || q->var_end)
+		return quadramp_do_scurve(q, in);
 
+	/* vars are scaled from their period to the calls period:
+	 * speeds by 1/divider, accelerations by 1/divider^2 */
 	if ( q->var_1st_ord_pos )
-		var_1st_ord_pos = q->var_1st_ord_pos ;  
+		var_1st_ord_pos = q->var_1st_ord_pos / divider ;  
 
 	if ( q->var_1st_ord_neg )
-		var_1st_ord_neg = -q->var_1st_ord_neg ;
+		var_1st_ord_neg = -(q->var_1st_ord_neg / divider) ;
 
 	if ( q->var_2nd_ord_pos )
-		var_2nd_ord_pos = q->var_2nd_ord_pos ;  
+		var_2nd_ord_pos = q->var_2nd_ord_pos / (divider * divider) ;  
 
 	if ( q->var_2nd_ord_neg )
-		var_2nd_ord_neg = -q->var_2nd_ord_neg ;
+		var_2nd_ord_neg = -(q->var_2nd_ord_neg / (divider * divider)) ;
 
 	previous_var = q->previous_var;
-	previous_out = q->previous_out;
 
-	d = in - previous_out ;
+	/* output is previous_out + previous_frac, kept apart so that small
+	 * variations are not lost on large positions */
+	d = (float)(in - q->previous_out) - q->previous_frac ;
 
 	/* Deceleration ramp */
 	if ( d > 0 && var_2nd_ord_neg) {
-		int32_t ramp_pos;
+		float ramp_pos;
 		/* var_2nd_ord_neg < 0 */
 		/* real EQ : sqrt( var_2nd_ord_neg^2/4 - 2.d.var_2nd_ord_neg ) + var_2nd_ord_neg/2 */
-		ramp_pos = sqrt( (var_2nd_ord_neg*var_2nd_ord_neg)/4 - 2*d*var_2nd_ord_neg ) + var_2nd_ord_neg/2;
+		ramp_pos = sqrtf( (var_2nd_ord_neg*var_2nd_ord_neg)/4 - 2*d*var_2nd_ord_neg ) + var_2nd_ord_neg/2;
 
 		if(ramp_pos < var_1st_ord_pos)
 			var_1st_ord_pos = ramp_pos ;
 	}
 
 	else if (d < 0 && var_2nd_ord_pos) {
-		int32_t ramp_neg;
+		float ramp_neg;
     
 		/* var_2nd_ord_pos > 0 */
 		/* real EQ : sqrt( var_2nd_ord_pos^2/4 - 2.d.var_2nd_ord_pos ) - var_2nd_ord_pos/2 */
-		ramp_neg = -sqrt( (var_2nd_ord_pos*var_2nd_ord_pos)/4 - 2*d*var_2nd_ord_pos ) - var_2nd_ord_pos/2;
+		ramp_neg = -sqrtf( (var_2nd_ord_pos*var_2nd_ord_pos)/4 - 2*d*var_2nd_ord_pos ) - var_2nd_ord_pos/2;
 	
 		/* ramp_neg < 0 */
 		if(ramp_neg > var_1st_ord_neg)
@@ -163,22 +374,27 @@ int32_t quadramp_do_filter(void * data, int32_t in)
 	 * Position consign : can we reach the position with our speed ?
 	 */
 	if ( /* var_1st_ord_pos &&  */d > var_1st_ord_pos ) {
-		pos_target = previous_out + var_1st_ord_pos ;
+		pos_target = q->previous_frac + var_1st_ord_pos ;
 		previous_var = var_1st_ord_pos ;
 	}
 	else if ( /* var_1st_ord_neg &&  */d < var_1st_ord_neg ) {
-		pos_target = previous_out + var_1st_ord_neg ;
+		pos_target = q->previous_frac + var_1st_ord_neg ;
 		previous_var = var_1st_ord_neg ;
 	}
 	else {
-		pos_target = previous_out + d ;
+		/* target reached, no fractional part left */
+		pos_target = 0 ;
+		q->previous_out = in ;
+		q->previous_frac = 0 ;
 		previous_var = d ;
 	}
 
 	// update previous_out and previous_var
+	q->previous_acc = previous_var - q->previous_var;
 	q->previous_var = previous_var;
-	q->previous_out = pos_target;
+	q->previous_out += (int32_t) floorf(pos_target);
+	q->previous_frac = pos_target - floorf(pos_target);
 	q->previous_in = in;
 
-	return pos_target ;
+	return q->previous_out ;
 }
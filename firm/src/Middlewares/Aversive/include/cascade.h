@@ -0,0 +1,96 @@
+/*
+ *  Copyright I-Grebot (2026)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/* Cascaded position / speed correct filter.
+ *
+ * Used as the correct filter of a control system, in place of a single
+ * position pid. The outer filter turns the position error into a speed
+ * consign, to which the planned speed may be added. The inner filter
+ * turns the speed error into the command. The inner filter runs at each
+ * call, on a speed measured at this rate, the outer one every
+ * outer_divider calls only.
+ */
+
+#ifndef _CASCADE_H_
+#define _CASCADE_H_
+
+#include <aversive.h>
+
+struct cascade_filter
+{
+	int32_t (*outer_filter)(void *, int32_t); /**< position error -> speed */
+	void *outer_filter_params;
+
+	int32_t (*inner_filter)(void *, int32_t); /**< speed error -> command */
+	void *inner_filter_params;
+
+	int32_t (*speed_feedback)(void *);    /**< measured speed */
+	void *speed_feedback_params;
+
+	int32_t (*speed_feedforward)(void *); /**< planned speed, may be NULL */
+	void *speed_feedforward_params;
+
+	uint16_t outer_divider; /**< number of inner calls per outer call */
+	uint16_t outer_count;
+
+	int32_t outer_value;   /**< last output of the outer filter */
+	int32_t speed_consign; /**< outer output and feed-forward */
+	int32_t speed_error;
+};
+
+/** Initialization of the filter */
+void cascade_init(struct cascade_filter *c);
+
+/** reset state, the outer filter runs at the next call */
+void cascade_reset(struct cascade_filter *c);
+
+void cascade_set_outer_filter(struct cascade_filter *c,
+			      int32_t (*outer_filter)(void *, int32_t),
+			      void *outer_filter_params);
+
+void cascade_set_inner_filter(struct cascade_filter *c,
+			      int32_t (*inner_filter)(void *, int32_t),
+			      void *inner_filter_params);
+
+void cascade_set_speed_feedback(struct cascade_filter *c,
+				int32_t (*speed_feedback)(void *),
+				void *speed_feedback_params);
+
+void cascade_set_speed_feedforward(struct cascade_filter *c,
+				   int32_t (*speed_feedforward)(void *),
+				   void *speed_feedforward_params);
+
+/**
+ * The outer filter is called once every divider calls. Its gains are
+ * then given for divider times less calls per period (see
+ * pid_set_period_divider()).
+ */
+void cascade_set_outer_divider(struct cascade_filter *c, uint16_t divider);
+
+/** get the last speed consign and error */
+int32_t cascade_get_speed_consign(struct cascade_filter *c);
+int32_t cascade_get_speed_error(struct cascade_filter *c);
+
+/** 
+ * Process the position error (first parameter should be a (struct
+ * cascade_filter *)), returns the command.
+ */
+int32_t cascade_do_filter(void *data, int32_t in);
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ *  Copyright I-Grebot (2026)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/* Single precision trigonometry for the motion modules.
+ *
+ * The FPU of the target only handles floats: the double functions of the
+ * libm (and float ones relying on them) are emulated in software. These
+ * ones only use float operations done by the FPU, for the angles met by
+ * the position and trajectory managers.
+ *
+ * Maximum absolute errors, checked against the double libm:
+ *   fast_sincosf(), fast_sinf(), fast_cosf() : 1.2e-7 for |a| <= 8.pi
+ *                                              (error grows with |a|)
+ *   fast_atan2f()                            : 2.5e-7 rad (1 ulp of pi)
+ */
+
+#ifndef _FAST_MATH_H_
+#define _FAST_MATH_H_
+
+#define M_PI_F   3.14159265f
+#define M_2PI_F  6.28318531f
+
+/** compute both sine and cosine of a (radian) */
+void fast_sincosf(float a, float *s, float *c);
+
+/** sine of a (radian) */
+float fast_sinf(float a);
+
+/** cosine of a (radian) */
+float fast_cosf(float a);
+
+/** angle of the (x, y) vector, in [-pi, pi] (radian) */
+float fast_atan2f(float y, float x);
+
+#endif
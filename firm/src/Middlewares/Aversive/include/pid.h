@@ -43,6 +43,8 @@ struct pid_filter
 	int32_t max_I; /**<   Integral saturation levels */
 	int32_t max_out; /**< Out saturation levels */
 
+	uint16_t period_divider; /**< number of calls per period the gains are tuned for */
+
 	int32_t integral; /**< previous integral parameter */
 	int32_t prev_D;   /**< previous derivate parameter */
 	int32_t prev_out; /**< previous out command (for debug only) */
@@ -59,6 +61,7 @@ void pid_set_gains(struct pid_filter *p, int16_t gp, int16_t gi, int16_t gd) ;
 void pid_set_maximums(struct pid_filter *p, int32_t max_in, int32_t max_I, int32_t max_out);
 void pid_set_out_shift(struct pid_filter *p, uint8_t out_shift);
 int8_t pid_set_derivate_filter(struct pid_filter *p, uint8_t nb_samples);
+void pid_set_period_divider(struct pid_filter *p, uint16_t divider);
 
 /* accessors of all parameter of pid structure*/
 int16_t pid_get_gain_P(struct pid_filter *p);
@@ -69,6 +72,7 @@ int32_t pid_get_max_I(struct pid_filter *p);
 int32_t pid_get_max_out(struct pid_filter *p);
 uint8_t pid_get_out_shift(struct pid_filter *p);
 uint8_t pid_get_derivate_filter(struct pid_filter *p);
+uint16_t pid_get_period_divider(struct pid_filter *p);
 
 /** get the sum of all nput samples since the filter initialisation */
 int32_t pid_get_value_I(struct pid_filter *p);
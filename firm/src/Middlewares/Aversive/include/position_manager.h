@@ -38,14 +38,14 @@ struct robot_physical_params
 
 
 /** 
- * stores a cartesian position on the area in double
+ * stores a cartesian position on the area in float
  * WARNING : a is stored in radian
  */
 struct xya_position 
 {
-	double x;
-	double y;
-	double a;
+	float x;
+	float y;
+	float a;
 };
 
 /**
@@ -59,16 +59,34 @@ struct xya_position_s16
 	int16_t a;
 };
 
+/**
+ * Pose of the robot, all fields coming from the same update
+ */
+struct robot_pose
+{
+	struct xya_position pos_f;
+	struct xya_position_s16 pos_s16;
+	float speed_d; /**<< distance speed (mm/s) */
+	float speed_a; /**<< angle speed (rad/s) */
+};
+
 /**
  * Structure that stores everthing we need to get and stores the
  * position of the robot 
+ *
+ * The pose is read without lock: seq is odd while it is being updated,
+ * and readers retry when it changed during their copy. Writers are
+ * serialized by vLockRobotPosition(), which must not block (the
+ * control system is a writer).
  */
 struct robot_position
 {
 	uint8_t use_ext;
 	struct robot_physical_params phys;
-	struct xya_position pos_d;
-	struct xya_position_s16 pos_s16;
+	float sample_freq; /**<< frequency of position_manage() calls (Hz) */
+	volatile uint32_t seq;
+	struct robot_pose pose;
+	struct xya_position pos_err; /**<< rounding errors of pose.pos_f, added back on next update */
 	struct rs_polar prev_encoders;
 	struct robot_system *rs;
 #ifdef CONFIG_MODULE_COMPENSATE_CENTRIFUGAL_FORCE	
@@ -100,6 +118,12 @@ void position_use_mot(struct robot_position *pos);
 void position_set_physical_params(struct robot_position *pos, double track_mm,
 				  double distance_imp_per_mm);
 
+/** 
+ * Set the period of the position_manage() calls, used to process the
+ * speeds of the pose (in us, speeds stay at 0 while not set).
+ */
+void position_set_sample_period(struct robot_position *pos, uint32_t period_us);
+
 /** 
  * Save in pos structure the pointer to the associated robot_system. 
  * The robot_system structure is used to get values from virtual encoders
@@ -115,6 +139,11 @@ void position_set_related_robot_system(struct robot_position *pos, struct robot_
 void position_manage(struct robot_position *pos);
 
 
+/**
+ * copy the current pose, without lock (retries while the pose is updated)
+ */
+void position_get_pose(struct robot_position *pos, struct robot_pose *pose);
+
 /**
  * returns current x
  */
@@ -130,6 +159,21 @@ int16_t position_get_y_s16(struct robot_position *pos);
  */
 int16_t position_get_a_deg_s16(struct robot_position *pos);
 
+/**
+ * returns current x
+ */
+float position_get_x_float(struct robot_position *pos);
+
+/**
+ * returns current y
+ */
+float position_get_y_float(struct robot_position *pos);
+
+/**
+ * returns current alpha (radian)
+ */
+float position_get_a_rad_float(struct robot_position *pos);
+
 /**
  * returns current x
  */
@@ -30,9 +30,15 @@ struct quadramp_filter
     uint32_t var_2nd_ord_neg;
     uint32_t var_1st_ord_pos;
     uint32_t var_1st_ord_neg;
+    uint32_t var_3rd_ord;    /**< jerk limit, 0 for none */
+    uint32_t var_end;        /**< speed when reaching the input (junctions) */
 
-    int32_t previous_var;
+    uint16_t period_divider; /**< number of calls per period of the vars */
+
+    float previous_var;
+    float previous_acc;     /**< variation of previous_var (jerk limit only) */
     int32_t previous_out;
+    float previous_frac;    /**< fractional part of the output (< 1) */
     int32_t previous_in;
 };
 
@@ -49,12 +55,37 @@ void quadramp_set_1st_order_vars(struct quadramp_filter *q,
 				 uint32_t var_1st_ord_pos, 
 				 uint32_t var_1st_ord_neg);
 
+/**
+ * Limit the variation of the acceleration (S-curve ramps), 0 to
+ * disable. The deceleration ramps are planned with it.
+ */
+void quadramp_set_3rd_order_var(struct quadramp_filter *q, 
+				uint32_t var_3rd_ord);
+
+/**
+ * Speed kept towards the input, 0 to stop on it. Used when the input
+ * is moved further before it is reached (trajectory junctions): the
+ * filter is at var_end where it can still stop on the input, and
+ * brakes to 0 from there while the input is not moved.
+ */
+void quadramp_set_end_var(struct quadramp_filter *q, uint32_t var_end);
+
+void quadramp_set_period_divider(struct quadramp_filter *q, uint16_t divider);
+
 /**
  * Return 1 when (filter_input == filter_output && 1st_ord variation
  * is 0 --speed is 0-- ).
  */
 uint8_t quadramp_is_finished(struct quadramp_filter *q);
 
+/**
+ * Maximum speed from which the filter can reach end_var within the
+ * distance d, with the given acceleration and jerk (0 for none). All
+ * of them are given for a same period.
+ */
+float quadramp_braking_var(float d, float var_end, float var_2nd_ord,
+			   float var_3rd_ord);
+
 /**
  * Process the ramp
  * 
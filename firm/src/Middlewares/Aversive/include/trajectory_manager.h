@@ -27,8 +27,23 @@
 #include <robot_system.h>
 #include "FreeRTOS.h"
 #include "task.h"
+#include "semphr.h"
+#include "event_groups.h"
 
 #define DO_TRAJECTORY_MSEC	100/portTICK_RATE_MS
+#define DO_TRAJECTORY_PATH_MSEC	20/portTICK_RATE_MS
+
+/* number of points after the xy target used to plan its end speed */
+#define TRAJ_MAX_LOOKAHEAD	4
+
+/* path following: the pursued point is at least at the distance covered
+ * in this number of periods of the distance speed */
+#define TRAJ_PATH_LOOKAHEAD_PERIODS	8
+
+/* events of the current command, see trajectory_update_events() */
+#define TRAJ_EVT_NEAR	0x01	/**<< robot in the near windows */
+#define TRAJ_EVT_DONE	0x02	/**<< trajectory finished (NEAR is set too) */
+#define TRAJ_EVT_ALL	(TRAJ_EVT_NEAR | TRAJ_EVT_DONE)
 
 enum trajectory_state {
 	READY,
@@ -48,6 +63,9 @@ enum trajectory_state {
 	RUNNING_XY_B_START,
 	RUNNING_XY_B_ANGLE,
 	RUNNING_XY_B_ANGLE_OK,
+
+	/* path following, using events */
+	RUNNING_PATH,
 };
 
 
@@ -59,10 +77,21 @@ struct trajectory {
 		struct rs_polar pol; /**<< target, if it is a d,a vector */
 	} target;
 
-	double d_win; 	   /**<< distance window (for END_NEAR) */
-	double a_win_rad;  /**<< angle window (for END_NEAR) */
-	double a_start_rad;/**<< in xy consigns, start to move in distance
+	float d_win; 	   /**<< distance window (for END_NEAR) */
+	float a_win_rad;   /**<< angle window (for END_NEAR) */
+	float a_start_rad; /**<< in xy consigns, start to move in distance
 			    *    when a_target < a_start */
+	float near_d_win;     /**<< distance window of TRAJ_EVT_NEAR */
+	float near_a_win_rad; /**<< angle window of TRAJ_EVT_NEAR */
+
+	vect2_cart lookahead[TRAJ_MAX_LOOKAHEAD]; /**<< points after the xy target */
+	uint8_t nb_lookahead;                     /**<< number of lookahead points */
+
+	vect2_cart path_start; /**<< first point of the followed path */
+	uint8_t path_idx;      /**<< end of the path segment followed (1: target) */
+	float path_lookahead_mm; /**<< min distance of the pursued point */
+	float path_lat_acc;      /**<< max lateral acceleration (distance
+				  *    quadramp units) */
   
 	uint16_t d_speed;  /**<< distance speed consign */
 	uint16_t a_speed;  /**<< angle speed consign */
@@ -72,7 +101,17 @@ struct trajectory {
 	struct cs *csm_angle;     /**<< associated control system (angle) */
 	struct cs *csm_distance;  /**<< associated control system (distance) */
   
-	xTaskHandle scheduler_task;    /**<< id of current task (NULL if no running task) */
+	xTaskHandle scheduler_task;    /**<< task running the xy events, created once */
+	SemaphoreHandle_t event_mutex; /**<< held while the event runs */
+	volatile uint8_t event_armed;  /**<< an xy event is running */
+
+	uint8_t event_first;           /**<< the event has not set consigns yet */
+	TickType_t event_tick;         /**<< when the event was scheduled */
+	TickType_t last_latency;       /**<< from the last command to its first consigns */
+	TickType_t max_latency;        /**<< max of last_latency */
+
+	EventGroupHandle_t events;     /**<< TRAJ_EVT_xxx of the current command */
+	uint8_t events_sent;           /**<< TRAJ_EVT_xxx already set in events */
 };
 
 /** structure initialization */
@@ -101,15 +140,46 @@ void trajectory_set_speed(struct trajectory *traj, int16_t d_speed, int16_t a_sp
 void trajectory_set_windows(struct trajectory *traj, double d_win, 
 			    double a_win_deg, double a_start_deg);
 
+/** set the windows of TRAJ_EVT_NEAR (distance in mm, angle in radian) */
+void trajectory_set_near_windows(struct trajectory *traj, double d_win,
+				 double a_win_rad);
+
+/** 
+ * set the parameters of the path following: min distance of the pursued
+ * point along the path (mm), and maximum lateral acceleration, in the
+ * unit of the distance quadramp accelerations, limiting the speed in
+ * the curves.
+ */
+void trajectory_set_path_params(struct trajectory *traj, double lookahead_mm,
+				double lat_acc);
+
 /** return true if the position consign is equal to the filtered
  * position consign (after quadramp filter), for angle and
  * distance. */
 uint8_t trajectory_finished(struct trajectory *traj);
 
+/** return true if an xy event is running */
+uint8_t trajectory_event_running(struct trajectory *traj);
+
 /** return true if traj is nearly finished depending on specified
  *  parameters */
 uint8_t trajectory_in_window(struct trajectory *traj, double d_win, double a_win_rad);
 
+/** 
+ * set the TRAJ_EVT_xxx reached by the current command, to be called
+ * by the control system task after each position update. Events are
+ * cleared by each new command.
+ */
+void trajectory_update_events(struct trajectory *traj);
+
+/** return the TRAJ_EVT_xxx reached by the current command */
+EventBits_t trajectory_get_events(struct trajectory *traj);
+
+/** wait until one of the given TRAJ_EVT_xxx is reached, or timeout
+ * (ticks). Return the events reached. */
+EventBits_t trajectory_wait_events(struct trajectory *traj,
+				   EventBits_t events, TickType_t timeout);
+
 /** Get total distance travelled by the robot */
 double traj_get_distance(struct trajectory *traj);
 
@@ -151,6 +221,30 @@ void trajectory_d_a_rel(struct trajectory *traj, double d_mm, double a_deg);
 
 /* commands using events */
 
+/** 
+ * give the points the robot goes to after the current xy target (mm,
+ * absolute), so that the target is passed without stopping: the
+ * distance ramp then ends at a junction speed, chosen from the turn
+ * angles and the distances of the next points. To be called after the
+ * xy command, the next command forgets them. When the target is
+ * reached without a new command, the robot stops at once.
+ */
+void trajectory_set_lookahead(struct trajectory *traj, vect2_cart *points,
+			      uint8_t nb_points);
+
+/** 
+ * follow continuously the path going from start (NULL for the robot
+ * position) to the current forward xy target, then to the given points
+ * (mm, absolute), instead of turning towards each of them. A pure
+ * pursuit sets the distance and angle consigns together, the speed
+ * being limited by the curvature. The robot only stops to turn at the
+ * corners sharper than the a_start window. To be called after the xy command,
+ * the next command stops it. TRAJ_EVT_NEAR is set once the target is
+ * passed.
+ */
+void trajectory_follow_path(struct trajectory *traj, vect2_cart *start,
+			    vect2_cart *points, uint8_t nb_points);
+
 /** goto a x,y point, using a trajectory event */
 void trajectory_goto_xy_abs(struct trajectory *traj, double x_abs_mm, double y_abs_mm);
 
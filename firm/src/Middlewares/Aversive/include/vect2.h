@@ -35,11 +35,12 @@
 #ifndef _VECT2_H_
 #define _VECT2_H_
 
-/** \brief Definition of reals used in vector 2d */
-typedef double Real;
+/** \brief Definition of reals used in vector 2d
+ * (single precision: the only one handled by the FPU) */
+typedef float Real;
 
-#define TO_RAD(x) (((double)x)*(M_PI/180.0))
-#define TO_DEG(x) (((double)x)*(180.0/M_PI))
+#define TO_RAD(x) (((Real)x)*(3.14159265f/180.0f))
+#define TO_DEG(x) (((Real)x)*(180.0f/3.14159265f))
 
 /** \brief Cartesian vector structure
 **/
@@ -0,0 +1,134 @@
+/*
+ *  Copyright I-Grebot (2026)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <inttypes.h>
+#include <fast_math.h>
+
+/* pi/2 split in 3 parts, the first ones having few significant bits so
+ * that k.PIO2_1 and k.PIO2_2 are exact for the small k met here */
+#define PIO2_1   1.5703125f
+#define PIO2_2   4.83751297e-4f
+#define PIO2_3   7.54978995e-8f
+#define TWO_OPI  0.636619772f
+
+#define TAN_PIO8 0.414213562f
+
+/* sine and cosine of r, |r| <= pi/4, from their Taylor series: the first
+ * neglected terms are below 2e-9 and 3e-8 */
+static inline float sin_kernel(float r)
+{
+	float r2 = r * r;
+	return r + r * r2 * (-1.66666667e-1f + r2 * (8.33333333e-3f +
+		r2 * (-1.98412698e-4f + r2 * 2.75573192e-6f)));
+}
+
+static inline float cos_kernel(float r)
+{
+	float r2 = r * r;
+	return 1.0f - 0.5f * r2 + r2 * r2 * (4.16666667e-2f +
+		r2 * (-1.38888889e-3f + r2 * 2.48015873e-5f));
+}
+
+/* arctangent of u, |u| <= tan(pi/8), the first neglected term is below 1e-8 */
+static inline float atan_kernel(float u)
+{
+	float u2 = u * u;
+	return u + u * u2 * (-3.33333333e-1f + u2 * (2.0e-1f +
+		u2 * (-1.42857143e-1f + u2 * (1.11111111e-1f +
+		u2 * (-9.09090909e-2f + u2 * (7.69230769e-2f +
+		u2 * -6.66666667e-2f))))));
+}
+
+void fast_sincosf(float a, float *s, float *c)
+{
+	float q = a * TWO_OPI;
+	int32_t k = (int32_t)(q >= 0 ? q + 0.5f : q - 0.5f);
+	float r = ((a - k * PIO2_1) - k * PIO2_2) - k * PIO2_3;
+	float sr = sin_kernel(r);
+	float cr = cos_kernel(r);
+
+	switch (k & 3) {
+	case 0:
+		*s = sr;
+		*c = cr;
+		break;
+	case 1:
+		*s = cr;
+		*c = -sr;
+		break;
+	case 2:
+		*s = -sr;
+		*c = -cr;
+		break;
+	default:
+		*s = -cr;
+		*c = sr;
+		break;
+	}
+}
+
+float fast_sinf(float a)
+{
+	float s, c;
+	fast_sincosf(a, &s, &c);
+	return s;
+}
+
+float fast_cosf(float a)
+{
+	float s, c;
+	fast_sincosf(a, &s, &c);
+	return c;
+}
+
+float fast_atan2f(float y, float x)
+{
+	/* multiples of pi/4 */
+	static const float offsets[5] = {
+		0, 0.785398163f, 1.57079633f, 2.35619449f, 3.14159265f
+	};
+	float ax = x < 0 ? -x : x;
+	float ay = y < 0 ? -y : y;
+	float t, res;
+	uint8_t n = 0;
+
+	if (ax == 0 && ay == 0)
+		return 0;
+
+	/* t in [0, 1], then reduced to [-tan(pi/8), tan(pi/8)]. The result
+	 * is n.pi/4 +/- atan(t), added at the end for a single rounding. */
+	t = (ay > ax) ? ax / ay : ay / ax;
+	if (t > TAN_PIO8) {
+		t = (t - 1.0f) / (t + 1.0f);
+		n = 1;
+	}
+	res = atan_kernel(t);
+
+	if (ay > ax) {
+		n = 2 - n;
+		res = -res;
+	}
+	if (x < 0) {
+		n = 4 - n;
+		res = -res;
+	}
+	res += offsets[n];
+
+	return (y < 0) ? -res : res;
+}
@@ -2,15 +2,19 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <fast_math.h>
 
 /* Convert a polar vector to a cartesian one */
 void vect2_pol2cart(vect2_pol* vp, vect2_cart* vc)
 {
+   Real s, c;
+
    if(vp == NULL) return;
    if(vc == NULL) return;
    
-   vc->x = (Real)( (vp->r)*cos(vp->theta) );
-   vc->y = (Real)( (vp->r)*sin(vp->theta) );
+   fast_sincosf(vp->theta, &s, &c);
+   vc->x = (vp->r)*c;
+   vc->y = (vp->r)*s;
    
    return;
 }
@@ -21,8 +25,8 @@ void vect2_cart2pol(vect2_cart* vc, vect2_pol* vp)
    if(vc == NULL) return;
    if(vp == NULL) return;
    
-   vp->r = (Real)( sqrt((vc->x)*(vc->x)+(vc->y)*(vc->y)) );
-   vp->theta = (Real)atan2(vc->y,vc->x);
+   vp->r = sqrtf((vc->x)*(vc->x)+(vc->y)*(vc->y));
+   vp->theta = fast_atan2f(vc->y,vc->x);
    
    return;
 }
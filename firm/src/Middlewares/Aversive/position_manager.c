@@ -24,8 +24,30 @@
 #include <aversive.h>
 #include <robot_system.h>
 #include <position_manager.h>
+#include <fast_math.h>
 #include "blueboard.h"
 
+#define DEG_PER_RAD_F 57.2957795f
+
+/* part of a new sample taken by the speeds filter */
+#define POSITION_SPEED_FILTER 0.125f
+
+/** start an update of the pose, readers retry until it is done */
+static inline void position_write_begin(struct robot_position *pos)
+{
+	vLockRobotPosition();
+	pos->seq++;
+	__DMB();
+}
+
+/** end an update of the pose */
+static inline void position_write_end(struct robot_position *pos)
+{
+	__DMB();
+	pos->seq++;
+	vUnlockRobotPosition();
+}
+
 /** initialization of the robot_position pos, everthing is set to 0 */
 void position_init(struct robot_position *pos)
 {
@@ -35,14 +57,20 @@ void position_init(struct robot_position *pos)
 /** Set a new robot position */
 void position_set(struct robot_position *pos, int16_t x, int16_t y, int16_t a)
 {
-	vLockRobotPosition();
-	pos->pos_d.a = ((double)a * M_PI)/ 180.0;
-	pos->pos_d.x = x;
-	pos->pos_d.y = y;
-	pos->pos_s16.x = x;
-	pos->pos_s16.y = y;
-	pos->pos_s16.a = a;
-	vUnlockRobotPosition();
+	position_write_begin(pos);
+	pos->pose.pos_f.a = (float)a / DEG_PER_RAD_F;
+	pos->pose.pos_f.x = x;
+	pos->pose.pos_f.y = y;
+	memset(&pos->pos_err, 0, sizeof(pos->pos_err));
+	pos->pose.pos_s16.x = x;
+	pos->pose.pos_s16.y = y;
+	pos->pose.pos_s16.a = a;
+	position_write_end(pos);
+}
+
+void position_set_sample_period(struct robot_position *pos, uint32_t period_us)
+{
+	pos->sample_freq = period_us ? 1000000.0f / period_us : 0;
 }
 
 #ifdef CONFIG_MODULE_COMPENSATE_CENTRIFUGAL_FORCE	
@@ -98,6 +126,21 @@ void position_use_mot(struct robot_position *pos)
 }
 #endif
 
+/**
+ * Kahan summation: *sum += inc, the rounding error being kept in *err
+ * and added back on next call. The position is updated with small
+ * increments on each control system period, whose rounding errors on a
+ * float would add up.
+ */
+static inline void position_add(float *sum, float *err, float inc)
+{
+	float y = inc - *err;
+	float t = *sum + y;
+
+	*err = (t - *sum) - y;
+	*sum = t;
+}
+
 /** 
  * Process the absolute position (x,y,a) depending on the delta on
  * virtual encoders since last read, and depending on physical
@@ -105,9 +148,12 @@ void position_use_mot(struct robot_position *pos)
  */
 void position_manage(struct robot_position *pos)
 {
-	double x, y, a, r, arc_angle;
-	double dx, dy;
+	float x, y, a, d, half_arc, chord, s, c;
+	float imp_per_mm, track_mm;
 	s16 x_s16, y_s16, a_s16;
+	struct xya_position err;
+	struct robot_pose pose;
+	uint32_t seq;
 	struct rs_polar encoders;
 	struct rs_polar delta;
 	struct robot_system * rs;
@@ -139,40 +185,47 @@ void position_manage(struct robot_position *pos)
 
 	pos->prev_encoders = encoders;
 
-	/* update double position */
-	a = position_get_a_rad_double(pos);
-	x = position_get_x_double(pos);
-	y = position_get_y_double(pos);
-
-	if (delta.angle == 0) {
-		/* we go straight */
-		dx = cos(a) * ((double) delta.distance / (pos->phys.distance_imp_per_mm)) ;
-		dy = sin(a) * ((double) delta.distance / (pos->phys.distance_imp_per_mm)) ;
-		x += dx;
-		y += dy;
-	}
-	else {
-		/* r the radius of the circle arc */
-		r = (double)delta.distance * pos->phys.track_mm / ((double) delta.angle * 2);
-		arc_angle = 2 * (double) delta.angle / (pos->phys.track_mm * pos->phys.distance_imp_per_mm);
-		
-		dx = r * (-sin(a) + sin(a+arc_angle));
-		dy = r * (cos(a) - cos(a+arc_angle));
-
-		x += dx;
-		y += dy;
-		a += arc_angle;
-
-		if (a < -M_PI)
-			a += (M_PI*2);
-		else if (a > (M_PI))
-			a -= (M_PI*2);
+	/* update float position. position_set() may be called meanwhile,
+	 * seq tells if it did. */
+	seq = pos->seq;
+	position_get_pose(pos, &pose);
+	a = pose.pos_f.a;
+	x = pose.pos_f.x;
+	y = pose.pos_f.y;
+	err = pos->pos_err;
+
+	imp_per_mm = (float)pos->phys.distance_imp_per_mm;
+	track_mm = (float)pos->phys.track_mm;
+
+	/* d the length of the circle arc, half_arc half of its angle
+	 * (0 when we go straight) */
+	d = (float)delta.distance / imp_per_mm;
+	half_arc = (float)delta.angle / (track_mm * imp_per_mm);
+
+	/* we move along the chord of the arc, of length 2.r.sin(half_arc),
+	 * with r = d / (2.half_arc). Same as r.(sin(a+arc) - sin(a)), but
+	 * without cancellation for small arcs. */
+	chord = d;
+	if (delta.angle != 0)
+		chord *= fast_sinf(half_arc) / half_arc;
+
+	fast_sincosf(a + half_arc, &s, &c);
+	position_add(&x, &err.x, chord * c);
+	position_add(&y, &err.y, chord * s);
+
+	if (delta.angle != 0) {
+		position_add(&a, &err.a, 2 * half_arc);
+
+		if (a < -M_PI_F)
+			a += M_2PI_F;
+		else if (a > M_PI_F)
+			a -= M_2PI_F;
 
 #ifdef CONFIG_MODULE_COMPENSATE_CENTRIFUGAL_FORCE	
 		/* This part compensate the centrifugal force when we
 		 * turn very quickly. Idea is from Gargamel (RCVA). */
-		if (pos->centrifugal_coef && r != 0) {
-			double k;
+		if (pos->centrifugal_coef && delta.distance != 0) {
+			float k, r;
 
 			/* 
 			 * centrifugal force is F = (m.v^2 / R)
@@ -180,16 +233,18 @@ void position_manage(struct robot_position *pos)
 			 *      R: radius of the circle
 			 */
 			
-			k = ((double) delta.distance);
+			r = d / (2 * half_arc);
+			k = ((float) delta.distance);
 			k = k * k;
 			k /= r;
-			k *= pos->centrifugal_coef;
+			k *= (float)pos->centrifugal_coef;
 
 			/* 
 			 * F acts perpendicularly to the vector
 			 */
-			x += k * sin(a);
-			y -= k * cos(a);
+			fast_sincosf(a, &s, &c);
+			x += k * s;
+			y -= k * c;
 		}
 #endif
 	}
@@ -197,29 +252,52 @@ void position_manage(struct robot_position *pos)
 	/* update int position */
 	x_s16 = (int16_t)x;
 	y_s16 = (int16_t)y;
-	a_s16 = (int16_t)(a * (360.0/(M_PI*2)));
-
-	vLockRobotPosition();
-	pos->pos_d.a = a;
-	pos->pos_d.x = x;
-	pos->pos_d.y = y;
-	pos->pos_s16.x = x_s16;
-	pos->pos_s16.y = y_s16;
-	pos->pos_s16.a = a_s16;
-	vUnlockRobotPosition();
+	a_s16 = (int16_t)(a * DEG_PER_RAD_F);
+
+	/* filtered speeds, from this sample moves */
+	pose.speed_d += (d * pos->sample_freq - pose.speed_d) * POSITION_SPEED_FILTER;
+	pose.speed_a += (2 * half_arc * pos->sample_freq - pose.speed_a) * POSITION_SPEED_FILTER;
+
+	position_write_begin(pos);
+	/* a position set since our read takes precedence */
+	if ((seq & 1) == 0 && pos->seq == seq + 1) {
+		pos->pose.pos_f.a = a;
+		pos->pose.pos_f.x = x;
+		pos->pose.pos_f.y = y;
+		pos->pose.pos_s16.x = x_s16;
+		pos->pose.pos_s16.y = y_s16;
+		pos->pose.pos_s16.a = a_s16;
+		pos->pos_err = err;
+	}
+	pos->pose.speed_d = pose.speed_d;
+	pos->pose.speed_a = pose.speed_a;
+	position_write_end(pos);
 }
 
 
+/**
+ * copy the current pose, without lock (retries while the pose is updated)
+ */
+void position_get_pose(struct robot_position *pos, struct robot_pose *pose)
+{
+	uint32_t seq;
+
+	do {
+		seq = pos->seq;
+		__DMB();
+		*pose = pos->pose;
+		__DMB();
+	} while ((seq & 1) || seq != pos->seq);
+}
+
 /**
  * returns current x
  */
 int16_t position_get_x_s16(struct robot_position *pos)
 {
-	int16_t x;
-	vLockRobotPosition();
-	x = pos->pos_s16.x;
-	vUnlockRobotPosition();
-	return x;
+	struct robot_pose pose;
+	position_get_pose(pos, &pose);
+	return pose.pos_s16.x;
 }
 
 /**
@@ -227,11 +305,9 @@ int16_t position_get_x_s16(struct robot_position *pos)
  */
 int16_t position_get_y_s16(struct robot_position *pos)
 {
-	int16_t y;
-	vLockRobotPosition();
-	y = pos->pos_s16.y;
-	vUnlockRobotPosition();
-	return y;
+	struct robot_pose pose;
+	position_get_pose(pos, &pose);
+	return pose.pos_s16.y;
 }
 
 /**
@@ -239,11 +315,41 @@ int16_t position_get_y_s16(struct robot_position *pos)
  */
 int16_t position_get_a_deg_s16(struct robot_position *pos)
 {
-	int16_t a;
-	vLockRobotPosition();
-	a = pos->pos_s16.a;
-	vUnlockRobotPosition();
-	return a;
+	struct robot_pose pose;
+	position_get_pose(pos, &pose);
+	return pose.pos_s16.a;
+}
+
+/********* float */
+
+/**
+ * returns current x
+ */
+float position_get_x_float(struct robot_position *pos)
+{
+	struct robot_pose pose;
+	position_get_pose(pos, &pose);
+	return pose.pos_f.x;
+}
+
+/**
+ * returns current y
+ */
+float position_get_y_float(struct robot_position *pos)
+{
+	struct robot_pose pose;
+	position_get_pose(pos, &pose);
+	return pose.pos_f.y;
+}
+
+/**
+ * returns current alpha
+ */
+float position_get_a_rad_float(struct robot_position *pos)
+{
+	struct robot_pose pose;
+	position_get_pose(pos, &pose);
+	return pose.pos_f.a;
 }
 
 /********* double */
@@ -253,11 +359,7 @@ int16_t position_get_a_deg_s16(struct robot_position *pos)
  */
 double position_get_x_double(struct robot_position *pos)
 {
-	double x;
-	vLockRobotPosition();
-	x = pos->pos_d.x;
-	vUnlockRobotPosition();
-	return x;
+	return position_get_x_float(pos);
 }
 
 /**
@@ -265,11 +367,7 @@ double position_get_x_double(struct robot_position *pos)
  */
 double position_get_y_double(struct robot_position *pos)
 {
-	double y;
-	vLockRobotPosition();
-	y = pos->pos_d.y;
-	vUnlockRobotPosition();
-	return y;
+	return position_get_y_float(pos);
 }
 
 /**
@@ -277,10 +375,5 @@ double position_get_y_double(struct robot_position *pos)
  */
 double position_get_a_rad_double(struct robot_position *pos)
 {
-	double a;
-	vLockRobotPosition();
-	a = pos->pos_d.a;
-	vUnlockRobotPosition();
-	return a;
+	return position_get_a_rad_float(pos);
 }
-
@@ -203,30 +203,23 @@ void rs_set_distance(void * data, int32_t distance)
 
 /** 
  * get the virtual angle according to real encoders value. 
+ * No lock: the 32 bits counter is read at once, and only written by
+ * rs_update().
  */
 int32_t rs_get_angle(void * data)
 {
 	struct robot_system * rs = data;
-	int32_t angle;
-	
-	vLockEncoderAngle();
-	angle = rs->virtual_encoders.angle ;	
-	vUnlockEncoderAngle();
-	return angle;
+	return rs->virtual_encoders.angle;
 }
 
 /** 
  * get the virtual distance according to real encoders value. 
+ * No lock, see rs_get_angle().
  */
 int32_t rs_get_distance(void * data)
 {
 	struct robot_system * rs = data;
-	int32_t distance;
-	
-	vLockEncoderDistance();
-	distance = rs->virtual_encoders.distance ;	
-	vUnlockEncoderDistance();
-	return distance;
+	return rs->virtual_encoders.distance;
 }
 
 int32_t rs_get_ext_angle(void * data)
@@ -389,12 +382,8 @@ void rs_update(void * data)
 	delta_distance = pext.distance - rs->pext_prev.distance;
 #endif
 
-	vLockEncoderAngle();
-	vLockEncoderDistance();
 	rs->virtual_encoders.angle += delta_angle;
 	rs->virtual_encoders.distance += delta_distance;
-	vUnlockEncoderAngle();
-	vUnlockEncoderDistance();
 
 	/* don't lock too much time */
 	rs->pext_prev = pext;
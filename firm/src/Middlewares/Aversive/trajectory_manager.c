@@ -29,6 +29,7 @@
 //#include <aversive/error.h>
 //#include <scheduler.h>
 #include <vect2.h>
+#include <fast_math.h>
 
 #include <position_manager.h>
 #include <robot_system.h>
@@ -39,21 +40,23 @@
 
 #include "../../Projects/2018_T1_R1/include/main.h" // FIXME
 
-#define M_2PI (2*M_PI)
-
 #define DEG(x) ((x) * (180.0 / M_PI))
 #define RAD(x) ((x) * (M_PI / 180.0))
 
-static void trajectory_manager_event(void *param);
+static void trajectory_manager_event(struct trajectory *traj);
+static void trajectory_path_event(struct trajectory *traj);
+static void trajectory_manager_task(void *param);
 
 /************ INIT FUNCS */
 
-/** structure initialization */
+/** structure initialization, also starts the task running the xy events */
 void trajectory_init(struct trajectory *traj)
 {
 	memset(traj, 0, sizeof(struct trajectory));
 	traj->state = READY;
-	traj->scheduler_task = NULL;
+	traj->event_mutex = xSemaphoreCreateMutex();
+	traj->events = xEventGroupCreate();
+	xTaskCreate(trajectory_manager_task, "TRAJECTORY", OS_TASK_STACK_AVS_TRAJ, traj, OS_TASK_PRIORITY_AVS_TRAJ, &traj->scheduler_task);
 }
 
 /** structure initialization */
@@ -90,6 +93,22 @@ void trajectory_set_windows(struct trajectory *traj, double d_win,
 
 }
 
+/** set parameters of the path following */
+void trajectory_set_path_params(struct trajectory *traj, double lookahead_mm,
+				double lat_acc)
+{
+	traj->path_lookahead_mm = lookahead_mm;
+	traj->path_lat_acc = lat_acc;
+}
+
+/** set windows of the near event */
+void trajectory_set_near_windows(struct trajectory *traj, double d_win,
+				 double a_win_rad)
+{
+	traj->near_d_win = d_win;
+	traj->near_a_win_rad = a_win_rad;
+}
+
 /************ STATIC [ AND USEFUL ] FUNCS */
 
 /** set speed consign in quadramp filter */
@@ -118,44 +137,61 @@ static uint32_t get_quadramp_distance_speed(struct trajectory *traj)
 	return q_d->var_1st_ord_pos;
 }
 
-/** remove event if any */
+/** remove event if any. Once returned, the event is not running and
+ * won't touch the consigns anymore. The lookahead of the previous
+ * command is forgotten. */
 static void delete_event(struct trajectory *traj)
 {
+	xSemaphoreTake(traj->event_mutex, portMAX_DELAY);
+	traj->event_armed = 0;
 	set_quadramp_speed(traj, traj->d_speed, traj->a_speed);
-	if ( traj->scheduler_task != NULL) {
-		vTaskDelete(traj->scheduler_task);
-		traj->scheduler_task=NULL;
-	}
+	traj->nb_lookahead = 0;
+	quadramp_set_end_var(traj->csm_distance->consign_filter_params, 0);
+	xSemaphoreGive(traj->event_mutex);
+}
+
+/** clear the events of the previous command, once the new one is
+ * fully set. The control system task may have evaluated them on a
+ * partly updated command meanwhile. */
+static void clear_events(struct trajectory *traj)
+{
+	xEventGroupClearBits(traj->events, TRAJ_EVT_ALL);
+	traj->events_sent = 0;
 }
 
-/** schedule the trajectory event */
+/** schedule the trajectory event: the trajectory task is woken up to
+ * process it at once, then every DO_TRAJECTORY_MSEC */
 // TODO: remove all direct FreeRTOS references from Aversive
 static void schedule_event(struct trajectory *traj)
 {
-	if ( traj->scheduler_task != NULL) {
+	if (traj->event_armed) {
 	  DEBUG_WARNING("Schedule event, already scheduled");
 	}
 	else {
-			xTaskCreate(trajectory_manager_event, "TRAJECTORY", OS_TASK_STACK_AVS_TRAJ, traj, OS_TASK_PRIORITY_AVS_TRAJ, &traj->scheduler_task );
+		traj->event_tick = xTaskGetTickCount();
+		traj->event_first = 1;
+		traj->event_armed = 1;
+		xTaskNotifyGive(traj->scheduler_task);
 	}
+	clear_events(traj);
 }
 
 /** do a modulo 2.pi -> [-Pi,+Pi], knowing that 'a' is in [-3Pi,+3Pi] */  
-static double simple_modulo_2pi(double a)
+static float simple_modulo_2pi(float a)
 {
-	if (a < -M_PI) {
-		a += M_2PI;
+	if (a < -M_PI_F) {
+		a += M_2PI_F;
 	}
-	else if (a > M_PI) {
-		a -= M_2PI;
+	else if (a > M_PI_F) {
+		a -= M_2PI_F;
 	}
 	return a;
 }
 
 /** do a modulo 2.pi -> [-Pi,+Pi] */  
-static double modulo_2pi(double a)
+static float modulo_2pi(float a)
 {
-        double res = a - (((int32_t) (a/M_2PI)) * M_2PI);
+        float res = a - (((int32_t) (a/M_2PI_F)) * M_2PI_F);
 	return simple_modulo_2pi(res);
 }
 
@@ -170,36 +206,36 @@ double traj_get_distance(struct trajectory *traj)
 
 
 /** near the target (dist) ? */
-static uint8_t is_robot_in_dist_window(struct trajectory *traj, double d_win)
+static uint8_t is_robot_in_dist_window(struct trajectory *traj, float d_win)
 {
-	double d = traj->target.pol.distance - rs_get_distance(traj->robot);
+	float d = traj->target.pol.distance - rs_get_distance(traj->robot);
 	d = ABS(d);
-	d = d / traj->position->phys.distance_imp_per_mm;
+	d = d / (float)traj->position->phys.distance_imp_per_mm;
 	return (d < d_win);
 }
 
 /** near the target (dist in x,y) ? */
-static uint8_t is_robot_in_xy_window(struct trajectory *traj, double d_win)
+static uint8_t is_robot_in_xy_window(struct trajectory *traj, float d_win)
 {
-	double x1 = traj->target.cart.x;
-	double y1 = traj->target.cart.y;
-	double x2 = position_get_x_double(traj->position);
-	double y2 = position_get_y_double(traj->position);
-	return ( sqrt ((x2-x1) * (x2-x1) + (y2-y1) * (y2-y1)) < d_win );
+	float x1 = traj->target.cart.x;
+	float y1 = traj->target.cart.y;
+	float x2 = position_get_x_float(traj->position);
+	float y2 = position_get_y_float(traj->position);
+	return ( (x2-x1) * (x2-x1) + (y2-y1) * (y2-y1) < d_win * d_win );
 }
 
 /** near the angle target in radian ? Only valid if
  *  traj->target.pol.angle is set (i.e. an angle command, not an xy
  *  command) */
-static uint8_t is_robot_in_angle_window(struct trajectory *traj, double a_win_rad)
+static uint8_t is_robot_in_angle_window(struct trajectory *traj, float a_win_rad)
 {
-	double a;
+	float a;
 	
 	/* convert relative angle from imp to rad */
 	a = traj->target.pol.angle - rs_get_angle(traj->robot);
-	a /= traj->position->phys.distance_imp_per_mm;
-	a /= traj->position->phys.track_mm;
-	a *= 2.;
+	a /= (float)traj->position->phys.distance_imp_per_mm;
+	a /= (float)traj->position->phys.track_mm;
+	a *= 2.f;
 	return ABS(a) < a_win_rad;
 }
 
@@ -254,6 +290,7 @@ void __trajectory_goto_d_a_rel(struct trajectory *traj, double d_mm,
 		cs_set_consign(traj->csm_distance, d_consign);
 		vUnlockDistanceConsign();
 	}
+	clear_events(traj);
 }
 
 /** go straight forward (d is in mm) */
@@ -279,8 +316,8 @@ void trajectory_a_rel(struct trajectory *traj, double a_deg_rel)
 /** turn by 'a' degrees */
 void trajectory_a_abs(struct trajectory *traj, double a_deg_abs)
 {
-	double posa = position_get_a_rad_double(traj->position);
-	double a;
+	float posa = position_get_a_rad_float(traj->position);
+	float a;
 
 	a = RAD(a_deg_abs) - posa;
 	a = modulo_2pi(a);
@@ -291,13 +328,13 @@ void trajectory_a_abs(struct trajectory *traj, double a_deg_abs)
 /** turn the robot until the point x,y is in front of us */ 
 void trajectory_turnto_xy(struct trajectory *traj, double x_abs_mm, double y_abs_mm)
 {
-	double posx = position_get_x_double(traj->position); 
-	double posy = position_get_y_double(traj->position);
-	double posa = position_get_a_rad_double(traj->position);
+	float posx = position_get_x_float(traj->position); 
+	float posy = position_get_y_float(traj->position);
+	float posa = position_get_a_rad_float(traj->position);
 
 	DEBUG_TRACE("Goto Turn To xy %f %f", x_abs_mm, y_abs_mm);
 	__trajectory_goto_d_a_rel(traj, 0,
-			simple_modulo_2pi(atan2(y_abs_mm - posy, x_abs_mm - posx) - posa),
+			simple_modulo_2pi(fast_atan2f(y_abs_mm - posy, x_abs_mm - posx) - posa),
 				  RUNNING_A,
 				  UPDATE_A | UPDATE_D | RESET_D);
 }
@@ -305,13 +342,13 @@ void trajectory_turnto_xy(struct trajectory *traj, double x_abs_mm, double y_abs
 /** turn the robot until the point x,y is behind us */ 
 void trajectory_turnto_xy_behind(struct trajectory *traj, double x_abs_mm, double y_abs_mm)
 {
-	double posx = position_get_x_double(traj->position); 
-	double posy = position_get_y_double(traj->position);
-	double posa = position_get_a_rad_double(traj->position);
+	float posx = position_get_x_float(traj->position); 
+	float posy = position_get_y_float(traj->position);
+	float posa = position_get_a_rad_float(traj->position);
 
 	DEBUG_TRACE("Goto Turn To xy %f %f", x_abs_mm, y_abs_mm);
 	__trajectory_goto_d_a_rel(traj, 0, 
-			modulo_2pi(atan2(y_abs_mm - posy, x_abs_mm - posx) - posa + M_PI),
+			modulo_2pi(fast_atan2f(y_abs_mm - posy, x_abs_mm - posx) - posa + M_PI_F),
 				  RUNNING_A,
 				  UPDATE_A | UPDATE_D | RESET_D);
 }
@@ -326,8 +363,8 @@ void trajectory_only_a_rel(struct trajectory *traj, double a_deg)
 /** update angle consign without changing distance consign */
 void trajectory_only_a_abs(struct trajectory *traj, double a_deg_abs)
 {
-	double posa = position_get_a_rad_double(traj->position);
-	double a;
+	float posa = position_get_a_rad_float(traj->position);
+	float a;
 
 	a = RAD(a_deg_abs) - posa;
 	a = modulo_2pi(a);
@@ -360,9 +397,13 @@ void trajectory_hardstop(struct trajectory *traj)
 				  UPDATE_A | UPDATE_D | RESET_D | RESET_A);
 
 	q_d->previous_var = 0;
+	q_d->previous_acc = 0;
 	q_d->previous_out = rs_get_distance(traj->robot);
+	q_d->previous_frac = 0;
 	q_a->previous_var = 0;
+	q_a->previous_acc = 0;
 	q_a->previous_out = rs_get_angle(traj->robot);
+	q_a->previous_frac = 0;
 }
 
 
@@ -402,12 +443,12 @@ void trajectory_goto_backward_xy_abs(struct trajectory *traj, double x, double y
 void trajectory_goto_d_a_rel(struct trajectory *traj, double d, double a)
 {
 	vect2_pol p;
-	double x = position_get_x_double(traj->position); 
-	double y = position_get_y_double(traj->position);
+	float x = position_get_x_float(traj->position); 
+	float y = position_get_y_float(traj->position);
 	
 	delete_event(traj);
 	p.r = d;
-	p.theta = RAD(a) + position_get_a_rad_double(traj->position);
+	p.theta = RAD(a) + position_get_a_rad_float(traj->position);
 	vect2_pol2cart(&p, &traj->target.cart);
 	traj->target.cart.x += x;
 	traj->target.cart.y += y;
@@ -421,15 +462,15 @@ void trajectory_goto_xy_rel(struct trajectory *traj, double x_rel_mm, double y_r
 {
 	vect2_cart c;
 	vect2_pol p;
-	double x = position_get_x_double(traj->position); 
-	double y = position_get_y_double(traj->position);
+	float x = position_get_x_float(traj->position); 
+	float y = position_get_y_float(traj->position);
 
 	delete_event(traj);
 	c.x = x_rel_mm;
 	c.y = y_rel_mm;
 
 	vect2_cart2pol(&c, &p);
-	p.theta += position_get_a_rad_double(traj->position);;
+	p.theta += position_get_a_rad_float(traj->position);
 	vect2_pol2cart(&p, &traj->target.cart);
 
 	traj->target.cart.x += x;
@@ -439,6 +480,190 @@ void trajectory_goto_xy_rel(struct trajectory *traj, double x_rel_mm, double y_r
 	schedule_event(traj);
 }
 
+/************ LOOKAHEAD */
+
+/** distance speed kept by the xy event when the robot has to turn by
+ * a to go from p to the next point (see a_start_rad) */
+static float junction_speed(struct trajectory *traj, vect2_cart *from,
+			    vect2_cart *p, vect2_cart *to)
+{
+	float ux = p->x - from->x;
+	float uy = p->y - from->y;
+	float vx = to->x - p->x;
+	float vy = to->y - p->y;
+	float a;
+
+	a = fast_atan2f(ux * vy - uy * vx, ux * vx + uy * vy);
+	a = ABS(a);
+	if (a >= traj->a_start_rad)
+		return 0;
+
+	return traj->d_speed * (traj->a_start_rad - a) / traj->a_start_rad;
+}
+
+/** speed at which the xy target can be passed. Going backwards from
+ * the last lookahead point, where the robot stops, the speed at a
+ * point is the lowest of its junction speed and of the speed from
+ * which the distance ramp can brake to the one of the next point. */
+static float lookahead_end_speed(struct trajectory *traj)
+{
+	struct quadramp_filter *q_d = traj->csm_distance->consign_filter_params;
+	float imp_per_mm = (float)traj->position->phys.distance_imp_per_mm;
+	float acc, speed = 0, junction, d;
+	vect2_cart pos, *from, *p, *to;
+	int8_t i;
+
+	acc = q_d->var_2nd_ord_pos;
+	if (q_d->var_2nd_ord_neg < acc)
+		acc = q_d->var_2nd_ord_neg;
+
+	pos.x = position_get_x_float(traj->position);
+	pos.y = position_get_y_float(traj->position);
+
+	for (i = traj->nb_lookahead - 1; i >= 0; i--) {
+		to = &traj->lookahead[i];
+		p = (i > 0) ? &traj->lookahead[i-1] : &traj->target.cart;
+		if (i > 1)
+			from = &traj->lookahead[i-2];
+		else if (i == 1)
+			from = &traj->target.cart;
+		else
+			from = &pos;
+
+		d = sqrtf((to->x - p->x) * (to->x - p->x) +
+			  (to->y - p->y) * (to->y - p->y)) * imp_per_mm;
+		speed = quadramp_braking_var(d, speed, acc, q_d->var_3rd_ord);
+		junction = junction_speed(traj, from, p, to);
+		if (junction < speed)
+			speed = junction;
+	}
+
+	if (speed > traj->d_speed)
+		speed = traj->d_speed;
+
+	return speed;
+}
+
+/** set the points after the xy target, and the end speed of the
+ * distance ramp */
+void trajectory_set_lookahead(struct trajectory *traj, vect2_cart *points,
+			      uint8_t nb_points)
+{
+	if (traj->state < RUNNING_XY_START || traj->state > RUNNING_XY_B_ANGLE_OK)
+		return;
+
+	if (nb_points > TRAJ_MAX_LOOKAHEAD)
+		nb_points = TRAJ_MAX_LOOKAHEAD;
+
+	xSemaphoreTake(traj->event_mutex, portMAX_DELAY);
+	traj->nb_lookahead = nb_points;
+	memcpy(traj->lookahead, points, nb_points * sizeof(vect2_cart));
+	quadramp_set_end_var(traj->csm_distance->consign_filter_params,
+			     (uint32_t)lookahead_end_speed(traj));
+	xSemaphoreGive(traj->event_mutex);
+}
+
+/************ PATH FOLLOWING, USE EVENTS */
+
+/** point i of the followed path: start, xy target, then lookahead */
+static vect2_cart *path_point(struct trajectory *traj, uint8_t i)
+{
+	if (i == 0)
+		return &traj->path_start;
+	if (i == 1)
+		return &traj->target.cart;
+	return &traj->lookahead[i - 2];
+}
+
+static float distance_mm(vect2_cart *p1, vect2_cart *p2)
+{
+	return sqrtf((p2->x - p1->x) * (p2->x - p1->x) +
+		     (p2->y - p1->y) * (p2->y - p1->y));
+}
+
+/** max distance speed on a curve (1/mm), for the lateral acceleration */
+static float curvature_speed(struct trajectory *traj, float curv)
+{
+	float imp_per_mm = (float)traj->position->phys.distance_imp_per_mm;
+	float speed;
+
+	curv = ABS(curv);
+	if (curv == 0 || traj->path_lat_acc == 0)
+		return traj->d_speed;
+
+	/* v^2.curv = lat_acc, curv per impulse */
+	speed = sqrtf(traj->path_lat_acc * imp_per_mm / curv);
+
+	return (speed < traj->d_speed) ? speed : traj->d_speed;
+}
+
+/** distance from the robot to the pursued point (mm), for a distance
+ * speed (imp per period) */
+static float path_lookahead(struct trajectory *traj, float speed)
+{
+	float imp_per_mm = (float)traj->position->phys.distance_imp_per_mm;
+	float look_mm = speed * TRAJ_PATH_LOOKAHEAD_PERIODS / imp_per_mm;
+
+	return (look_mm > traj->path_lookahead_mm) ? look_mm : traj->path_lookahead_mm;
+}
+
+/** max distance speed at a corner of the path. The robot turns by the
+ * corner angle while the pursued point goes round the corner, the
+ * curvature is 2.sin(turn/2)/lookahead at worst. */
+static float corner_speed(struct trajectory *traj, float turn)
+{
+	float s = fast_sinf(turn / 2);
+	float speed = curvature_speed(traj, 2 * s / traj->path_lookahead_mm);
+	float far_speed;
+
+	if (s == 0)
+		return traj->d_speed;
+
+	/* faster with the lookahead proportional to the speed:
+	 * v^2.2s/(v.periods) = lat_acc (per impulse) */
+	far_speed = traj->path_lat_acc * TRAJ_PATH_LOOKAHEAD_PERIODS / (2 * s);
+	if (far_speed > speed)
+		speed = far_speed;
+
+	return (speed < traj->d_speed) ? speed : traj->d_speed;
+}
+
+/** follow the path from start, through the xy target, then points */
+void trajectory_follow_path(struct trajectory *traj, vect2_cart *start,
+			    vect2_cart *points, uint8_t nb_points)
+{
+	/* forward (or auto) xy trajectory, or path already followed */
+	if ((traj->state < RUNNING_XY_START || traj->state > RUNNING_XY_F_ANGLE_OK) &&
+	    traj->state != RUNNING_PATH)
+		return;
+
+	if (nb_points > TRAJ_MAX_LOOKAHEAD)
+		nb_points = TRAJ_MAX_LOOKAHEAD;
+
+	xSemaphoreTake(traj->event_mutex, portMAX_DELAY);
+	traj->nb_lookahead = nb_points;
+	memcpy(traj->lookahead, points, nb_points * sizeof(vect2_cart));
+	if (start)
+		traj->path_start = *start;
+	else {
+		traj->path_start.x = position_get_x_float(traj->position);
+		traj->path_start.y = position_get_y_float(traj->position);
+	}
+	traj->path_idx = 1;
+	traj->state = RUNNING_PATH;
+
+	/* the xy event may have been deleted in the target window */
+	if (!traj->event_armed) {
+		traj->event_tick = xTaskGetTickCount();
+		traj->event_first = 1;
+		traj->event_armed = 1;
+	}
+	xSemaphoreGive(traj->event_mutex);
+
+	clear_events(traj);
+	xTaskNotifyGive(traj->scheduler_task);
+}
+
 /************ FUNCS FOR GETTING TRAJ STATE */
 
 /** return true if the position consign is equal to the filtered
@@ -464,6 +689,10 @@ uint8_t trajectory_in_window(struct trajectory *traj, double d_win, double a_win
 	case RUNNING_A: 
 		return is_robot_in_angle_window(traj, a_win_rad);
 
+	case RUNNING_PATH:
+		/* the xy target is passed */
+		return traj->path_idx > 1;
+
 	case RUNNING_D:
 		return is_robot_in_dist_window(traj, d_win);
 
@@ -482,14 +711,69 @@ uint8_t trajectory_in_window(struct trajectory *traj, double d_win, double a_win
 	}
 }
 
+/** set the events reached since the last command. Called at each
+ * sample of the control system, so it only does the window checks
+ * until the trajectory is finished. */
+void trajectory_update_events(struct trajectory *traj)
+{
+	EventBits_t events = 0;
+
+	if (traj->events_sent & TRAJ_EVT_DONE)
+		return;
+
+	if (!traj->event_armed && trajectory_finished(traj))
+		events = TRAJ_EVT_DONE | TRAJ_EVT_NEAR;
+	else if (!(traj->events_sent & TRAJ_EVT_NEAR) &&
+		 trajectory_in_window(traj, traj->near_d_win, traj->near_a_win_rad))
+		events = TRAJ_EVT_NEAR;
+
+	if (events) {
+		traj->events_sent |= events;
+		xEventGroupSetBits(traj->events, events);
+	}
+}
+
+/** return the events reached by the current command */
+EventBits_t trajectory_get_events(struct trajectory *traj)
+{
+	return xEventGroupGetBits(traj->events);
+}
+
+/** wait for one of the events of the current command */
+EventBits_t trajectory_wait_events(struct trajectory *traj,
+				   EventBits_t events, TickType_t timeout)
+{
+	return xEventGroupWaitBits(traj->events, events, pdFALSE, pdFALSE, timeout);
+}
+
 /*********** *TRAJECTORY EVENT FUNC */
 
-/** event called for xy trajectories */
-static void trajectory_manager_event(void * param)
+/** send the consigns processed by an event */
+static void set_event_consigns(struct trajectory *traj, int32_t d_consign,
+			       int32_t a_consign)
 {
-	struct trajectory *traj = (struct trajectory *)param;
-	double coef=1.0;
-	double x,y,a;
+	vLockAngleConsign();
+	cs_set_consign(traj->csm_angle, a_consign);
+	vUnlockAngleConsign();
+	vLockDistanceConsign();
+	cs_set_consign(traj->csm_distance, d_consign);
+	vUnlockDistanceConsign();
+
+	/* latency from the command to its first consigns */
+	if (traj->event_first) {
+		traj->event_first = 0;
+		traj->last_latency = xTaskGetTickCount() - traj->event_tick;
+		if (traj->last_latency > traj->max_latency)
+			traj->max_latency = traj->last_latency;
+	}
+}
+
+/** event called for xy trajectories, with the event mutex held */
+static void trajectory_manager_event(struct trajectory *traj)
+{
+	float coef=1.0f;
+	float x,y,a;
+	float imp_per_mm, track_mm;
 	int32_t d_consign=0, a_consign=0;
 
 	/* These vectors contain target position of the robot in
@@ -497,138 +781,300 @@ static void trajectory_manager_event(void * param)
 	vect2_cart v2cart_pos;
 	vect2_pol v2pol_target;
 
-	TickType_t xNextWakeTime;
+	x = position_get_x_float(traj->position);
+	y = position_get_y_float(traj->position);
+	a = position_get_a_rad_float(traj->position);
 
-	/* Initialise xNextWakeTime - this only needs to be done once. */
-    xNextWakeTime = xTaskGetTickCount();
+	imp_per_mm = (float)traj->position->phys.distance_imp_per_mm;
+	track_mm = (float)traj->position->phys.track_mm;
 
-	for(;;)
-	{
-        vTaskDelayUntil( &xNextWakeTime, DO_TRAJECTORY_MSEC);
-
-		x = position_get_x_double(traj->position);
-		y = position_get_y_double(traj->position);
-		a = position_get_a_rad_double(traj->position);
-
-		/* step 1 : process new commands to quadramps */
-
-		switch (traj->state) {
-		case RUNNING_XY_START:
-		case RUNNING_XY_ANGLE:
-		case RUNNING_XY_ANGLE_OK:
-		case RUNNING_XY_F_START:
-		case RUNNING_XY_F_ANGLE:
-		case RUNNING_XY_F_ANGLE_OK:
-		case RUNNING_XY_B_START:
-		case RUNNING_XY_B_ANGLE:
-		case RUNNING_XY_B_ANGLE_OK:
-
-			/* process the command vector from absolute target and
-			 * current position */
-			v2cart_pos.x = traj->target.cart.x - x;
-			v2cart_pos.y = traj->target.cart.y - y;
-			vect2_cart2pol(&v2cart_pos, &v2pol_target);
-			v2pol_target.theta = simple_modulo_2pi(v2pol_target.theta - a);
-
-			/* asked to go backwards */
-			if (traj->state >= RUNNING_XY_B_START &&
-				traj->state <= RUNNING_XY_B_ANGLE_OK ) {
+	if (traj->state == RUNNING_PATH) {
+		trajectory_path_event(traj);
+		return;
+	}
+
+	/* step 1 : process new commands to quadramps */
+
+	switch (traj->state) {
+	case RUNNING_XY_START:
+	case RUNNING_XY_ANGLE:
+	case RUNNING_XY_ANGLE_OK:
+	case RUNNING_XY_F_START:
+	case RUNNING_XY_F_ANGLE:
+	case RUNNING_XY_F_ANGLE_OK:
+	case RUNNING_XY_B_START:
+	case RUNNING_XY_B_ANGLE:
+	case RUNNING_XY_B_ANGLE_OK:
+
+		/* process the command vector from absolute target and
+		 * current position */
+		v2cart_pos.x = traj->target.cart.x - x;
+		v2cart_pos.y = traj->target.cart.y - y;
+		vect2_cart2pol(&v2cart_pos, &v2pol_target);
+		v2pol_target.theta = simple_modulo_2pi(v2pol_target.theta - a);
+
+		/* asked to go backwards */
+		if (traj->state >= RUNNING_XY_B_START &&
+			traj->state <= RUNNING_XY_B_ANGLE_OK ) {
+			v2pol_target.r = -v2pol_target.r;
+			v2pol_target.theta = simple_modulo_2pi(v2pol_target.theta + M_PI_F);
+		}
+
+		/* if we don't need to go forward */
+		if (traj->state >= RUNNING_XY_START &&
+			traj->state <= RUNNING_XY_ANGLE_OK ) {
+			/* If the target is behind the robot, we need to go
+			 * backwards. 0.52 instead of 0.5 because we prefer to
+			 * go forward */
+			if ((v2pol_target.theta > 0.52f*M_PI_F) ||
+				(v2pol_target.theta < -0.52f*M_PI_F ) ) {
 				v2pol_target.r = -v2pol_target.r;
-				v2pol_target.theta = simple_modulo_2pi(v2pol_target.theta + M_PI);
+				v2pol_target.theta = simple_modulo_2pi(v2pol_target.theta + M_PI_F);
 			}
+		}
 
-			/* if we don't need to go forward */
-			if (traj->state >= RUNNING_XY_START &&
-				traj->state <= RUNNING_XY_ANGLE_OK ) {
-				/* If the target is behind the robot, we need to go
-				 * backwards. 0.52 instead of 0.5 because we prefer to
-				 * go forward */
-				if ((v2pol_target.theta > 0.52*M_PI) ||
-					(v2pol_target.theta < -0.52*M_PI ) ) {
-					v2pol_target.r = -v2pol_target.r;
-					v2pol_target.theta = simple_modulo_2pi(v2pol_target.theta + M_PI);
-				}
-			}
+		/* If the robot is correctly oriented to start moving in distance */
+		/* here limit dist speed depending on v2pol_target.theta */
+		if (ABS(v2pol_target.theta) > traj->a_start_rad) // || ABS(v2pol_target.r) < traj->d_win)
+			set_quadramp_speed(traj, 0, traj->a_speed);
+		else {
+			coef = (traj->a_start_rad - ABS(v2pol_target.theta)) / traj->a_start_rad;
+			set_quadramp_speed(traj, traj->d_speed * coef, traj->a_speed);
+		}
 
-			/* If the robot is correctly oriented to start moving in distance */
-			/* here limit dist speed depending on v2pol_target.theta */
-			if (ABS(v2pol_target.theta) > traj->a_start_rad) // || ABS(v2pol_target.r) < traj->d_win)
-				set_quadramp_speed(traj, 0, traj->a_speed);
-			else {
-				coef = (traj->a_start_rad - ABS(v2pol_target.theta)) / traj->a_start_rad;
-				set_quadramp_speed(traj, traj->d_speed * coef, traj->a_speed);
-			}
+		d_consign = (int32_t)(v2pol_target.r * imp_per_mm);
+		d_consign += rs_get_distance(traj->robot);
 
-			d_consign = (int32_t)(v2pol_target.r * (traj->position->phys.distance_imp_per_mm));
-			d_consign += rs_get_distance(traj->robot);
+		/* angle consign */
+		/* XXX here we specify 2.2 instead of 2.0 to avoid oscillations */
+		a_consign = (int32_t)(v2pol_target.theta *
+					  imp_per_mm * track_mm / 2.2f);
+		a_consign += rs_get_angle(traj->robot);
 
-			/* angle consign */
-			/* XXX here we specify 2.2 instead of 2.0 to avoid oscillations */
-			a_consign = (int32_t)(v2pol_target.theta *
-						  (traj->position->phys.distance_imp_per_mm) *
-						  (traj->position->phys.track_mm) / 2.2);
-			a_consign += rs_get_angle(traj->robot);
+		break;
 
-			break;
+	default:
+		/* hmmm quite odd, delete the event */
+		traj->event_armed = 0;
+		traj->state = READY;
+		return;
+	}
 
-		default:
-			/* hmmm quite odd, delete the event */
-			traj->scheduler_task=NULL;
-			vTaskDelete(traj->scheduler_task);
-			traj->state = READY;
-		}
+	/* step 2 : update state, or delete event if we reached the
+	 * destination */
 
-		/* step 2 : update state, or delete event if we reached the
-		 * destination */
+	/* XXX if target is our pos !! */
 
-		/* XXX if target is our pos !! */
+	switch (traj->state) {
+	case RUNNING_XY_START:
+	case RUNNING_XY_F_START:
+	case RUNNING_XY_B_START:
+		/* START -> ANGLE */
+		traj->state ++;
+		break;
 
-		switch (traj->state) {
-		case RUNNING_XY_START:
-		case RUNNING_XY_F_START:
-		case RUNNING_XY_B_START:
-			/* START -> ANGLE */
+	case RUNNING_XY_ANGLE:
+	case RUNNING_XY_F_ANGLE:
+	case RUNNING_XY_B_ANGLE: {
+		struct quadramp_filter *q_a;
+		q_a = traj->csm_angle->consign_filter_params;
+		/* if d_speed is not 0, we are in start_angle_win */
+		if (get_quadramp_distance_speed(traj)) {
+			if(is_robot_in_xy_window(traj, traj->d_win)) {
+				traj->event_armed = 0;
+				return;
+			}
+			/* ANGLE -> ANGLE_OK */
 			traj->state ++;
-			break;
+		}
+		break;
+	}
 
-		case RUNNING_XY_ANGLE:
-		case RUNNING_XY_F_ANGLE:
-		case RUNNING_XY_B_ANGLE: {
-			struct quadramp_filter *q_a;
-			q_a = traj->csm_angle->consign_filter_params;
-			/* if d_speed is not 0, we are in start_angle_win */
-			if (get_quadramp_distance_speed(traj)) {
-				if(is_robot_in_xy_window(traj, traj->d_win)) {
-					traj->scheduler_task=NULL;
-					vTaskDelete(traj->scheduler_task);
-				}
-				/* ANGLE -> ANGLE_OK */
-				traj->state ++;
-			}
-			break;
+	case RUNNING_XY_ANGLE_OK:
+	case RUNNING_XY_F_ANGLE_OK:
+	case RUNNING_XY_B_ANGLE_OK:
+		/* If we reached the destination */
+		if(is_robot_in_xy_window(traj, traj->d_win)) {
+			traj->event_armed = 0;
+			return;
 		}
+	break;
 
-		case RUNNING_XY_ANGLE_OK:
-		case RUNNING_XY_F_ANGLE_OK:
-		case RUNNING_XY_B_ANGLE_OK:
-			/* If we reached the destination */
-			if(is_robot_in_xy_window(traj, traj->d_win)) {
-				traj->scheduler_task=NULL;
-				vTaskDelete(traj->scheduler_task);
-			}
+	default:
 		break;
+	}
 
-		default:
+	/* step 3 : send the processed commands to cs */
+
+	set_event_consigns(traj, d_consign, a_consign);
+}
+
+/** event called for path following, with the event mutex held */
+static void trajectory_path_event(struct trajectory *traj)
+{
+	struct quadramp_filter *q_d = traj->csm_distance->consign_filter_params;
+	float imp_per_mm = (float)traj->position->phys.distance_imp_per_mm;
+	float track_mm = (float)traj->position->phys.track_mm;
+	uint8_t nb_points = traj->nb_lookahead + 2;
+	vect2_cart pos, look, *p0, *p1, *p2;
+	float a, ux, uy, seg, t, remaining, look_mm, to_go, left, along, d;
+	float alpha, dist, curv, turn, speed, v, acc, a_speed;
+	int32_t d_consign, a_consign;
+	uint8_t i;
+
+	pos.x = position_get_x_float(traj->position);
+	pos.y = position_get_y_float(traj->position);
+	a = position_get_a_rad_float(traj->position);
+
+	/* step 1 : segment followed, the first one whose end is not
+	 * passed by the projection of the robot */
+	for (;;) {
+		p0 = path_point(traj, traj->path_idx - 1);
+		p1 = path_point(traj, traj->path_idx);
+		ux = p1->x - p0->x;
+		uy = p1->y - p0->y;
+		seg = sqrtf(ux * ux + uy * uy);
+		t = (seg > 0) ? ((pos.x - p0->x) * ux + (pos.y - p0->y) * uy) / seg : 0;
+		if (t < seg || traj->path_idx == nb_points - 1)
+			break;
+		traj->path_idx ++;
+	}
+
+	/* destination reached, the last consigns are kept */
+	if (traj->path_idx == nb_points - 1 &&
+	    (t >= seg || distance_mm(&pos, p1) < traj->d_win)) {
+		traj->event_armed = 0;
+		return;
+	}
+
+	/* length of the path left, from the projection of the robot */
+	if (t < 0)
+		t = 0;
+	remaining = seg - t;
+	for (i = traj->path_idx + 1; i < nb_points; i++)
+		remaining += distance_mm(path_point(traj, i - 1), path_point(traj, i));
+
+	/* pursued point, further along the path. The angle ramp lags
+	 * behind, so it is further at high speed */
+	v = ABS(q_d->previous_var) * q_d->period_divider;
+	look_mm = path_lookahead(traj, v);
+	look.x = p0->x + ux * t / seg;
+	look.y = p0->y + uy * t / seg;
+	to_go = look_mm;
+	for (i = traj->path_idx; i < nb_points; i++) {
+		p1 = path_point(traj, i);
+		left = distance_mm(&look, p1);
+		if (to_go < left) {
+			look.x += (p1->x - look.x) * to_go / left;
+			look.y += (p1->y - look.y) * to_go / left;
 			break;
 		}
+		look = *p1;
+		to_go -= left;
+	}
 
-		/* step 3 : send the processed commands to cs */
+	/* heading to the pursued point, and curvature of the arc from
+	 * the robot to it */
+	ux = look.x - pos.x;
+	uy = look.y - pos.y;
+	dist = sqrtf(ux * ux + uy * uy);
+	alpha = simple_modulo_2pi(fast_atan2f(uy, ux) - a);
 
-		vLockAngleConsign();
-		cs_set_consign(traj->csm_angle, a_consign);
-		vUnlockAngleConsign();
-		vLockDistanceConsign();
-		cs_set_consign(traj->csm_distance, d_consign);
-		vUnlockDistanceConsign();
+	/* step 2 : speeds */
+
+	if (ABS(alpha) > traj->a_start_rad) {
+		/* sharp corner: turn towards the pursued point first */
+		set_quadramp_speed(traj, 0, traj->a_speed);
+	}
+	else {
+		curv = (dist > 0) ? 2 * fast_sinf(alpha) / dist : 0;
+		speed = curvature_speed(traj, curv);
+
+		/* brake before the next corners */
+		acc = q_d->var_2nd_ord_pos;
+		if (q_d->var_2nd_ord_neg < acc)
+			acc = q_d->var_2nd_ord_neg;
+		along = seg - t;
+		for (i = traj->path_idx; i < nb_points - 1; i++) {
+			p0 = path_point(traj, i - 1);
+			p1 = path_point(traj, i);
+			p2 = path_point(traj, i + 1);
+			turn = fast_atan2f((p1->x - p0->x) * (p2->y - p1->y) - (p1->y - p0->y) * (p2->x - p1->x),
+					   (p1->x - p0->x) * (p2->x - p1->x) + (p1->y - p0->y) * (p2->y - p1->y));
+			v = corner_speed(traj, ABS(turn));
+			d = along - path_lookahead(traj, v);
+			if (d < 0)
+				d = 0;
+			v = quadramp_braking_var(d * imp_per_mm, v, acc, q_d->var_3rd_ord);
+			if (v < speed)
+				speed = v;
+			along += distance_mm(p1, p2);
+		}
+
+		/* the angle ramp turns at the rate of the arc, for the
+		 * current distance speed */
+		v = ABS(q_d->previous_var) * q_d->period_divider;
+		a_speed = ABS(curv) * v * track_mm / 2;
+		if (a_speed < 1)
+			a_speed = 1;
+		if (a_speed > traj->a_speed)
+			a_speed = traj->a_speed;
+		set_quadramp_speed(traj, speed, a_speed);
 	}
+
+	/* step 3 : send the processed commands to cs */
+
+	d_consign = (int32_t)(remaining * imp_per_mm);
+	d_consign += rs_get_distance(traj->robot);
+
+	/* towards the pursued point. XXX 2.2 instead of 2.0 as for the xy
+	 * events */
+	a_consign = (int32_t)(alpha * imp_per_mm * track_mm / 2.2f);
+	a_consign += rs_get_angle(traj->robot);
+
+	set_event_consigns(traj, d_consign, a_consign);
+}
+
+/** trajectory task, sleeping while no event is armed. It is woken up by
+ * schedule_event(), and runs the event every DO_TRAJECTORY_MSEC (or
+ * DO_TRAJECTORY_PATH_MSEC) until
+ * it is deleted. Lives as long as the trajectory, so that commands
+ * don't create tasks. */
+static void trajectory_manager_task(void *param)
+{
+	struct trajectory *traj = (struct trajectory *)param;
+	TickType_t next_wake_time = 0;
+	TickType_t period;
+	TickType_t wait;
+
+	for(;;)
+	{
+		/* the path following needs more frequent consigns */
+		period = (traj->state == RUNNING_PATH) ? DO_TRAJECTORY_PATH_MSEC : DO_TRAJECTORY_MSEC;
+
+		wait = portMAX_DELAY;
+		if (traj->event_armed) {
+			wait = next_wake_time - xTaskGetTickCount();
+			/* period already elapsed */
+			if (wait > period)
+				wait = 0;
+		}
+
+		/* a new event is processed at once */
+		if (ulTaskNotifyTake(pdTRUE, wait))
+			next_wake_time = xTaskGetTickCount();
+
+		xSemaphoreTake(traj->event_mutex, portMAX_DELAY);
+		if (traj->event_armed) {
+			next_wake_time += period;
+			trajectory_manager_event(traj);
+		}
+		xSemaphoreGive(traj->event_mutex);
+	}
+}
+
+/** return true if an xy event is running */
+uint8_t trajectory_event_running(struct trajectory *traj)
+{
+	return traj->event_armed;
 }
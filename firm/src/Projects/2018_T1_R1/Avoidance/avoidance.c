@@ -214,12 +214,14 @@ bool avd_detection_is_valid(void) {
   int16_t x;
   int16_t y;
   int16_t a;
+  struct robot_pose pose;
 
   // Sample values at once and use local variables only from here.
-  // This ensure atomicity (almost ~).
-  x = motion_get_x();
-  y = motion_get_y();
-  a = motion_get_a();
+  // The snapshot ensures they come from the same position update.
+  motion_get_pose(&pose);
+  x = pose.pos_s16.x;
+  y = pose.pos_s16.y;
+  a = pose.pos_s16.a;
 
   // Initialize dynamic masks (enabled)
   av.mask_dyn_front_left    = true;
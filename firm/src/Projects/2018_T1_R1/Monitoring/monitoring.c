@@ -17,6 +17,10 @@
 /* Inclusion */
 #include "../../2018_T1_R1/include/main.h"
 
+/* Battery voltage filter: each new value is weighted by 1/MON_VBAT_FILTER,
+ * this smooths the motor current peaks for the motion compensation */
+#define MON_VBAT_FILTER 8
+
 /* Local, Private functions */
 static void mon_task(void *pvParameters);
 
@@ -31,6 +35,7 @@ BaseType_t monitoring_start(void)
   mon_config.shunt_ip1_mohm  = ADC_SHUNT_IP1_MOHM;
   mon_config.shunt_ip2_mohm  = ADC_SHUNT_IP2_MOHM;
   mon_config.shunt_ip3_mohm  = ADC_SHUNT_IP3_MOHM;
+  mon_config.vbat_divider_x100 = MON_VBAT_DIVIDER_X100;
 
   // Create monitoring task
   return sys_create_task(mon_task, "MONITORING", OS_TASK_STACK_MONITORING, NULL, OS_TASK_PRIORITY_MONITORING, NULL );
@@ -39,6 +44,7 @@ BaseType_t monitoring_start(void)
 static void mon_task( void *pvParameters )
 {
   TickType_t xNextWakeTime;
+  uint32_t vbat_mv;
 
   /* Initialize xNextWakeTime - this only needs to be done once. */
   xNextWakeTime = xTaskGetTickCount();
@@ -56,6 +62,13 @@ static void mon_task( void *pvParameters )
     mon_values.ip3_ma = mon_config.shunt_ip3_mohm * bb_mon_convert_raw_value_to_mv(bb_mon_read_channel(BB_MON_IP3))  / 1000;
     mon_values.temp = bb_mon_convert_temp_value_to_degree(bb_mon_convert_raw_value_to_mv(bb_mon_read_channel(BB_MON_VTEMP)));
 
+    // Battery voltage, low-pass filtered from the first measurement on
+    vbat_mv = mon_config.vbat_divider_x100 * bb_mon_convert_raw_value_to_mv(bb_mon_read_channel(MON_VBAT_CHANNEL)) / 100;
+    if(mon_values.vbat_mv == 0)
+      mon_values.vbat_mv = vbat_mv;
+    else
+      mon_values.vbat_mv = (mon_values.vbat_mv * (MON_VBAT_FILTER - 1) + vbat_mv) / MON_VBAT_FILTER;
+
     vTaskDelayUntil( &xNextWakeTime, pdMS_TO_TICKS(OS_MONITORING_PERIOD_MS));
 
   } // infinite loop
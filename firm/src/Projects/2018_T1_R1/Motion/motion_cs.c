@@ -18,17 +18,34 @@
 
 /* Global functions */
 extern robot_t robot;
+extern mon_values_t mon_values;
 
 /* Local Mutex for Aversive */
-static xSemaphoreHandle xEncoderAngleMutex;
-static xSemaphoreHandle xEncoderDistanceMutex;
 static xSemaphoreHandle xAngleConsignMutex;
 static xSemaphoreHandle xDistanceConsignMutex;
-static xSemaphoreHandle xRobotPositionMutex;
+
+/* Control-system task, woken by the sampling timer */
+static TaskHandle_t handle_task_motion_cs;
+
+/* Processing time of the samples */
+static motion_cs_stats_t motion_cs_stats;
 
 /* Local, Private functions */
 static void motion_cs_init(void);
 static void motion_cs_task(void *pvParameters);
+static void motion_cs_set_distance(void *rs, int32_t distance);
+static void motion_cs_set_angle(void *rs, int32_t angle);
+static void motion_cs_set_pwm(void *channel, int32_t pwm);
+static void motion_cs_update_vbat_gain(void);
+static void motion_cs_update_wheel_speeds(void);
+static int32_t motion_cs_get_speed_d(void *rs);
+static int32_t motion_cs_get_speed_a(void *rs);
+static int32_t motion_cs_get_planned_speed(void *q);
+static void motion_cs_init_cascade(struct cascade_filter *cas,
+    struct pid_filter *pid_p, struct pid_filter *pid_v,
+    int32_t (*speed_feedback)(void *), struct quadramp_filter *q);
+static void motion_cs_select_correct_filter(struct cs *cs, bool cascade,
+    struct pid_filter *pid, struct cascade_filter *cas);
 
 /* -----------------------------------------------------------------------------
  * Initializations
@@ -37,26 +54,36 @@ static void motion_cs_task(void *pvParameters);
 
 BaseType_t motion_cs_start(void)
 {
+  BaseType_t ret;
+
   /* Initialize global variables */
   motion_cs_init();
 
   // Start the motion control task
-  return sys_create_task(motion_cs_task, "MOTION_CS", OS_TASK_STACK_MOTION_CS, NULL, OS_TASK_PRIORITY_MOTION_CS, NULL );
+  ret = sys_create_task(motion_cs_task, "MOTION_CS", OS_TASK_STACK_MOTION_CS, NULL, OS_TASK_PRIORITY_MOTION_CS, &handle_task_motion_cs);
+
+  // Then its sampling timer
+  if(ret == pdPASS) {
+    bb_sys_timer_ctrl_config(OS_MOTION_CS_PERIOD_US, OS_ISR_PRIORITY_MOTION_CS);
+  }
+
+  return ret;
 }
 
 void motion_cs_init(void)
 {
   /* Initialize mutexes */
-  xEncoderAngleMutex = xSemaphoreCreateMutex();
-  xEncoderDistanceMutex = xSemaphoreCreateMutex();
   xAngleConsignMutex = xSemaphoreCreateMutex();
   xDistanceConsignMutex = xSemaphoreCreateMutex();
-  xRobotPositionMutex = xSemaphoreCreateMutex();
 
   /* Robot System */
   rs_init(&robot.cs.rs);
-  rs_set_left_pwm(&robot.cs.rs,  (void*) bb_mot_set_motor_speed_fast_decay, (void*) MOT_CHANNEL_LEFT);
-  rs_set_right_pwm(&robot.cs.rs, (void*) bb_mot_set_motor_speed_fast_decay, (void*) MOT_CHANNEL_RIGHT);
+  rs_set_left_pwm(&robot.cs.rs,  motion_cs_set_pwm, (void*) MOT_CHANNEL_LEFT);
+  rs_set_right_pwm(&robot.cs.rs, motion_cs_set_pwm, (void*) MOT_CHANNEL_RIGHT);
+
+  /* PWM compensation of the battery voltage */
+  robot.cs.vbat_nominal_mv = PHYS_MOT_VBAT_NOMINAL_MV;
+  robot.cs.vbat_gain = 1.0f;
 
   /* External Encoders */
   rs_set_left_ext_encoder(&robot.cs.rs,  (void*) bb_enc_get_channel, (void*) ENC_CHANNEL_LEFT,  PHYS_ROBOT_ENCODER_LEFT_GAIN);
@@ -68,6 +95,7 @@ void motion_cs_init(void)
   position_set_physical_params(&robot.cs.pos, PHYS_ROBOT_ENCODERS_TRACK_MM, PHYS_ROBOT_NB_IMP_PER_MM);
   position_set_related_robot_system(&robot.cs.pos, &robot.cs.rs);
   position_use_ext(&robot.cs.pos);
+  position_set_sample_period(&robot.cs.pos, OS_MOTION_CS_PERIOD_US);
   //position_set_centrifugal_coef(&robot.cs.pos, PHYS_ROBOT_CENTRIFUGAL_COEF);
 
   /* Control System filter in Distance */
@@ -79,13 +107,34 @@ void motion_cs_init(void)
   quadramp_init(&robot.cs.qr_d);
   quadramp_set_1st_order_vars(&robot.cs.qr_d, PHYS_CS_D_QUAD_POS_SPEED, PHYS_CS_D_QUAD_NEG_SPEED);
   quadramp_set_2nd_order_vars(&robot.cs.qr_d, PHYS_CS_D_QUAD_POS_ACCEL, PHYS_CS_D_QUAD_NEG_ACCEL);
+  quadramp_set_3rd_order_var(&robot.cs.qr_d, PHYS_CS_D_QUAD_JERK);
   cs_init(&robot.cs.cs_d);
   cs_set_consign_filter(&robot.cs.cs_d, quadramp_do_filter, &robot.cs.qr_d);
-  cs_set_correct_filter(&robot.cs.cs_d, pid_do_filter, &robot.cs.pid_d);
-  cs_set_process_in(&robot.cs.cs_d, rs_set_distance, &robot.cs.rs);
+  cs_set_process_in(&robot.cs.cs_d, motion_cs_set_distance, &robot.cs.rs);
   cs_set_process_out(&robot.cs.cs_d, rs_get_distance, &robot.cs.rs);
   cs_set_consign(&robot.cs.cs_d, 0);
 
+  /* Gains and ramps are given per Aversive period, the control system
+   * runs OS_MOTION_CS_DIVIDER times in this period */
+  pid_set_period_divider(&robot.cs.pid_d, OS_MOTION_CS_DIVIDER);
+  quadramp_set_period_divider(&robot.cs.qr_d, OS_MOTION_CS_DIVIDER);
+  robot.cs.ff_d.kv = PHYS_CS_D_FF_KV;
+  robot.cs.ff_d.ka = PHYS_CS_D_FF_KA;
+
+  /* Cascaded loops in Distance, replacing pid_d when enabled */
+  pid_init(&robot.cs.pid_pd);
+  pid_set_gains(&robot.cs.pid_pd, PHYS_CS_D_POS_KP, 0, 0);
+  pid_set_maximums(&robot.cs.pid_pd, 0, 0, PHYS_CS_D_POS_MAX_OUT);
+  pid_set_out_shift(&robot.cs.pid_pd, PHYS_CS_D_POS_OUT_SHIFT);
+  pid_init(&robot.cs.pid_vd);
+  pid_set_gains(&robot.cs.pid_vd, PHYS_CS_D_SPEED_KP, PHYS_CS_D_SPEED_KI, 0);
+  pid_set_maximums(&robot.cs.pid_vd, 0, PHYS_CS_D_SPEED_MAX_I, PHYS_CS_D_SPEED_MAX_OUT);
+  pid_set_out_shift(&robot.cs.pid_vd, PHYS_CS_D_SPEED_OUT_SHIFT);
+  motion_cs_init_cascade(&robot.cs.cas_d, &robot.cs.pid_pd, &robot.cs.pid_vd,
+                         motion_cs_get_speed_d, &robot.cs.qr_d);
+  robot.cs.cascade_d = PHYS_CS_D_CASCADE;
+  motion_cs_select_correct_filter(&robot.cs.cs_d, robot.cs.cascade_d, &robot.cs.pid_d, &robot.cs.cas_d);
+
   /* Control System filter in Angle */
   pid_init(&robot.cs.pid_a);
   pid_set_gains(&robot.cs.pid_a, PHYS_CS_A_PID_KP, PHYS_CS_A_PID_KI, PHYS_CS_A_PID_KD);
@@ -95,12 +144,30 @@ void motion_cs_init(void)
   quadramp_init(&robot.cs.qr_a);
   quadramp_set_1st_order_vars(&robot.cs.qr_a, PHYS_CS_A_QUAD_POS_SPEED, PHYS_CS_A_QUAD_NEG_SPEED);
   quadramp_set_2nd_order_vars(&robot.cs.qr_a, PHYS_CS_A_QUAD_POS_ACCEL, PHYS_CS_A_QUAD_NEG_ACCEL);
+  quadramp_set_3rd_order_var(&robot.cs.qr_a, PHYS_CS_A_QUAD_JERK);
   cs_init(&robot.cs.cs_a);
   cs_set_consign_filter(&robot.cs.cs_a, quadramp_do_filter, &robot.cs.qr_a);
-  cs_set_correct_filter(&robot.cs.cs_a, pid_do_filter, &robot.cs.pid_a);
-  cs_set_process_in(&robot.cs.cs_a, rs_set_angle, &robot.cs.rs);
+  cs_set_process_in(&robot.cs.cs_a, motion_cs_set_angle, &robot.cs.rs);
   cs_set_process_out(&robot.cs.cs_a, rs_get_angle, &robot.cs.rs);
   cs_set_consign(&robot.cs.cs_a, 0);
+  pid_set_period_divider(&robot.cs.pid_a, OS_MOTION_CS_DIVIDER);
+  quadramp_set_period_divider(&robot.cs.qr_a, OS_MOTION_CS_DIVIDER);
+  robot.cs.ff_a.kv = PHYS_CS_A_FF_KV;
+  robot.cs.ff_a.ka = PHYS_CS_A_FF_KA;
+
+  /* Cascaded loops in Angle, replacing pid_a when enabled */
+  pid_init(&robot.cs.pid_pa);
+  pid_set_gains(&robot.cs.pid_pa, PHYS_CS_A_POS_KP, 0, 0);
+  pid_set_maximums(&robot.cs.pid_pa, 0, 0, PHYS_CS_A_POS_MAX_OUT);
+  pid_set_out_shift(&robot.cs.pid_pa, PHYS_CS_A_POS_OUT_SHIFT);
+  pid_init(&robot.cs.pid_va);
+  pid_set_gains(&robot.cs.pid_va, PHYS_CS_A_SPEED_KP, PHYS_CS_A_SPEED_KI, 0);
+  pid_set_maximums(&robot.cs.pid_va, 0, PHYS_CS_A_SPEED_MAX_I, PHYS_CS_A_SPEED_MAX_OUT);
+  pid_set_out_shift(&robot.cs.pid_va, PHYS_CS_A_SPEED_OUT_SHIFT);
+  motion_cs_init_cascade(&robot.cs.cas_a, &robot.cs.pid_pa, &robot.cs.pid_va,
+                         motion_cs_get_speed_a, &robot.cs.qr_a);
+  robot.cs.cascade_a = PHYS_CS_A_CASCADE;
+  motion_cs_select_correct_filter(&robot.cs.cs_a, robot.cs.cascade_a, &robot.cs.pid_a, &robot.cs.cas_a);
 
   /* Trajectory Manager */
   trajectory_init(&robot.cs.traj);
@@ -108,6 +175,8 @@ void motion_cs_init(void)
   trajectory_set_robot_params(&robot.cs.traj, &robot.cs.rs, &robot.cs.pos);
   trajectory_set_speed(&robot.cs.traj, PHYS_TRAJ_D_DEFAULT_SPEED, PHYS_TRAJ_A_DEFAULT_SPEED);
   trajectory_set_windows(&robot.cs.traj, PHYS_TRAJ_DEFAULT_WIN_D, PHYS_TRAJ_DEFAULT_WIN_A_DEG, PHYS_TRAJ_DEFAULT_WIN_A_START_DEG);
+  trajectory_set_near_windows(&robot.cs.traj, TRAJECTORY_NEAR_WINDOW_D, TRAJECTORY_NEAR_WINDOW_A);
+  trajectory_set_path_params(&robot.cs.traj, PHYS_TRAJ_PATH_LOOKAHEAD_MM, PHYS_TRAJ_PATH_LAT_ACCEL);
 
   /* Blocking detection */
   bd_init(&robot.cs.bd_l);
@@ -128,10 +197,17 @@ void motion_cs_init(void)
   robot.cs.cs_events =  DO_RS | DO_POS | DO_BD | DO_STATUS;
   //right_current = 0;
   //left_current = 0;
+
+  /* Cycle counter used for the processing time statistics */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  motion_cs_stats_reset();
 }
 
 /* -----------------------------------------------------------------------------
  * Main Motion Control System Managment Task
+ * Runs every OS_MOTION_CS_PERIOD_US, woken by the sampling timer, while the
+ * trajectory manager keeps its own (slower) period.
  * TODO: handle re-init of the task
  * -----------------------------------------------------------------------------
  */
@@ -143,41 +219,58 @@ void motion_cs_task(void *pvParameters)
   static int32_t old_d        = 0;
   static int32_t old_speed_a  = 0;
   static int32_t old_speed_d  = 0;
-  TickType_t xNextWakeTime;
-
-  /* Initialise xNextWakeTime - this only needs to be done once. */
-  xNextWakeTime = xTaskGetTickCount();
+  uint16_t sample = 0;
+  uint32_t nb_periods;
+  uint32_t start_cycles;
+  uint32_t cycles;
+  uint32_t budget_cycles = (SystemCoreClock / 1000000UL) * OS_MOTION_CS_PERIOD_US;
 
   /* Remove compiler warning about unused parameter. */
   ( void ) pvParameters;
 
   for( ;; )
   {
+    /* Wakes-up on the sampling timer, the notification value counts
+     * the periods elapsed since the previous sample */
+    nb_periods = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    start_cycles = DWT->CYCCNT;
 
     if(robot.cs.cs_events & DO_RS) {
 
       // Manage Robot System
       rs_update(&robot.cs.rs);
+      motion_cs_update_wheel_speeds();
+
+      // Speed and acceleration are kept in Aversive periods units
+      if(++sample >= OS_MOTION_CS_DIVIDER) {
+        sample = 0;
+
+        robot.cs.speed_a = rs_get_angle(&robot.cs.rs) - old_a;
+        robot.cs.speed_d = rs_get_distance(&robot.cs.rs) - old_d;
+        old_a = rs_get_angle(&robot.cs.rs);
+        old_d = rs_get_distance(&robot.cs.rs);
 
-      robot.cs.speed_a = rs_get_angle(&robot.cs.rs) - old_a;
-      robot.cs.speed_d = rs_get_distance(&robot.cs.rs) - old_d;
-      old_a = rs_get_angle(&robot.cs.rs);
-      old_d = rs_get_distance(&robot.cs.rs);
+        robot.cs.acceleration_a = robot.cs.speed_a - old_speed_a;
+        robot.cs.acceleration_d = robot.cs.speed_d - old_speed_d;
+        old_speed_a = robot.cs.speed_a;
+        old_speed_d = robot.cs.speed_d;
 
-      robot.cs.acceleration_a = robot.cs.speed_a - old_speed_a;
-      robot.cs.acceleration_d = robot.cs.speed_d - old_speed_d;
-      old_speed_a = robot.cs.speed_a;
-      old_speed_d = robot.cs.speed_d;
+        // The battery voltage is filtered much slower than that
+        motion_cs_update_vbat_gain();
+      }
 
     }
 
     if (robot.cs.cs_events & DO_POWER)
     {
-      // Main CS Management
+      // Main CS Management, the correct filters being switched between two
+      // samples when the cascades are enabled or disabled from the shell
       vLockDistanceConsign();
+      motion_cs_select_correct_filter(&robot.cs.cs_d, robot.cs.cascade_d, &robot.cs.pid_d, &robot.cs.cas_d);
       cs_manage(&robot.cs.cs_d);
       vUnlockDistanceConsign();
       vLockAngleConsign();
+      motion_cs_select_correct_filter(&robot.cs.cs_a, robot.cs.cascade_a, &robot.cs.pid_a, &robot.cs.cas_a);
       cs_manage(&robot.cs.cs_a);
       vUnlockAngleConsign();
     }
@@ -192,15 +285,296 @@ void motion_cs_task(void *pvParameters)
       position_manage(&robot.cs.pos);
     }
 
+    // Publish the near and finished events of the trajectory, so that the
+    // waypoints are chained at the sample they are reached
+    trajectory_update_events(&robot.cs.traj);
+
     /* Blocking-detection manager:
      * TODO: Add me */
     /* trajectory_hardstop(pRobot.traj);*/
 
-    /* Wakes-up when required */
-    vTaskDelayUntil( &xNextWakeTime, pdMS_TO_TICKS(OS_AVERSIVE_PERIOD_MS));
+    /* Processing time statistics */
+    cycles = DWT->CYCCNT - start_cycles;
+
+    taskENTER_CRITICAL();
+    motion_cs_stats.nb_samples++;
+    if(nb_periods > 1)
+      motion_cs_stats.nb_missed += nb_periods - 1;
+    if(cycles > budget_cycles)
+      motion_cs_stats.nb_overruns++;
+    if(cycles > motion_cs_stats.max_cycles)
+      motion_cs_stats.max_cycles = cycles;
+    motion_cs_stats.last_cycles = cycles;
+    motion_cs_stats.total_cycles += cycles;
+    taskEXIT_CRITICAL();
   }
 }
 
+/* -----------------------------------------------------------------------------
+ * Compensation stage, between the control systems and the motors
+ * -----------------------------------------------------------------------------
+ */
+
+// Feed-forward of a control system, from the speed and acceleration planned
+// by its quadramp for the current sample, in Aversive period units
+static int32_t motion_cs_feed_forward(struct quadramp_filter *q, motion_ff_t *ff)
+{
+  float divider = q->period_divider;
+
+  return (int32_t) (ff->kv * q->previous_var * divider +
+                    ff->ka * q->previous_acc * divider * divider);
+}
+
+static void motion_cs_set_distance(void *rs, int32_t distance)
+{
+  rs_set_distance(rs, distance + motion_cs_feed_forward(&robot.cs.qr_d, &robot.cs.ff_d));
+}
+
+static void motion_cs_set_angle(void *rs, int32_t angle)
+{
+  rs_set_angle(rs, angle + motion_cs_feed_forward(&robot.cs.qr_a, &robot.cs.ff_a));
+}
+
+// Motors PWM, scaled by the battery voltage so that a command gives the same
+// torque as the pack drains, and saturated
+static void motion_cs_set_pwm(void *channel, int32_t pwm)
+{
+  pwm = (int32_t) (pwm * robot.cs.vbat_gain);
+
+  // Saturated here, the motor driver truncates its input to 16 bits
+  if(pwm > MOT_TIMER_PERIOD)
+    pwm = MOT_TIMER_PERIOD;
+  else if(pwm < -MOT_TIMER_PERIOD)
+    pwm = -MOT_TIMER_PERIOD;
+
+  if((BB_MOT_ChannelTypeDef) (uint32_t) channel == MOT_CHANNEL_LEFT)
+    robot.cs.pwm_l = pwm;
+  else
+    robot.cs.pwm_r = pwm;
+
+  bb_mot_set_motor_speed_fast_decay((BB_MOT_ChannelTypeDef) (uint32_t) channel, pwm);
+}
+
+// Nominal over measured battery voltage. Without a valid measurement (yet),
+// the PWM is left as is.
+static void motion_cs_update_vbat_gain(void)
+{
+  uint32_t vbat_mv = mon_values.vbat_mv;
+  float gain = 1.0f;
+
+  if(robot.cs.vbat_nominal_mv && (vbat_mv >= PHYS_MOT_VBAT_MIN_MV)) {
+    gain = (float) robot.cs.vbat_nominal_mv / vbat_mv;
+    if(gain > PHYS_MOT_VBAT_MAX_GAIN)
+      gain = PHYS_MOT_VBAT_MAX_GAIN;
+  }
+
+  robot.cs.vbat_gain = gain;
+}
+
+/* -----------------------------------------------------------------------------
+ * Cascaded position / speed loops
+ * -----------------------------------------------------------------------------
+ */
+
+// Speed of each wheel over the last PHYS_CS_SPEED_WINDOW samples, in Aversive
+// period units like the quadramps: a difference over a single sample would
+// only be a few impulses.
+static void motion_cs_update_wheel_speeds(void)
+{
+  static struct rs_wheels history[PHYS_CS_SPEED_WINDOW];
+  static uint8_t idx = 0;
+  struct rs_wheels *oldest = &history[idx];
+  struct rs_wheels *wheels = &robot.cs.rs.wext_prev;
+
+  robot.cs.wheel_speed_l = (wheels->left  - oldest->left)  * OS_MOTION_CS_DIVIDER / PHYS_CS_SPEED_WINDOW;
+  robot.cs.wheel_speed_r = (wheels->right - oldest->right) * OS_MOTION_CS_DIVIDER / PHYS_CS_SPEED_WINDOW;
+
+  *oldest = *wheels;
+  if(++idx >= PHYS_CS_SPEED_WINDOW)
+    idx = 0;
+}
+
+// Speeds in the distance and angle units of the robot system
+static int32_t motion_cs_get_speed_d(void *rs)
+{
+  return (robot.cs.wheel_speed_r + robot.cs.wheel_speed_l) / 2;
+}
+
+static int32_t motion_cs_get_speed_a(void *rs)
+{
+  return (robot.cs.wheel_speed_r - robot.cs.wheel_speed_l) / 2;
+}
+
+// Speed planned by a quadramp for the current sample, added to the speed
+// consign of the outer loop so that it only corrects the position error
+static int32_t motion_cs_get_planned_speed(void *q)
+{
+  struct quadramp_filter *qr = q;
+
+  return qr->previous_var * (int32_t) qr->period_divider;
+}
+
+static void motion_cs_init_cascade(struct cascade_filter *cas,
+    struct pid_filter *pid_p, struct pid_filter *pid_v,
+    int32_t (*speed_feedback)(void *), struct quadramp_filter *q)
+{
+  // The outer pid only runs every PHYS_CS_CASCADE_OUTER_DIVIDER samples
+  pid_set_period_divider(pid_p, OS_MOTION_CS_DIVIDER / PHYS_CS_CASCADE_OUTER_DIVIDER);
+  pid_set_period_divider(pid_v, OS_MOTION_CS_DIVIDER);
+
+  cascade_init(cas);
+  cascade_set_outer_filter(cas, pid_do_filter, pid_p);
+  cascade_set_inner_filter(cas, pid_do_filter, pid_v);
+  cascade_set_speed_feedback(cas, speed_feedback, &robot.cs.rs);
+  cascade_set_speed_feedforward(cas, motion_cs_get_planned_speed, q);
+  cascade_set_outer_divider(cas, PHYS_CS_CASCADE_OUTER_DIVIDER);
+}
+
+// Correct filter of a control system: its position pid, or the cascade. The
+// filters taking over start from a clean state.
+static void motion_cs_select_correct_filter(struct cs *cs, bool cascade,
+    struct pid_filter *pid, struct cascade_filter *cas)
+{
+  if(cascade) {
+    if(cs->correct_filter != cascade_do_filter) {
+      pid_reset(cas->outer_filter_params);
+      pid_reset(cas->inner_filter_params);
+      cascade_reset(cas);
+      cs_set_correct_filter(cs, cascade_do_filter, cas);
+    }
+  } else if(cs->correct_filter != pid_do_filter) {
+    pid_reset(pid);
+    cs_set_correct_filter(cs, pid_do_filter, pid);
+  }
+}
+
+/*
+ * Control-system sampling timer ISR: wakes the control-system task up
+ */
+void SYS_CTRL_ISR (void)
+{
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+  bb_sys_timer_ctrl_clear_it();
+
+  vTaskNotifyGiveFromISR(handle_task_motion_cs, &xHigherPriorityTaskWoken);
+
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/* -----------------------------------------------------------------------------
+ * Control system processing time
+ * -----------------------------------------------------------------------------
+ */
+
+void motion_cs_stats_print(char* ret, size_t len)
+{
+  motion_cs_stats_t stats;
+  uint32_t cycles_per_us = SystemCoreClock / 1000000UL;
+
+  taskENTER_CRITICAL();
+  stats = motion_cs_stats;
+  taskEXIT_CRITICAL();
+
+  snprintf(ret, len,
+      "Control system: %u us period, %u samples per Aversive period"SHELL_EOL
+      "  samples      %10lu (%lu missed)"SHELL_EOL
+      "  last         %10lu us"SHELL_EOL
+      "  average      %10lu us"SHELL_EOL
+      "  max          %10lu us"SHELL_EOL
+      "  budget       %10u us (%lu overruns)"SHELL_EOL,
+      OS_MOTION_CS_PERIOD_US, OS_MOTION_CS_DIVIDER,
+      stats.nb_samples, stats.nb_missed,
+      stats.last_cycles / cycles_per_us,
+      stats.nb_samples ? (uint32_t) (stats.total_cycles / stats.nb_samples / cycles_per_us) : 0,
+      stats.max_cycles / cycles_per_us,
+      OS_MOTION_CS_PERIOD_US, stats.nb_overruns);
+}
+
+void motion_cs_stats_reset(void)
+{
+  taskENTER_CRITICAL();
+  memset(&motion_cs_stats, 0, sizeof(motion_cs_stats));
+  taskEXIT_CRITICAL();
+}
+
+/* -----------------------------------------------------------------------------
+ * Cost of the float trigonometry used by the position and trajectory managers
+ * against the double libm, in cycles per call, and its maximum error over
+ * [-2.pi; 2.pi].
+ * -----------------------------------------------------------------------------
+ */
+
+#define MOTION_CS_BENCH_SAMPLES 256
+
+void motion_cs_math_bench_print(char* ret, size_t len)
+{
+  volatile double sink_d = 0;
+  volatile float sink_f = 0;
+  double err_sincos = 0;
+  double err_atan2 = 0;
+  double err;
+  float s, c, a;
+  uint32_t start;
+  uint32_t cycles[4];
+  uint16_t idx;
+
+  // Angles are recomputed in each loop, so all of them have the same overhead
+#define MOTION_CS_BENCH_ANGLE(i) ((float) (i) * (4 * M_PI_F / MOTION_CS_BENCH_SAMPLES) - 2 * M_PI_F)
+
+  start = DWT->CYCCNT;
+  for(idx = 0; idx < MOTION_CS_BENCH_SAMPLES; idx++) {
+    a = MOTION_CS_BENCH_ANGLE(idx);
+    sink_d = sin(a) + cos(a);
+  }
+  cycles[0] = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  for(idx = 0; idx < MOTION_CS_BENCH_SAMPLES; idx++) {
+    fast_sincosf(MOTION_CS_BENCH_ANGLE(idx), &s, &c);
+    sink_f = s + c;
+  }
+  cycles[1] = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  for(idx = 0; idx < MOTION_CS_BENCH_SAMPLES; idx++) {
+    a = MOTION_CS_BENCH_ANGLE(idx);
+    sink_d = atan2(a, 1.0f - a);
+  }
+  cycles[2] = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  for(idx = 0; idx < MOTION_CS_BENCH_SAMPLES; idx++) {
+    a = MOTION_CS_BENCH_ANGLE(idx);
+    sink_f = fast_atan2f(a, 1.0f - a);
+  }
+  cycles[3] = DWT->CYCCNT - start;
+
+  // Errors against the double reference
+  for(idx = 0; idx < MOTION_CS_BENCH_SAMPLES; idx++) {
+    a = MOTION_CS_BENCH_ANGLE(idx);
+    fast_sincosf(a, &s, &c);
+    err = fabs(s - sin(a)) + fabs(c - cos(a));
+    if(err > err_sincos)
+      err_sincos = err;
+    err = fabs(fast_atan2f(a, 1.0f - a) - atan2(a, 1.0f - a));
+    if(err > err_atan2)
+      err_atan2 = err;
+  }
+
+#undef MOTION_CS_BENCH_ANGLE
+
+  (void) sink_d;
+  (void) sink_f;
+
+  snprintf(ret, len,
+      "Trigonometry: cycles per call (double libm / float), max error"SHELL_EOL
+      "  sin + cos    %6lu / %6lu   %.2e"SHELL_EOL
+      "  atan2        %6lu / %6lu   %.2e rad"SHELL_EOL,
+      cycles[0] / MOTION_CS_BENCH_SAMPLES, cycles[1] / MOTION_CS_BENCH_SAMPLES, err_sincos,
+      cycles[2] / MOTION_CS_BENCH_SAMPLES, cycles[3] / MOTION_CS_BENCH_SAMPLES, err_atan2);
+}
+
 /* -----------------------------------------------------------------------------
  * Control system software flags
  * -----------------------------------------------------------------------------
@@ -224,21 +598,21 @@ void motion_power_disable(void)
 
 void motion_set_x(int16_t pos_x)
 {
-  int16_t pos_y = position_get_y_s16(&robot.cs.pos);
-  int16_t pos_a = position_get_a_deg_s16(&robot.cs.pos);
-  position_set(&robot.cs.pos, pos_x, pos_y, pos_a);
+  struct robot_pose pose;
+  position_get_pose(&robot.cs.pos, &pose);
+  position_set(&robot.cs.pos, pos_x, pose.pos_s16.y, pose.pos_s16.a);
 }
 void motion_set_y(int16_t pos_y)
 {
-  int16_t pos_x = position_get_x_s16(&robot.cs.pos);
-  int16_t pos_a = position_get_a_deg_s16(&robot.cs.pos);
-  position_set(&robot.cs.pos, pos_x, pos_y, pos_a);
+  struct robot_pose pose;
+  position_get_pose(&robot.cs.pos, &pose);
+  position_set(&robot.cs.pos, pose.pos_s16.x, pos_y, pose.pos_s16.a);
 }
 void motion_set_a(int16_t pos_a)
 {
-  int16_t pos_x = position_get_x_s16(&robot.cs.pos);
-  int16_t pos_y = position_get_y_s16(&robot.cs.pos);
-  position_set(&robot.cs.pos, pos_x, pos_y, pos_a);
+  struct robot_pose pose;
+  position_get_pose(&robot.cs.pos, &pose);
+  position_set(&robot.cs.pos, pose.pos_s16.x, pose.pos_s16.y, pos_a);
 }
 
 /* -----------------------------------------------------------------------------
@@ -259,21 +633,17 @@ int16_t motion_get_a(void)
   return position_get_a_deg_s16(&robot.cs.pos);
 }
 
+// x, y, a and speeds from the same control-system sample
+void motion_get_pose(struct robot_pose* pose)
+{
+  position_get_pose(&robot.cs.pos, pose);
+}
+
 /* -----------------------------------------------------------------------------
  * Aversive mutexes management
  * -----------------------------------------------------------------------------
  */
 
-inline void vLockEncoderAngle(void)
-{
-  xSemaphoreTake(xEncoderAngleMutex, portMAX_DELAY);
-}
-
-inline void vLockEncoderDistance(void)
-{
-  xSemaphoreTake(xEncoderDistanceMutex, portMAX_DELAY);
-}
-
 inline void vLockAngleConsign(void)
 {
   xSemaphoreTake(xAngleConsignMutex, portMAX_DELAY);
@@ -284,19 +654,12 @@ inline void vLockDistanceConsign(void)
   xSemaphoreTake(xDistanceConsignMutex, portMAX_DELAY);
 }
 
+// Serializes the robot position writers (position_set() and the control
+// system). Readers use the pose sequence counter and never take it, so
+// the control loop never waits for them.
 inline void vLockRobotPosition(void)
 {
-  xSemaphoreTake(xRobotPositionMutex, portMAX_DELAY);
-}
-
-inline void vUnlockEncoderAngle(void)
-{
-  xSemaphoreGive(xEncoderAngleMutex);
-}
-
-inline void vUnlockEncoderDistance(void)
-{
-  xSemaphoreGive(xEncoderDistanceMutex);
+  taskENTER_CRITICAL();
 }
 
 inline void vUnlockAngleConsign(void)
@@ -311,5 +674,5 @@ inline void vUnlockDistanceConsign(void)
 
 inline void vUnlockRobotPosition(void)
 {
-  xSemaphoreGive(xRobotPositionMutex);
+  taskEXIT_CRITICAL();
 }
@@ -19,17 +19,29 @@
 /* Global functions */
 extern robot_t robot;
 
-static double traj_near_window_d = TRAJECTORY_NEAR_WINDOW_D;
-static double traj_near_window_a = TRAJECTORY_NEAR_WINDOW_A;
-
 // TODO: check
 extern av_t av;
 
 /* Local private variables */
 static xQueueHandle   xWaypointQueue;
+static xSemaphoreHandle xWaypointMutex;  // Waypoint being executed and queue content
+static wp_t current_waypoint;
+static bool current_waypoint_active;
+static uint32_t wp_next_ticket;     // Ticket given to the next waypoint added
+static uint32_t wp_current_ticket;  // Ticket of the waypoint being executed
+static uint32_t wp_cleared_ticket;  // Queued tickets below it were dropped
+static TaskHandle_t wp_done_task;   // Notified when a waypoint is done
+static wp_t wp_pending[MOTION_MAX_WP_IN_QUEUE]; // Queued waypoints, indexed by ticket
+static bool path_tracking = MOTION_PATH_TRACKING;
+static vect2_cart wp_path_start;    // Start of the path, if passed without stopping
+static bool wp_path_start_valid;
+
+TaskHandle_t handle_task_motion_traj;
 
 /* Local Private functions */
 static void motion_traj_task(void *pvParameters);
+static bool motion_is_wp_goto(wp_t *waypoint);
+static void motion_set_wp_lookahead(void);
 
 /* -----------------------------------------------------------------------------
  * Initializations
@@ -40,6 +52,8 @@ BaseType_t motion_traj_start(void)
 {
   BaseType_t ret;
 
+  xWaypointMutex = xSemaphoreCreateMutex();
+
   // Allocate memory for the waypoint queue
   xWaypointQueue = xQueueCreate(MOTION_MAX_WP_IN_QUEUE, sizeof(wp_t));
   if(xWaypointQueue == 0)
@@ -49,7 +63,7 @@ BaseType_t motion_traj_start(void)
 
   // Create the motion trajectory task
   } else {
-    ret = sys_create_task(motion_traj_task, "MOTION_TRAJ", OS_TASK_STACK_MOTION_TRAJ, NULL, OS_TASK_PRIORITY_MOTION_TRAJ, NULL);
+    ret = sys_create_task(motion_traj_task, "MOTION_TRAJ", OS_TASK_STACK_MOTION_TRAJ, NULL, OS_TASK_PRIORITY_MOTION_TRAJ, &handle_task_motion_traj);
   }
 
   return ret;
@@ -63,21 +77,51 @@ BaseType_t motion_traj_start(void)
 
 static void motion_traj_task( void *pvParameters )
 {
-  static wp_t current_waypoint;
+  wp_t next_waypoint;
+  EventBits_t wp_event;
 
   /* Remove compiler warning about unused parameter. */
   ( void ) pvParameters;
 
   for( ;; )
   {
-    xQueueReceive(xWaypointQueue, &current_waypoint, portMAX_DELAY);
+    // Wait for a waypoint, it is only removed from the queue while holding
+    // the mutex, so that motion_replace_all_wp() never misses it
+    xQueuePeek(xWaypointQueue, &next_waypoint, portMAX_DELAY);
+
+    xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+    if(xQueueReceive(xWaypointQueue, &current_waypoint, 0) == pdPASS) {
+      wp_current_ticket = wp_next_ticket - uxQueueMessagesWaiting(xWaypointQueue) - 1;
+      current_waypoint_active = true;
+      motion_execute_wp(&current_waypoint);
+      motion_set_wp_lookahead();
+    }
+    xSemaphoreGive(xWaypointMutex);
 
+    // Wakes-up as soon as the waypoint is done, so that the next one is
+    // executed at once. The current waypoint can be replaced meanwhile,
+    // with another event to wait for: the period is only a fallback.
+    while(current_waypoint_active)
+    {
+      xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+      wp_event = current_waypoint.trajectory_must_finish ? TRAJ_EVT_DONE : TRAJ_EVT_NEAR;
+      xSemaphoreGive(xWaypointMutex);
 
-    motion_execute_wp(&current_waypoint);
+      trajectory_wait_events(&robot.cs.traj, wp_event, pdMS_TO_TICKS(OS_MOTION_CONTROL_PERIOD_MS));
 
-    while(!motion_is_traj_done(&current_waypoint))
-    {
-      vTaskDelay(pdMS_TO_TICKS(OS_MOTION_CONTROL_PERIOD_MS));
+      xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+      if(current_waypoint_active && motion_is_traj_done(&current_waypoint)) {
+        current_waypoint_active = false;
+
+        // The path of the next waypoint starts on this one
+        wp_path_start_valid = motion_is_wp_goto(&current_waypoint) && !current_waypoint.trajectory_must_finish;
+        wp_path_start.x = current_waypoint.coord.abs.x;
+        wp_path_start.y = current_waypoint.coord.abs.y;
+
+        if(wp_done_task != NULL)
+          xTaskNotify(wp_done_task, OS_NOTIFY_MOTION_WP_DONE, eSetBits);
+      }
+      xSemaphoreGive(xWaypointMutex);
     }
 
   } // traj done
@@ -89,14 +133,29 @@ static void motion_traj_task( void *pvParameters )
  * -----------------------------------------------------------------------------
  */
 
+// Events published by the motion control task for the current trajectory
 inline bool motion_is_traj_near(void)
 {
-  return (bool) trajectory_in_window(&robot.cs.traj, traj_near_window_d, traj_near_window_a);
+  return (trajectory_get_events(&robot.cs.traj) & TRAJ_EVT_NEAR) != 0;
 }
 
 inline bool motion_is_traj_finished(void)
 {
-  return (bool) (trajectory_finished(&robot.cs.traj)&&(robot.cs.traj.scheduler_task==NULL));
+  return (trajectory_get_events(&robot.cs.traj) & TRAJ_EVT_DONE) != 0;
+}
+
+// Latency of the xy trajectories, from the command to the first consigns,
+// and heap usage (trajectories must not allocate anything)
+void motion_traj_stats_print(char* ret, size_t len)
+{
+  snprintf(ret, len,
+      "Trajectory: command to consign latency"SHELL_EOL
+      "  last         %10lu ms"SHELL_EOL
+      "  max          %10lu ms"SHELL_EOL
+      "Heap: %u bytes free, %u bytes min ever free"SHELL_EOL,
+      robot.cs.traj.last_latency * portTICK_PERIOD_MS,
+      robot.cs.traj.max_latency * portTICK_PERIOD_MS,
+      xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize());
 }
 
 /* -----------------------------------------------------------------------------
@@ -111,8 +170,7 @@ inline void motion_set_window(double window_d, double window_a, double a_start)
 
 void motion_set_near_window(double window_d, double window_a)
 {
-  traj_near_window_d = (double) window_d;
-  traj_near_window_a  = (double) window_a;
+  trajectory_set_near_windows(&robot.cs.traj, window_d, window_a);
 }
 
 inline void motion_set_speed(int16_t speed_d, int16_t speed_a)
@@ -170,15 +228,190 @@ void motion_turnto_behind(double pos_x, double pos_y)
  * -----------------------------------------------------------------------------
  */
 
+// Drop the queued waypoints, the one being executed goes on. The dropped
+// waypoints are then done for motion_is_wp_done(), their waiter is woken.
 void motion_clear_all_wp(void)
 {
-  wp_t lost;
-  while(xQueueReceive(xWaypointQueue, &lost, 0));
+  xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+  xQueueReset(xWaypointQueue);
+  wp_cleared_ticket = wp_next_ticket;
+
+  if(wp_done_task != NULL)
+    xTaskNotify(wp_done_task, OS_NOTIFY_MOTION_WP_DONE, eSetBits);
+  xSemaphoreGive(xWaypointMutex);
+}
+
+// Queue a waypoint. Its ticket is returned in ticket (if not NULL), taken
+// with the queue locked so that it is the one of this waypoint even with
+// several producers.
+BaseType_t motion_add_new_wp(wp_t *waypoint, uint32_t *ticket)
+{
+  BaseType_t ret;
+
+  xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+  ret = xQueueSend(xWaypointQueue, waypoint, 0);
+  if(ret == pdPASS) {
+    if(ticket != NULL)
+      *ticket = wp_next_ticket;
+    wp_pending[wp_next_ticket++ % MOTION_MAX_WP_IN_QUEUE] = *waypoint;
+
+    // The waypoint being executed may now be passed without stopping
+    if(current_waypoint_active)
+      motion_set_wp_lookahead();
+  }
+  xSemaphoreGive(xWaypointMutex);
+
+  return ret;
 }
 
-BaseType_t motion_add_new_wp(wp_t *waypoint)
+// Replace the waypoint being executed and the queued ones by a new sequence,
+// without any stop in-between. The first waypoint is executed right away.
+// Waypoints get a ticket in their adding order, the one of the first new
+// waypoint is returned in first_ticket.
+BaseType_t motion_replace_all_wp(wp_t *waypoints, uint8_t nb_waypoints, uint32_t *first_ticket)
 {
-  return xQueueSend(xWaypointQueue, waypoint, 0);
+  BaseType_t ret = pdPASS;
+  uint8_t idx = 0;
+
+  xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+
+  xQueueReset(xWaypointQueue);
+  *first_ticket = wp_next_ticket;
+
+  // The new first waypoint takes the place of the current one
+  if(current_waypoint_active && (nb_waypoints > 0)) {
+    current_waypoint = waypoints[idx++];
+    wp_current_ticket = wp_next_ticket++;
+  }
+
+  // The new path starts from the robot
+  wp_path_start_valid = false;
+
+  for(; (idx < nb_waypoints) && (ret == pdPASS); idx++) {
+    ret = xQueueSend(xWaypointQueue, &waypoints[idx], 0);
+    if(ret == pdPASS)
+      wp_pending[wp_next_ticket++ % MOTION_MAX_WP_IN_QUEUE] = waypoints[idx];
+  }
+
+  // Executed once the next ones are queued, for the lookahead
+  if(current_waypoint_active && (nb_waypoints > 0)) {
+    motion_execute_wp(&current_waypoint);
+    motion_set_wp_lookahead();
+  }
+
+  // The replaced waypoints are done
+  if(wp_done_task != NULL)
+    xTaskNotify(wp_done_task, OS_NOTIFY_MOTION_WP_DONE, eSetBits);
+
+  xSemaphoreGive(xWaypointMutex);
+
+  return ret;
+}
+
+// Returns true when a waypoint is being executed.
+// The ticket given is the one of this waypoint, or the one of the next
+// waypoint to be executed otherwise.
+bool motion_get_current_wp_ticket(uint32_t *ticket)
+{
+  bool active;
+
+  xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+  active = current_waypoint_active;
+  if(active)
+    *ticket = wp_current_ticket;
+  else
+    *ticket = wp_next_ticket - uxQueueMessagesWaiting(xWaypointQueue);
+  xSemaphoreGive(xWaypointMutex);
+
+  return active;
+}
+
+// Returns true once the waypoint of the given ticket is done, replaced by
+// motion_replace_all_wp() or dropped by motion_clear_all_wp().
+// The tickets between the one being executed and the last cleared one
+// can only have been dropped.
+bool motion_is_wp_done(uint32_t ticket)
+{
+  uint32_t current_ticket;
+  bool done;
+
+  xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+  if(current_waypoint_active)
+    current_ticket = wp_current_ticket;
+  else
+    current_ticket = wp_next_ticket - uxQueueMessagesWaiting(xWaypointQueue);
+
+  done = ((int32_t) (ticket - current_ticket) < 0) ||
+         ((ticket != current_ticket) && ((int32_t) (ticket - wp_cleared_ticket) < 0));
+  xSemaphoreGive(xWaypointMutex);
+
+  return done;
+}
+
+// Task notified with OS_NOTIFY_MOTION_WP_DONE each time a waypoint is done,
+// NULL for none. It must be removed before the task is deleted.
+void motion_set_wp_done_task(TaskHandle_t task)
+{
+  xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+  wp_done_task = task;
+  xSemaphoreGive(xWaypointMutex);
+}
+
+// Follow the chained forward waypoints as a path (default), or reach them
+// one after the other. Taken into account from the next waypoint.
+void motion_set_path_tracking(bool enable)
+{
+  xSemaphoreTake(xWaypointMutex, portMAX_DELAY);
+  path_tracking = enable;
+  xSemaphoreGive(xWaypointMutex);
+}
+
+static bool motion_is_wp_goto(wp_t *waypoint)
+{
+  return (waypoint->type == WP_GOTO_AUTO) ||
+         (waypoint->type == WP_GOTO_FWD) ||
+         (waypoint->type == WP_GOTO_BWD);
+}
+
+// Give the trajectory the queued waypoints that follow the one being
+// executed, so that it is passed without stopping. Only the "GOTO" ones
+// of the same type and speed are chained, up to the first one on which
+// the robot must stop. Unless driving backward, they are followed as a
+// path when the path tracking is enabled.
+// Must be called with the waypoint mutex held.
+static void motion_set_wp_lookahead(void)
+{
+  vect2_cart points[TRAJ_MAX_LOOKAHEAD];
+  uint8_t nb_points = 0;
+  uint32_t ticket;
+  wp_t *waypoint;
+
+  if(!motion_is_wp_goto(&current_waypoint) || current_waypoint.trajectory_must_finish)
+    return;
+
+  ticket = wp_next_ticket - uxQueueMessagesWaiting(xWaypointQueue);
+
+  for(; (ticket != wp_next_ticket) && (nb_points < TRAJ_MAX_LOOKAHEAD); ticket++) {
+    waypoint = &wp_pending[ticket % MOTION_MAX_WP_IN_QUEUE];
+    if((waypoint->type != current_waypoint.type) || (waypoint->speed != current_waypoint.speed))
+      break;
+
+    points[nb_points].x = waypoint->coord.abs.x;
+    points[nb_points].y = waypoint->coord.abs.y;
+    nb_points++;
+
+    if(waypoint->trajectory_must_finish)
+      break;
+  }
+
+  if(nb_points == 0)
+    return;
+
+  if(path_tracking && (current_waypoint.type != WP_GOTO_BWD))
+    trajectory_follow_path(&robot.cs.traj, wp_path_start_valid ? &wp_path_start : NULL,
+                           points, nb_points);
+  else
+    trajectory_set_lookahead(&robot.cs.traj, points, nb_points);
 }
 
 bool motion_is_traj_done(wp_t *waypoint)
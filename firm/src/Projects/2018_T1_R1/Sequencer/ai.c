@@ -71,6 +71,9 @@ BaseType_t ai_init(void)
   phys_update_color_pois();
   phys_update_color_polys();
 
+  // Precompute the paths between the main POIs for this color
+  phys_build_poi_paths();
+
   // Initialize robot position with correct color
   motion_set_x(phys.reset.x);
   motion_set_y(phys.reset.y);
@@ -173,6 +176,13 @@ void ai_manage(bool notified, uint32_t sw_notification)
 
     }
 
+    // A dynamic obstacle has moved: the followed path is checked here, not
+    // in the task updating the obstacles
+    if(sw_notification & OS_NOTIFY_PATH_CHECK)
+    {
+      ai_check_path();
+    }
+
     // Notify the current AI task with the same notifications (forward)
     if(task_mgt.active_task->handle != NULL) {
       xTaskNotify(task_mgt.active_task->handle, sw_notification, eSetBits);
@@ -190,6 +200,8 @@ void ai_manage(bool notified, uint32_t sw_notification)
   // Stop motion
   else if(match.timer_msec >= MATCH_DURATION_MSEC) {
 
+    // The task may be waiting for its waypoint
+    motion_set_wp_done_task(NULL);
     vTaskDelete(task_mgt.active_task->handle);
     motion_traj_hard_stop();
   }
@@ -346,6 +358,9 @@ void ai_tasks_def(void)
   snprintf(tasks[id].name, configMAX_TASK_NAME_LEN, "AI_START");
   tasks[id].function = ai_task_start;
   tasks[id].value = TASK_INIT_VALUE_START;
+  tasks[id].dest = &phys.exit_start;
+  tasks[id].dest_speed = WP_SPEED_VERY_SLOW;
+  tasks[id].dest_type = WP_GOTO_FWD;
 
 }
 
@@ -357,20 +372,97 @@ void ai_tasks_def(void)
 ********************************************************************************
 */
 
+// Destination of a task, transformed with the match color the same way than
+// the task motions (motion_move_block_on_avd(), ai_move_with_pf()) do, so
+// that the path-finder is given the point the robot will actually go to.
+// Returns false when the task has no destination.
+bool ai_get_task_dest(const task_t* task, int16_t* x, int16_t* y)
+{
+  if(task->dest == NULL)
+    return false;
+
+  *x = task->dest->x;
+  *y = task->dest->y;
+  phys_update_with_color_xy(x, y);
+
+  return true;
+}
+
+// Estimate the travel time from the robot to the destination of each valid
+// task, using a single multi-goal search per batch of PATH_MAX_GOALS tasks.
+// Tasks without destination get a null travel time, so does the START task:
+// it must be done first whatever the path-finder finds from the start area.
+void ai_compute_task_travel_times(void)
+{
+  task_t* task;
+  task_t* goal_tasks[PATH_MAX_GOALS];
+  poi_t goals[PATH_MAX_GOALS];
+  uint8_t nb_goals = 0;
+  uint8_t idx;
+  struct robot_pose pose;
+
+  motion_get_pose(&pose);
+
+  path_lock();
+
+  // A single search is done for all the tasks motions, rank them at
+  // normal speed
+  path_set_motion(WP_SPEED_NORMAL, WP_GOTO_FWD);
+  path_set_heading(pose.pos_s16.a);
+
+  for(task = tasks; task < tasks + TASKS_NB; task++) {
+
+    task->travel_ms = 0;
+
+    if(task_is_valid(task) && (task->id != TASK_ID_START) &&
+       ai_get_task_dest(task, &goals[nb_goals].x, &goals[nb_goals].y)) {
+      goal_tasks[nb_goals++] = task;
+    }
+
+    // Batch is full, or last task
+    if((nb_goals == PATH_MAX_GOALS) || ((task == tasks + TASKS_NB - 1) && (nb_goals > 0))) {
+
+      path_compute_travel_times(pose.pos_s16.x, pose.pos_s16.y, goals, nb_goals);
+
+      for(idx = 0; idx < nb_goals; idx++) {
+        goal_tasks[idx]->travel_ms = pf.goal_time_ms[idx];
+      }
+      nb_goals = 0;
+    }
+  }
+
+  path_unlock();
+}
+
 // Compute a task priority.
 // This function is one of the core of the decision algorithm.
 // For the given task, it'll look up on other tasks achievement state in order
 // to dynamically affect the importance of the task.
 // The priority can also depends on other factors such as remaining time,
 // opponent location and/or avoidance states.
+// Tasks having a destination are ranked on their value per second, the travel
+// time to all of them being found with a single path-finder search.
 void ai_compute_task_priorities(void)
 {
 
   task_t* task;
+  uint32_t priority;
+
+  // Estimate the travel time to the destination of each task
+  ai_compute_task_travel_times();
 
   for(task = tasks; task < tasks + TASKS_NB; task++) {
     if(task_is_valid(task)) {
 
+      // Destination cannot be reached (now), or not before the end of the match:
+      // the task is only done when nothing else can be, the path-finder may
+      // be wrong (obstacles moving, robot too close to one of them).
+      if((task->travel_ms == PATH_TIME_UNREACHABLE) ||
+         (match.timer_msec + task->travel_ms >= MATCH_DURATION_MSEC)) {
+        task->priority = TASK_PRIORITY_LOWEST;
+        continue;
+      }
+
       // Check for near end of match actions to perform.
       // Basically we have time to do only one last thing.
       if(match.timer_msec > 80000) {
@@ -422,7 +514,9 @@ void ai_compute_task_priorities(void)
       // Only affect the priority for tasks that have already tried a couple of
       // times to succeed (but get SUSPENDED)
       } else {
-        task->priority = (task->value) /* (task->trials + 1)*/; // avoid dividing by 0
+        // Value per second, the duration avoids dividing by 0
+        priority = (uint32_t) task->value * 1000 / (task->travel_ms + task->duration_ms) /* (task->trials + 1)*/;
+        task->priority = MAX(MIN(priority, TASK_PRIORITY_MAX), TASK_PRIORITY_LOWEST);
       }
 
     // Task is not valid
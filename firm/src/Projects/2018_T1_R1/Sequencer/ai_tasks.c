@@ -30,6 +30,7 @@ extern match_t match;
 extern robot_t robot;
 extern phys_t phys;
 extern path_t pf;
+extern task_mgt_t task_mgt;
 extern TaskHandle_t handle_task_avoidance;
 
 /**
@@ -48,21 +49,28 @@ extern TaskHandle_t handle_task_avoidance;
 // - Clear avoidance event
 // - Restart
 // - Loop until waypoint is reached
+// The task sleeps until the motion notifies that the waypoint is done, or
+// an avoidance event.
 void motion_move_block_on_avd(wp_t* wp)
 {
   TickType_t new_wake_time = xTaskGetTickCount();
+  uint32_t ticket;
+  bool added;
 
   // OS Software notifier
   BaseType_t notified;
   uint32_t sw_notification;
 
   phys_update_with_color_xy(&wp->coord.abs.x, &wp->coord.abs.y);
-  motion_add_new_wp(wp);
 
-  while(!motion_is_traj_done(wp))
+  motion_set_wp_done_task(xTaskGetCurrentTaskHandle());
+  added = (motion_add_new_wp(wp, &ticket) == pdPASS);
+
+  // Never wait for a waypoint rejected by a full queue
+  while(added && !motion_is_wp_done(ticket))
   {
     // Wait for potential new notification, this will unblock upon notification RX
-    notified = xTaskNotifyWait(0, UINT32_MAX, &sw_notification, pdMS_TO_TICKS(OS_AI_TASKS_PERIOD_MS));
+    notified = xTaskNotifyWait(0, UINT32_MAX, &sw_notification, portMAX_DELAY);
 
     // Check to see for avoidance event
     // This is normally handled by the ai_manage() function
@@ -78,87 +86,267 @@ void motion_move_block_on_avd(wp_t* wp)
       xTaskNotify(handle_task_avoidance, OS_NOTIFY_AVOIDANCE_CLR, eSetBits);
 
       // Re-go
-      motion_add_new_wp(wp);
+      added = (motion_add_new_wp(wp, &ticket) == pdPASS);
     }
   }
 
+  motion_set_wp_done_task(NULL);
 }
 
-BaseType_t ai_move_with_pf(wp_t* wp)
+// Find the path from the robot to the destination waypoint, with the
+// waypoint motion, and build the waypoints of its checkpoints.
+// The path-finder must be locked by the caller.
+// Returns the number of waypoints, PATH_RESULT_ERROR if there is no path.
+static int8_t ai_build_path_wps(const wp_t* dest_wp, wp_t* wps)
 {
-
-  uint8_t nb_checkpoints;
+  int8_t nb_checkpoints;
   uint8_t idx_checkpoint;
+  wp_t* checkpoint_wp;
+  struct robot_pose pose;
 
-  wp_t dest_wp;
-  wp_t checkpoint_wp;
+  motion_get_pose(&pose);
 
-  // Copy the destination waypoint so it can be re-used and we don't apply
-  // a second time the coordinate transform and we can modify it locally
-  // without consequences.
-  dest_wp = *wp;
+  // Paths are chosen on their travel time with the waypoint motion,
+  // from the current robot heading
+  path_set_motion(dest_wp->speed, dest_wp->type);
+  path_set_heading(pose.pos_s16.a);
 
-  DEBUG_INFO("Move AI with PF"DEBUG_EOL);
+  // Use the precomputed path between 2 POIs if it is still free,
+  // otherwise find it (from the results cache or by computing it).
+  nb_checkpoints = phys_get_poi_path(pose.pos_s16.x, pose.pos_s16.y,
+                                     dest_wp->coord.abs.x, dest_wp->coord.abs.y);
 
-  // Start
-  phys_update_with_color_xy(&dest_wp.coord.abs.x, &dest_wp.coord.abs.y);
-
-
-  path_set_objective(robot.cs.pos.pos_s16.x, robot.cs.pos.pos_s16.y, // Origin
-                     dest_wp.coord.abs.x, dest_wp.coord.abs.y);      // Destination
-
-  nb_checkpoints = path_process();
+  if(nb_checkpoints == PATH_RESULT_ERROR)
+  {
+    nb_checkpoints = path_find(pose.pos_s16.x, pose.pos_s16.y,                 // Origin
+                               dest_wp->coord.abs.x, dest_wp->coord.abs.y);    // Destination
+  }
 
   if(nb_checkpoints == PATH_RESULT_ERROR)
   {
     DEBUG_ERROR("[AI] Error while computing path!"DEBUG_EOL);
-    return pdFAIL;
+    return PATH_RESULT_ERROR;
   }
 
+  DEBUG_INFO("[AI] Path estimated to %lu ms"DEBUG_EOL, pf.est_time_ms);
+
   // Beginning of path display, also add current robot location
   DEBUG_INFO_NOPFX("[PHYS] [PATH] %d;%d ",
-      robot.cs.pos.pos_s16.x,
-      robot.cs.pos.pos_s16.y);
+      pose.pos_s16.x,
+      pose.pos_s16.y);
 
-  // Do actual motion sequence
   for(idx_checkpoint = 0; idx_checkpoint < nb_checkpoints; idx_checkpoint++)
   {
+    checkpoint_wp = &wps[idx_checkpoint];
+
     // For the last point use the desired offset & stop
     // Also, we use the original destination point as we want mm precision
     if(idx_checkpoint == nb_checkpoints - 1)
     {
-      checkpoint_wp.coord.abs = dest_wp.coord.abs;
-      checkpoint_wp.offset    = dest_wp.offset;
-      checkpoint_wp.trajectory_must_finish = dest_wp.trajectory_must_finish;
+      checkpoint_wp->coord.abs = dest_wp->coord.abs;
+      checkpoint_wp->offset    = dest_wp->offset;
+      checkpoint_wp->trajectory_must_finish = dest_wp->trajectory_must_finish;
 
     // For intermediate points:
     // - Offset is not taken into account
     // - No need to stop between points
     } else {
-      checkpoint_wp.coord.abs = pf.u.res[idx_checkpoint];
-      checkpoint_wp.offset = phys.offset_center;
-      checkpoint_wp.trajectory_must_finish = false;
+      checkpoint_wp->coord.abs = pf.u.res[idx_checkpoint];
+      checkpoint_wp->offset = phys.offset_center;
+      checkpoint_wp->trajectory_must_finish = false;
     }
 
     // Copy checkpoint speed and motion type for each checkpoint
-    checkpoint_wp.speed = dest_wp.speed;
-    checkpoint_wp.type = dest_wp.type;
-
-    // Finally add the checkpoint to the list.
-    // The waypoint is copied
-    motion_add_new_wp(&checkpoint_wp);
+    checkpoint_wp->speed = dest_wp->speed;
+    checkpoint_wp->type = dest_wp->type;
 
     // Print
     DEBUG_INFO_NOPFX("%d;%d ",
-                     checkpoint_wp.coord.abs.x,
-                     checkpoint_wp.coord.abs.y)
+                     checkpoint_wp->coord.abs.x,
+                     checkpoint_wp->coord.abs.y)
   }
 
   DEBUG_INFO_NOPFX(DEBUG_EOL);
 
+  return nb_checkpoints;
+}
+
+BaseType_t ai_move_with_pf(wp_t* wp)
+{
+
+  int8_t nb_checkpoints;
+  uint8_t idx_checkpoint;
+  ai_path_t* path = &task_mgt.path;
+
+  DEBUG_INFO("Move AI with PF"DEBUG_EOL);
+
+  // The result is read until the checkpoints are added, the planner task
+  // must not use the path-finder meanwhile. The followed path is also
+  // protected by this lock.
+  path_lock();
+
+  // Copy the destination waypoint so it can be re-used and we don't apply
+  // a second time the coordinate transform and we can modify it locally
+  // without consequences.
+  path->active = false;
+  path->dest = *wp;
+  phys_update_with_color_xy(&path->dest.coord.abs.x, &path->dest.coord.abs.y);
+
+  nb_checkpoints = ai_build_path_wps(&path->dest, path->checkpoints);
+
+  if(nb_checkpoints == PATH_RESULT_ERROR)
+  {
+    path_unlock();
+    return pdFAIL;
+  }
+
+  // Do actual motion sequence, the checkpoints are then checked by
+  // ai_check_path() until they are reached.
+  path->nb_checkpoints = nb_checkpoints;
+  path->active = true;
+
+  for(idx_checkpoint = 0; idx_checkpoint < nb_checkpoints; idx_checkpoint++)
+  {
+    // Finally add the checkpoint to the list.
+    // The waypoint is copied, the path starts at the ticket of the first one
+    motion_add_new_wp(&path->checkpoints[idx_checkpoint],
+                      idx_checkpoint ? NULL : &path->first_ticket);
+  }
+
+  path_unlock();
+
   return pdPASS;
 }
 
+// Returns true once the destination of the followed path is reached. The
+// path may have been replaced by ai_check_path() meanwhile.
+static bool ai_is_path_done(void)
+{
+  ai_path_t* path = &task_mgt.path;
+  bool done;
+
+  path_lock();
+  done = motion_is_wp_done(path->first_ticket + path->nb_checkpoints - 1);
+  path_unlock();
+
+  return done;
+}
+
+// Same as motion_move_block_on_avd(), with the path-finder: the path is
+// taken from the precomputed and cached ones (see planner.c) when possible.
+// Returns pdFAIL when no path is found.
+BaseType_t ai_move_with_pf_block_on_avd(wp_t* wp)
+{
+  TickType_t new_wake_time = xTaskGetTickCount();
+  BaseType_t ret;
+
+  // OS Software notifier
+  BaseType_t notified;
+  uint32_t sw_notification;
+
+  motion_set_wp_done_task(xTaskGetCurrentTaskHandle());
+  ret = ai_move_with_pf(wp);
+
+  while((ret == pdPASS) && !ai_is_path_done())
+  {
+    notified = xTaskNotifyWait(0, UINT32_MAX, &sw_notification, portMAX_DELAY);
+
+    if(notified && (sw_notification & OS_NOTIFY_AVOIDANCE_EVT))
+    {
+      DEBUG_INFO("Avoidance event!"DEBUG_EOL);
+
+      // Stop and wait 3 seconds
+      motion_clear_all_wp();
+      motion_traj_hard_stop();
+      vTaskDelayUntil( &new_wake_time, pdMS_TO_TICKS(3000));
+
+      // Clear avoidance state
+      xTaskNotify(handle_task_avoidance, OS_NOTIFY_AVOIDANCE_CLR, eSetBits);
+
+      // Re-go, from where the robot stopped
+      ret = ai_move_with_pf(wp);
+    }
+  }
+
+  motion_set_wp_done_task(NULL);
+
+  return ret;
+}
+
+// Check that the remaining part of the path followed by the last
+// ai_move_with_pf() is still free, called by ai_manage() when a dynamic
+// obstacle is updated (OS_NOTIFY_PATH_CHECK). Only the segments not reached
+// yet are checked: from the robot to the checkpoint it goes to, then to the
+// next ones.
+// If one of them is now blocked, a new path is found from the robot position
+// and replaces the queued waypoints without stopping.
+// Note: no sensor updates the robots positions during the match yet (the
+// avoidance does not compute the opponent position), so this is only run
+// once one does.
+void ai_check_path(void)
+{
+  ai_path_t* path = &task_mgt.path;
+  uint32_t ticket;
+  uint8_t idx_checkpoint = 0;
+  struct robot_pose pose;
+  int32_t x;
+  int32_t y;
+  int8_t nb_checkpoints;
+
+  motion_get_pose(&pose);
+  x = pose.pos_s16.x;
+  y = pose.pos_s16.y;
+
+  path_lock();
+
+  if(!path->active) {
+    path_unlock();
+    return;
+  }
+
+  // Checkpoints already reached (the ones before the current waypoint)
+  motion_get_current_wp_ticket(&ticket);
+  if((int32_t) (ticket - path->first_ticket) >= 0)
+    idx_checkpoint = MIN(ticket - path->first_ticket, path->nb_checkpoints);
+
+  // Path is finished
+  if(idx_checkpoint >= path->nb_checkpoints) {
+    path->active = false;
+    path_unlock();
+    return;
+  }
+
+  for(; idx_checkpoint < path->nb_checkpoints; idx_checkpoint++) {
+    if(!path_is_segment_free(x, y, path->checkpoints[idx_checkpoint].coord.abs.x,
+                                   path->checkpoints[idx_checkpoint].coord.abs.y))
+      break;
+    x = path->checkpoints[idx_checkpoint].coord.abs.x;
+    y = path->checkpoints[idx_checkpoint].coord.abs.y;
+  }
+
+  // Path is still free
+  if(idx_checkpoint >= path->nb_checkpoints) {
+    path_unlock();
+    return;
+  }
+
+  DEBUG_INFO("[AI] Checkpoint %u blocked, new path"DEBUG_EOL, idx_checkpoint);
+
+  nb_checkpoints = ai_build_path_wps(&path->dest, path->checkpoints);
+
+  // No way around: keep on the current path, the avoidance will handle it
+  if(nb_checkpoints == PATH_RESULT_ERROR) {
+    path->active = false;
+    path_unlock();
+    return;
+  }
+
+  path->nb_checkpoints = nb_checkpoints;
+  motion_replace_all_wp(path->checkpoints, nb_checkpoints, &path->first_ticket);
+
+  path_unlock();
+}
+
 /**
 ********************************************************************************
 **
@@ -232,9 +420,14 @@ void ai_task_start(void *params)
   // ------------------
 
   //avd_mask_all(false);
-  wp.type = WP_GOTO_FWD;
-  wp.coord.abs = phys.exit_start;
-  motion_move_block_on_avd(&wp);
+  wp.type = self->dest_type;
+  wp.speed = self->dest_speed;
+  wp.coord.abs = *self->dest;
+
+  // No path found (start pose too close to an obstacle for the path-finder):
+  // leave the start area straight, as before the path-finder was used here
+  if(ai_move_with_pf_block_on_avd(&wp) == pdFAIL)
+    motion_move_block_on_avd(&wp);
 
   // push home automation switch
   // ------------------------
@@ -36,25 +36,68 @@
 // Main path-finding container
 path_t pf;
 
+// Shared between the AI, the planner and the shell (see path_lock())
+static xSemaphoreHandle xPathMutex;
+
+// Build-time report of the capacities (path_config.h), the RAM they need is
+// checked against the budget taken from the allotment. Details are given by
+// path_mem_print().
+#define PATH_STR(x) #x
+#define PATH_XSTR(x) PATH_STR(x)
+#pragma message("Path-finder capacities: " PATH_XSTR(PATH_MAX_POINTS) " points, " \
+                PATH_XSTR(PATH_MAX_POLYS) " polygons, " PATH_XSTR(PATH_MAX_RAYS) " rays, " \
+                PATH_XSTR(PATH_MAX_CACHED_RAYS) " cached rays, RAM allotment " \
+                PATH_XSTR(PATH_RAM_ALLOTMENT) " bytes")
+_Static_assert(sizeof(path_t) <= PATH_RAM_BUDGET, "path_t exceeds PATH_RAM_BUDGET (path_config.h)");
+
 // -----------------------------------------------------------------------------
 // INITIALIZER
 // -----------------------------------------------------------------------------
 
 void path_init(void) {
 
+  uint8_t pt;
+
   // Cleanup
   memset(&pf, 0, sizeof(pf));
 
-  // Define a default objective and reserve memory for these 2 points
+  if(xPathMutex == NULL)
+    xPathMutex = xSemaphoreCreateMutex();
+
+  // Define a default objective and reserve memory for its points,
+  // a multi-goal search uses more than these 2 points
   pf.polys[0].pts = pf.pts;
-  pf.polys[0].n = 2;
   path_set_objective(0, 0, 100, 100);
+  for(pt = 0; pt < PATH_OBJECTIVE_POINTS; pt++) {
+    pf.pt_poly[pt] = 0;
+    pf.pt_idx[pt] = pt;
+  }
+
+  // Default motion model, without any initial rotation
+  path_set_motion(WP_SPEED_NORMAL, WP_GOTO_FWD);
+  path_set_heading(PATH_HEADING_NONE);
+
+  // Visibility graph by default, the grid is built on its first use
+  pf.backend = PATH_BACKEND_VISIBILITY;
+#if PATH_GRID_ENABLE
+  path_grid_invalidate();
+#endif
 
   // Default indexes
-  pf.cur_pt_idx = 2;
+  pf.cur_pt_idx = PATH_OBJECTIVE_POINTS;
   pf.cur_poly_idx = 1;
 }
 
+// The path-finder container is used by several OS tasks: the motion settings,
+// the search and the reading of its result must be done while holding the lock
+void path_lock(void) {
+  xSemaphoreTake(xPathMutex, portMAX_DELAY);
+}
+
+void path_unlock(void) {
+  xSemaphoreGive(xPathMutex);
+}
+
 // -----------------------------------------------------------------------------
 // STATIC AND USEFUL HANDLERS
 // -----------------------------------------------------------------------------
@@ -82,8 +125,8 @@ static int8_t prod_vect_sign(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
 }
 
 // Norm 2 of a vector
-static int32_t norm2_vect(int32_t x, int32_t y) {
-  return (int32_t) sqrt(x*x + y*y);
+static float norm2_vect(int32_t x, int32_t y) {
+  return sqrtf(x*x + y*y);
 }
 
 // Get the next point of a polygon from a given index in the list of points.
@@ -95,6 +138,152 @@ static uint8_t get_next_poly_pt(const path_poly_t* poly, uint8_t idx) {
     return idx+1;
 }
 
+// Get the index in the pts[] array of a polygon's point
+static path_pt_idx_t get_pt_global_idx(const path_poly_t* polys, uint8_t poly, uint8_t pt) {
+  return (path_pt_idx_t) (polys[poly].pts - pf.pts) + pt;
+}
+
+// Key of a search state in the A* heap: time from the start + time to the goal
+static int32_t path_state_key(path_state_t state) {
+  return pf.state_cost[state] + pf.heuristic[pf.adj_pt[state]];
+}
+
+// Swap 2 elements of the A* heap, keeping track of their positions
+static void path_heap_swap(path_state_t i, path_state_t j) {
+  path_state_t tmp = pf.heap[i];
+  pf.heap[i] = pf.heap[j];
+  pf.heap[j] = tmp;
+  pf.heap_pos[pf.heap[i]] = i;
+  pf.heap_pos[pf.heap[j]] = j;
+}
+
+// Move up an element of the A* heap until its parent has a smaller cost
+static void path_heap_up(path_state_t i) {
+  path_state_t parent;
+  while(i > 0) {
+    parent = (i-1) >> 1;
+    if(path_state_key(pf.heap[parent]) <= path_state_key(pf.heap[i]))
+      break;
+    path_heap_swap(i, parent);
+    i = parent;
+  }
+}
+
+// Insert a state into the A* heap
+static void path_heap_push(path_state_t state) {
+  pf.heap[pf.heap_n] = state;
+  pf.heap_pos[state] = pf.heap_n;
+  path_heap_up(pf.heap_n++);
+}
+
+// Remove and return the state of smallest cost from the A* heap.
+// Its cost is final, it is marked as closed.
+static path_state_t path_heap_pop(void) {
+  path_state_t top = pf.heap[0];
+  path_state_t i = 0;
+  path_state_t child;
+
+  pf.heap_n--;
+  pf.heap_pos[top] = PATH_HEAP_CLOSED;
+
+  if(pf.heap_n > 0) {
+    pf.heap[0] = pf.heap[pf.heap_n];
+    pf.heap_pos[pf.heap[0]] = 0;
+
+    // Move down the last element until both children have a larger cost
+    for(;;) {
+      child = 2*i + 1;
+      if(child >= pf.heap_n)
+        break;
+      if((child+1 < pf.heap_n) &&
+         (path_state_key(pf.heap[child+1]) < path_state_key(pf.heap[child])))
+        child++;
+      if(path_state_key(pf.heap[i]) <= path_state_key(pf.heap[child]))
+        break;
+      path_heap_swap(i, child);
+      i = child;
+    }
+  }
+
+  return top;
+}
+
+// Time (ms) needed by a quadramp to reach a consign from rest to rest.
+// Consign, speed and accelerations are in impulses and control periods,
+// the speed is not reached when the consign is too short (triangle profile).
+static uint32_t path_ramp_time(float consign, float speed, float accel_pos, float accel_neg) {
+
+  float periods;
+  float peak;
+
+  if(consign <= 0)
+    return 0;
+
+  if(consign >= speed * speed * (1/accel_pos + 1/accel_neg) / 2) {
+    periods = consign / speed + speed / (2*accel_pos) + speed / (2*accel_neg);
+  } else {
+    peak = sqrtf(2 * consign * accel_pos * accel_neg / (accel_pos + accel_neg));
+    periods = peak / accel_pos + peak / accel_neg;
+  }
+
+  return (uint32_t) (periods * OS_AVERSIVE_PERIOD_MS);
+}
+
+// Time (ms) to run a straight segment (mm)
+static uint32_t path_segment_time(float length) {
+  return path_ramp_time(length * PHYS_ROBOT_NB_IMP_PER_MM, pf.speed_d,
+                        PHYS_CS_D_QUAD_POS_ACCEL, PHYS_CS_D_QUAD_NEG_ACCEL);
+}
+
+// Time (ms) to turn in place from a travel direction to the next one.
+// The trajectory manager starts moving in distance when the angle error is
+// below its a_start window, so this part of the rotation is not charged.
+static uint32_t path_turn_time(float x1, float y1, float x2, float y2) {
+
+  float angle = atan2f(fabsf(x1 * y2 - y1 * x2), x1 * x2 + y1 * y2);
+  uint32_t time;
+
+  // Going backward is allowed: the robot only aligns on the travel line
+  if((pf.type == WP_GOTO_AUTO) && (angle > M_PI/2))
+    angle = M_PI - angle;
+
+  time = path_ramp_time(angle * PHYS_ROBOT_NB_IMP_PER_MM * PHYS_ROBOT_ENCODERS_TRACK_MM / 2,
+                        pf.speed_a, PHYS_CS_A_QUAD_POS_ACCEL, PHYS_CS_A_QUAD_NEG_ACCEL);
+
+  return (time > pf.turn_start_ms) ? time - pf.turn_start_ms : 0;
+}
+
+// Time (ms) to turn from the initial robot heading to the first travel direction
+static uint32_t path_start_turn_time(float x, float y) {
+
+  float heading;
+
+  if(pf.heading == PATH_HEADING_NONE)
+    return 0;
+
+  heading = pf.heading * (float) M_PI / 180;
+  if(pf.type == WP_GOTO_BWD)
+    heading += M_PI;
+
+  return path_turn_time(cosf(heading), sinf(heading), x, y);
+}
+
+// Update the bounding box of a polygon from its points
+static void path_poly_update_bbox(path_poly_t* poly) {
+
+  uint8_t idx;
+
+  poly->x_min = poly->x_max = poly->pts[0].x;
+  poly->y_min = poly->y_max = poly->pts[0].y;
+
+  for(idx = 1; idx < poly->n; idx++) {
+    poly->x_min = MIN(poly->x_min, poly->pts[idx].x);
+    poly->x_max = MAX(poly->x_max, poly->pts[idx].x);
+    poly->y_min = MIN(poly->y_min, poly->pts[idx].y);
+    poly->y_max = MAX(poly->y_max, poly->pts[idx].y);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // FUNCTIONS USED FOR DEFINING THE ALGORITHM INPUTS
 // -----------------------------------------------------------------------------
@@ -105,6 +294,7 @@ void path_set_objective(int32_t src_x, int32_t src_y, int32_t dst_x, int32_t dst
     uint16_t idx;
 
   // The 2 first points in the list are used for storing the destination.
+  pf.polys[0].n = 2;
   pf.pts[0].x = dst_x/10;
   pf.pts[0].y = dst_y/10;
   pf.pts[0].valid = PATH_DIJ_PT_NOT_VISITED;
@@ -114,6 +304,7 @@ void path_set_objective(int32_t src_x, int32_t src_y, int32_t dst_x, int32_t dst
   pf.pts[1].y = src_y/10;
   pf.pts[1].valid = PATH_DIJ_PT_NOT_VISITED;
   pf.pts[1].weight = 0;
+  pf.robot_pt = 1;
 
   // Re-init all dijkstra visited status
   for(idx = 0; idx < pf.cur_pt_idx; idx++) {
@@ -129,6 +320,8 @@ void path_set_objective(int32_t src_x, int32_t src_y, int32_t dst_x, int32_t dst
 // Return NULL if the structure is full and cannot add it.
 path_poly_t* path_add_new_poly(uint8_t nb_points) {
 
+  uint8_t pt;
+
   // Check to see if we are full
   if(  (pf.cur_pt_idx + nb_points > PATH_MAX_POINTS)
     || (pf.cur_poly_idx + 1 > PATH_MAX_POLYS)) {
@@ -138,18 +331,288 @@ path_poly_t* path_add_new_poly(uint8_t nb_points) {
   // If not, add it to record
   pf.polys[pf.cur_poly_idx].n = nb_points;
   pf.polys[pf.cur_poly_idx].pts = &pf.pts[pf.cur_pt_idx];
+  pf.polys[pf.cur_poly_idx].dirty = PATH_DIRTY_ALL;
+
+  // Owner of each point, for the rays given as indexes of the pts[] array
+  for(pt = 0; pt < nb_points; pt++) {
+    pf.pt_poly[pf.cur_pt_idx + pt] = pf.cur_poly_idx;
+    pf.pt_idx[pf.cur_pt_idx + pt] = pt;
+  }
   pf.cur_pt_idx += nb_points;
 
   return &pf.polys[pf.cur_poly_idx++];
 }
 
 
+// Create a new inflated polygon and add it into the structure.
+// Its nb_points true geometry points are set with path_poly_set_src_points(),
+// the path-finder uses them offset by margin (mm), with up to max_points
+// points (at least nb_points) for bevelling the corners.
+// Return NULL if the structure is full and cannot add it.
+path_poly_t* path_add_new_inflated_poly(uint8_t nb_points, uint8_t max_points, int16_t margin) {
+
+  path_poly_t* poly;
+
+  if((max_points < nb_points) || (pf.cur_src_idx + nb_points > PATH_MAX_SRC_POINTS))
+    return NULL;
+
+  poly = path_add_new_poly(max_points);
+  if(poly == NULL)
+    return NULL;
+
+  poly->src = &pf.src_pts[pf.cur_src_idx];
+  poly->src_n = nb_points;
+  poly->max_n = max_points;
+  poly->margin = margin;
+  poly->inflate = true;
+  pf.cur_src_idx += nb_points;
+
+  return poly;
+}
+
+// Set a true geometry point (mm) of an inflated polygon.
+// The polygon is inflated again before being used.
+void path_poly_set_src_points(path_poly_t* poly, uint8_t idx, int16_t x, int16_t y) {
+  poly->src[idx].x = x;
+  poly->src[idx].y = y;
+  poly->inflate = true;
+}
+
 // Add a point to a polygon
 void path_poly_set_points(path_poly_t* poly, uint8_t idx, int32_t x, int32_t y) {
   poly->pts[idx].x = x/10;
   poly->pts[idx].y = y/10;
   poly->pts[idx].valid = false;
   poly->pts[idx].weight = 0;
+  poly->dirty = PATH_DIRTY_ALL;
+  path_poly_update_bbox(poly);
+}
+
+// Define a polygon as static (fixed obstacle) or dynamic (robots).
+// Rays crossing a static polygon are dropped from the visibility-graph cache,
+// while the ones crossing a dynamic polygon are kept to be restored when it moves.
+// Polygons are dynamic by default.
+void path_poly_set_static(path_poly_t* poly, bool is_static) {
+
+  path_poly_mask_t mask = PATH_POLY_MASK(poly - pf.polys);
+
+  if(is_static)
+    pf.static_polys |= mask;
+  else
+    pf.static_polys &= ~mask;
+
+  pf.cache_valid = false;
+#if PATH_GRID_ENABLE
+  path_grid_invalidate();
+#endif
+}
+
+// Only take the static polygons into account (e.g. for computing paths on the
+// static map), dynamic polygons being ignored until this is disabled.
+void path_set_static_only(bool static_only) {
+  pf.static_only = static_only;
+}
+
+// Start a new obstacles epoch: paths of the results cache computed before
+// are not used anymore. Must be called when obstacles are moved.
+void path_new_epoch(void) {
+  pf.epoch++;
+}
+
+// Select the search used by path_process() (and so path_find()).
+// The multi-goal search always uses the visibility graph, which is also kept
+// when the grid backend is not built (PATH_GRID_ENABLE).
+void path_set_backend(path_backend_e backend) {
+#if !PATH_GRID_ENABLE
+  backend = PATH_BACKEND_VISIBILITY;
+#endif
+  if(backend != pf.backend) {
+    pf.backend = backend;
+    path_new_epoch();
+  }
+}
+
+// Define a soft-cost area around a position (mm) the robot should rather keep
+// away from, e.g. where an opponent is or is going to be (see path_hazard_t).
+// Its age is counted from now. Only the visibility graph search uses it, the
+// jump-point search of the grid backend needs uniform costs.
+void path_set_hazard(uint8_t idx, int32_t x, int32_t y, int16_t radius,
+                     uint16_t penalty_ms, uint32_t max_age_ms) {
+
+  if(idx >= PATH_MAX_HAZARDS)
+    return;
+
+  pf.hazards[idx].active = true;
+  pf.hazards[idx].x = x/10;
+  pf.hazards[idx].y = y/10;
+  pf.hazards[idx].radius = radius/10;
+  pf.hazards[idx].penalty_ms = penalty_ms;
+  pf.hazards[idx].max_age_ms = max_age_ms;
+  pf.hazards[idx].stamp = xTaskGetTickCount();
+}
+
+void path_clear_hazard(uint8_t idx) {
+  if(idx < PATH_MAX_HAZARDS)
+    pf.hazards[idx].active = false;
+}
+
+// Set the speed and motion type of the paths to find, used to estimate
+// their travel time (same speeds than the ones given to the waypoints).
+void path_set_motion(wp_speed_e speed, wp_type_e type) {
+
+  pf.speed = speed;
+  pf.type = type;
+
+  switch(speed) {
+    case WP_SPEED_FAST:
+      pf.speed_d = SPEED_FAST_D;
+      pf.speed_a = SPEED_FAST_A;
+      break;
+    case WP_SPEED_NORMAL:
+      pf.speed_d = SPEED_NORMAL_D;
+      pf.speed_a = SPEED_NORMAL_A;
+      break;
+    case WP_SPEED_SLOW:
+      pf.speed_d = SPEED_SLOW_D;
+      pf.speed_a = SPEED_SLOW_A;
+      break;
+    case WP_SPEED_VERY_SLOW:
+    default:
+      pf.speed_d = SPEED_VERY_SLOW_D;
+      pf.speed_a = SPEED_VERY_SLOW_A;
+      break;
+  }
+
+  // Rotation done before the robot starts moving in distance
+  pf.turn_start_ms = path_ramp_time(PHYS_TRAJ_DEFAULT_WIN_A_START_DEG * M_PI / 180 *
+                                    PHYS_ROBOT_NB_IMP_PER_MM * PHYS_ROBOT_ENCODERS_TRACK_MM / 2,
+                                    pf.speed_a, PHYS_CS_A_QUAD_POS_ACCEL, PHYS_CS_A_QUAD_NEG_ACCEL);
+}
+
+// Set the robot heading (deg) at the start point, the rotation from this
+// heading to the first checkpoint is charged to the paths.
+// Use PATH_HEADING_NONE when it does not matter.
+void path_set_heading(int16_t heading) {
+  pf.heading = heading;
+}
+
+// -----------------------------------------------------------------------------
+// POLYGONS INFLATION
+// -----------------------------------------------------------------------------
+
+// Direction (rad) of the outward normal of an inflated polygon edge,
+// from true geometry point idx to the next one
+static float path_inflate_normal(const path_poly_t* poly, uint8_t idx, bool ccw) {
+
+  uint8_t next = (idx + 1 == poly->src_n) ? 0 : idx + 1;
+  float dx = poly->src[next].x - poly->src[idx].x;
+  float dy = poly->src[next].y - poly->src[idx].y;
+
+  return ccw ? atan2f(-dx, dy) : atan2f(dx, -dy);
+}
+
+// Rotation (rad) of the outward normal at a corner of an inflated polygon,
+// positive for a counter-clockwise rotation. The normal of the edge before
+// the corner is also returned.
+static float path_inflate_turn(const path_poly_t* poly, uint8_t idx, bool ccw, float* normal) {
+
+  uint8_t prev = (idx == 0) ? poly->src_n - 1 : idx - 1;
+  float turn;
+
+  *normal = path_inflate_normal(poly, prev, ccw);
+  turn = path_inflate_normal(poly, idx, ccw) - *normal;
+
+  if(turn > M_PI)
+    turn -= 2 * M_PI;
+  else if(turn < -M_PI)
+    turn += 2 * M_PI;
+
+  return turn;
+}
+
+// Compute the points of an inflated polygon from its true geometry.
+// Each edge is moved outward by the margin, and the outline turns around each
+// convex corner with vertices every PATH_INFLATE_STEP_DEG at most (the segments
+// between them are tangent to the circle of the margin radius, so the clearance
+// is never smaller than the margin). Concave corners use the intersection of
+// the moved edges. When there are not enough points reserved, the corners with
+// the most vertices are bevelled with less.
+static void path_poly_inflate(path_poly_t* poly) {
+
+  uint8_t i;
+  uint8_t j;
+  uint8_t next;
+  uint8_t max_k;
+  uint8_t k[PATH_MAX_SRC_POINTS];
+  uint8_t nb_points = 0;
+  int32_t area = 0;
+  bool ccw;
+  float turn;
+  float normal;
+  float angle;
+  float radius;
+
+  // Orientation of the polygon, to know which side of the edges is outside
+  for(i = 0; i < poly->src_n; i++) {
+    next = (i + 1 == poly->src_n) ? 0 : i + 1;
+    area += (int32_t) poly->src[i].x * poly->src[next].y - (int32_t) poly->src[next].x * poly->src[i].y;
+  }
+  ccw = (area > 0);
+
+  // Number of vertices of each corner, a single one for concave corners
+  for(i = 0; i < poly->src_n; i++) {
+    turn = path_inflate_turn(poly, i, ccw, &normal);
+    k[i] = 1;
+
+    if((turn > 0) == ccw)
+      k[i] = (uint8_t) ceilf(fabsf(turn) * 180 / (float) M_PI / PATH_INFLATE_STEP_DEG - 0.001f);
+
+    if(k[i] == 0)
+      k[i] = 1;
+
+    nb_points += k[i];
+  }
+
+  // Not enough points: remove vertices from the most bevelled corners
+  while(nb_points > poly->max_n) {
+    max_k = 0;
+    for(i = 1; i < poly->src_n; i++) {
+      if(k[i] > k[max_k])
+        max_k = i;
+    }
+    k[max_k]--;
+    nb_points--;
+  }
+
+  // Vertices of the inflated outline: the outline segments are tangent to
+  // the margin circle in the middle of each step
+  poly->n = nb_points;
+  nb_points = 0;
+
+  for(i = 0; i < poly->src_n; i++) {
+    turn = path_inflate_turn(poly, i, ccw, &normal);
+    radius = poly->margin / cosf(turn / (2 * k[i]));
+
+    for(j = 0; j < k[i]; j++) {
+      angle = normal + turn * (2 * j + 1) / (2 * k[i]);
+      path_poly_set_points(poly, nb_points++,
+                           poly->src[i].x + (int32_t) (radius * cosf(angle)),
+                           poly->src[i].y + (int32_t) (radius * sinf(angle)));
+    }
+  }
+
+  poly->inflate = false;
+}
+
+// Inflate again the polygons whose true geometry changed
+void path_update_inflated_polys(void) {
+
+  uint8_t i;
+
+  for(i = 1; i < pf.cur_poly_idx; i++) {
+    if(pf.polys[i].src_n && pf.polys[i].inflate)
+      path_poly_inflate(&pf.polys[i]);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -364,6 +827,98 @@ path_pt_in_poly_e path_pt_is_in_poly(const path_proc_pt_t* p, const path_poly_t*
   }
 }
 
+// Orientation of the c point relatively to the [a;b] vector:
+// +1 on the left, -1 on the right, 0 when the 3 points are aligned.
+// Products are computed on 64 bits so the result is exact for any coordinates.
+static int8_t path_orient(const path_proc_pt_t* a, const path_proc_pt_t* b, const path_proc_pt_t* c) {
+  int64_t z = (int64_t) (b->x - a->x) * (c->y - a->y) - (int64_t) (b->y - a->y) * (c->x - a->x);
+  return z==0?0:(z>0?1:-1);
+}
+
+// Check to see if p, known to be aligned with the [a;b] segment, lies on it
+static bool path_aligned_pt_is_on_seg(const path_proc_pt_t* p,
+                                      const path_proc_pt_t* a, const path_proc_pt_t* b) {
+  return p->x >= MIN(a->x, b->x) && p->x <= MAX(a->x, b->x) &&
+         p->y >= MIN(a->y, b->y) && p->y <= MAX(a->y, b->y);
+}
+
+// Returns the crossing status of 2 segments delimited by [s1;s2] and [t1;t2].
+// Same classification than path_intersect_segment(), but only based on exact
+// orientation tests: no line coefficients, no division and no rounding.
+// The crossing point is not computed.
+path_seg_cross_e path_orient_segments(const path_proc_pt_t* s1, const path_proc_pt_t* s2,
+                                      const path_proc_pt_t* t1, const path_proc_pt_t* t2) {
+
+  int8_t o1;
+  int8_t o2;
+  int8_t o3;
+  int8_t o4;
+
+  // Dummy segments
+  if((s1->x == s2->x && s1->y == s2->y) || (t1->x == t2->x && t1->y == t2->y))
+    return PATH_SEG_NO_CROSS;
+
+  // Orientations of each segment's boundaries relatively to the other segment
+  o1 = path_orient(t1, t2, s1);
+  o2 = path_orient(t1, t2, s2);
+  o3 = path_orient(s1, s2, t1);
+  o4 = path_orient(s1, s2, t2);
+
+  // Segments are on the same line: they cross if one of the [t1;t2]
+  // boundaries is on the [s1;s2] segment
+  if(o1 == 0 && o2 == 0) {
+    if(path_aligned_pt_is_on_seg(t1, s1, s2) || path_aligned_pt_is_on_seg(t2, s1, s2))
+      return PATH_SEG_PARALLEL_CROSS;
+    return PATH_SEG_NO_CROSS;
+  }
+
+  // Both boundaries of a segment are on the same side of the other one
+  // (this includes parallel segments)
+  if(o1 * o2 > 0 || o3 * o4 > 0)
+    return PATH_SEG_NO_CROSS;
+
+  // A boundary is on the other segment
+  if(o1 == 0 || o2 == 0 || o3 == 0 || o4 == 0)
+    return PATH_SEG_CROSS_POINT;
+
+  return PATH_SEG_CROSS;
+}
+
+// Check to see if a point is inside a convex polygon.
+// Same classification than path_pt_is_in_poly(), but a point aligned with an
+// edge and out of it is considered outside (not on edge).
+path_pt_in_poly_e path_orient_pt_in_poly(const path_proc_pt_t* p, const path_poly_t* poly) {
+
+  uint8_t i;
+  uint8_t j;
+  int8_t z;
+  int8_t z_max = -1;
+  int8_t z_min = +1;
+
+  for(i = 0; i < poly->n; i++) {
+
+    j = get_next_poly_pt(poly, i);
+
+    // To be inside of a polygon, p must be on the same side of all edges
+    z = path_orient(&poly->pts[i], &poly->pts[j], p);
+
+    if(z == 0) {
+      if(path_aligned_pt_is_on_seg(p, &poly->pts[i], &poly->pts[j]))
+        return PATH_PT_POLY_ON_EDGE;
+      else
+        return PATH_PT_POLY_OUTSIDE;
+    }
+
+    z_min = MIN(z_min, z);
+    z_max = MAX(z_max, z);
+  } // for i
+
+  if(z_min != z_max)
+    return PATH_PT_POLY_OUTSIDE;
+  else
+    return PATH_PT_POLY_INSIDE;
+}
+
 // Check to see if a segment crosses a polygon (including edges)
 path_seg_cross_poly_e path_seg_is_crossing_poly(path_proc_pt_t p1,
                                                 path_proc_pt_t p2,
@@ -372,10 +927,23 @@ path_seg_cross_poly_e path_seg_is_crossing_poly(path_proc_pt_t p1,
   path_pt_in_poly_e ret1;
   path_pt_in_poly_e ret2;
   path_seg_cross_poly_e ret;
-  path_proc_pt_t p;
   uint8_t i;
   uint8_t j;
   uint8_t cnt = 0;
+  int32_t x_min = MIN(p1.x, p2.x);
+  int32_t x_max = MAX(p1.x, p2.x);
+  int32_t y_min = MIN(p1.y, p2.y);
+  int32_t y_max = MAX(p1.y, p2.y);
+
+  pf.nb_poly_tests++;
+
+  // The segment cannot reach the polygon if their bounding boxes don't overlap.
+  // Boxes sharing a side are not culled, so touching cases are still reported.
+  if(x_max < poly->x_min || x_min > poly->x_max ||
+     y_max < poly->y_min || y_min > poly->y_max) {
+    pf.nb_poly_culled++;
+    return PATH_SEG_POLY_NO_CROSS;
+  }
 
   // Go through all polygon's segment and check if it intersects with the given segment
   for(i = 0; i < poly->n; i++) {
@@ -383,7 +951,12 @@ path_seg_cross_poly_e path_seg_is_crossing_poly(path_proc_pt_t p1,
     // Get the index of the next point.
     j = get_next_poly_pt(poly, i);
 
-    ret = path_intersect_segment(&p1, &p2, &(poly->pts[i]), &(poly->pts[j]), &p);
+    // Same thing for the polygon's segment: no line math if out of reach
+    if(x_max < MIN(poly->pts[i].x, poly->pts[j].x) || x_min > MAX(poly->pts[i].x, poly->pts[j].x) ||
+       y_max < MIN(poly->pts[i].y, poly->pts[j].y) || y_min > MAX(poly->pts[i].y, poly->pts[j].y))
+      continue;
+
+    ret = path_orient_segments(&p1, &p2, &(poly->pts[i]), &(poly->pts[j]));
 
     switch(ret) {
 
@@ -421,8 +994,8 @@ path_seg_cross_poly_e path_seg_is_crossing_poly(path_proc_pt_t p1,
 
   // For other cases we need to know if the segment's boundaries are
   // inside or outside the polygon.
-  ret1 = path_pt_is_in_poly(&p1, poly);
-  ret2 = path_pt_is_in_poly(&p2, poly);
+  ret1 = path_orient_pt_in_poly(&p1, poly);
+  ret2 = path_orient_pt_in_poly(&p2, poly);
 
   // If at least one of the point is inside the polygon,
   // then the segment cross it.
@@ -456,243 +1029,717 @@ path_seg_cross_poly_e path_seg_is_crossing_poly(path_proc_pt_t p1,
 // MAIN ALGORITHM PROCESSING FUNCTIONS
 // -----------------------------------------------------------------------------
 
+// Returns the mask of the polygons (among the given mask) crossed by the
+// [p1;p2] segment. The skip polygon is not checked, which is used for the edges
+// of a polygon. Stops as soon as one of the polygons of the stop mask is found.
+static path_poly_mask_t path_get_ray_blockers(const path_proc_pt_t* p1, const path_proc_pt_t* p2,
+                                              path_poly_mask_t mask, uint8_t skip,
+                                              path_poly_mask_t stop) {
+
+  uint8_t idx;
+  path_poly_mask_t blockers = 0;
+
+  for(idx = 1; idx < pf.cur_poly_idx; idx++) {
+
+    if((idx == skip) || !(mask & PATH_POLY_MASK(idx)))
+      continue;
+
+    if(path_seg_is_crossing_poly(*p1, *p2, &pf.polys[idx]) == PATH_SEG_POLY_CROSS) {
+      blockers |= PATH_POLY_MASK(idx);
+      if(blockers & stop)
+        break;
+    }
+  } // for(idx)
+
+  return blockers;
+}
+
+// Check to see if the segment between 2 points (in mm) is free,
+// i.e. it doesn't cross any of the polygons taken into account.
+bool path_is_segment_free(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+
+  path_proc_pt_t p1;
+  path_proc_pt_t p2;
+
+  path_update_inflated_polys();
+
+  p1.x = x1/10;
+  p1.y = y1/10;
+  p2.x = x2/10;
+  p2.y = y2/10;
+
+  return !path_get_ray_blockers(&p1, &p2, pf.static_only ? pf.static_polys : PATH_POLY_ALL, 0, PATH_POLY_ALL);
+}
+
+// Add a candidate ray into the visibility-graph cache,
+// unless it is crossing a static polygon.
+static void path_cache_add_ray(path_pt_idx_t pt1, path_pt_idx_t pt2) {
+
+  path_cached_ray_t* ray;
+  path_poly_mask_t blockers;
+  uint8_t poly = pf.pt_poly[pt1];
+
+  // Polygon edges are not checked against their own polygon
+  blockers = path_get_ray_blockers(&pf.pts[pt1], &pf.pts[pt2], PATH_POLY_ALL,
+                                   (poly == pf.pt_poly[pt2]) ? poly : 0, pf.static_polys);
+
+  if(blockers & pf.static_polys)
+    return;
+
+  if(pf.nb_cached_rays >= PATH_MAX_CACHED_RAYS) {
+    DEBUG_INFO("[PATH] Rays cache is full"DEBUG_EOL);
+    return;
+  }
+
+  ray = &pf.cache[pf.nb_cached_rays++];
+  ray->ray.pt1 = pt1;
+  ray->ray.pt2 = pt2;
+  ray->blockers = blockers;
+}
+
+// Add all the candidate rays of a polygon into the cache: its edges and the
+// rays toward the vertices of the polygons given in the mask.
+static void path_cache_add_poly(uint8_t poly, path_poly_mask_t mask) {
+
+  const path_poly_t* p = &pf.polys[poly];
+  uint8_t pt1;
+  uint8_t pt2;
+  uint8_t j;
+  uint8_t k;
+
+  for(pt1 = 0; pt1 < p->n; pt1++) {
+
+    // If a given point of a polygon is not in the playground, no rays is computed form it
+    if(!PATH_IS_IN_PLAYGROUND(p->pts[pt1]))
+      continue;
+
+    // Inner polygon ray (edge).
+    // This is useful only in case of overlaping polygons
+    k = get_next_poly_pt(p, pt1);
+    if(PATH_IS_IN_PLAYGROUND(p->pts[k]))
+      path_cache_add_ray(get_pt_global_idx(pf.polys, poly, pt1), get_pt_global_idx(pf.polys, poly, k));
+
+    // Inter-polygon rays
+    for(j = 1; j < pf.cur_poly_idx; j++) {
+
+      if(!(mask & PATH_POLY_MASK(j)))
+        continue;
+
+      for(pt2 = 0; pt2 < pf.polys[j].n; pt2++) {
+        if(PATH_IS_IN_PLAYGROUND(pf.polys[j].pts[pt2]))
+          path_cache_add_ray(get_pt_global_idx(pf.polys, poly, pt1), get_pt_global_idx(pf.polys, j, pt2));
+      }
+    } // for(j)
+  } // for(pt1)
+}
+
+// Update the visibility-graph cache of the obstacles (all polygons but the
+// objective). Only the polygons whose points changed since the last update are
+// handled: their own rays are recomputed and the other cached rays are only
+// checked against them. A change on a static polygon triggers a full rebuild.
+void path_update_rays_cache(void) {
+
+  uint8_t i;
+  uint16_t idx;
+  uint16_t n = 0;
+  uint8_t poly1;
+  uint8_t poly2;
+  path_poly_mask_t dirty = 0;
+  path_poly_mask_t done = 0;
+  path_cached_ray_t* ray;
+
+  path_update_inflated_polys();
+
+  // Collect (and acknowledge) the moved polygons
+  for(i = 1; i < pf.cur_poly_idx; i++) {
+    if(pf.polys[i].dirty & PATH_DIRTY_RAYS) {
+      dirty |= PATH_POLY_MASK(i);
+      pf.polys[i].dirty &= ~PATH_DIRTY_RAYS;
+    }
+  }
+
+  // Full rebuild
+  if(!pf.cache_valid || (dirty & pf.static_polys)) {
+
+    pf.nb_cached_rays = 0;
+
+    // Polygons from 1 to i were already paired with polygon i
+    for(i = 1; i < pf.cur_poly_idx; i++) {
+      path_cache_add_poly(i, ~((PATH_POLY_MASK(i) << 1) - 1));
+    }
+
+    pf.cache_valid = true;
+    DEBUG_TRACE("[PATH] Rays cache rebuilt: %u rays"DEBUG_EOL, pf.nb_cached_rays);
+    return;
+  }
+
+  if(!dirty)
+    return;
+
+  // Drop the rays of the moved polygons and check the others against them
+  for(idx = 0; idx < pf.nb_cached_rays; idx++) {
+
+    ray = &pf.cache[idx];
+    poly1 = pf.pt_poly[ray->ray.pt1];
+    poly2 = pf.pt_poly[ray->ray.pt2];
+
+    if(dirty & (PATH_POLY_MASK(poly1) | PATH_POLY_MASK(poly2)))
+      continue;
+
+    ray->blockers &= ~dirty;
+    ray->blockers |= path_get_ray_blockers(&pf.pts[ray->ray.pt1], &pf.pts[ray->ray.pt2],
+                                           dirty, (poly1 == poly2) ? poly1 : 0, 0);
+    pf.cache[n++] = *ray;
+  }
+  pf.nb_cached_rays = n;
+
+  // Recompute the rays of the moved polygons.
+  // Rays between 2 moved polygons are only added once.
+  for(i = 1; i < pf.cur_poly_idx; i++) {
+    if(dirty & PATH_POLY_MASK(i)) {
+      done |= PATH_POLY_MASK(i);
+      path_cache_add_poly(i, ~done);
+    }
+  }
+
+  DEBUG_TRACE("[PATH] Rays cache updated: %u rays"DEBUG_EOL, pf.nb_cached_rays);
+}
+
+// Returns the mask of the polygons (among the given mask) a point is inside of
+static path_poly_mask_t path_get_enclosing_polys(const path_proc_pt_t* p, path_poly_mask_t mask) {
+
+  uint8_t idx;
+  path_poly_mask_t enclosing = 0;
+
+  for(idx = 1; idx < pf.cur_poly_idx; idx++) {
+    if((mask & PATH_POLY_MASK(idx)) &&
+       (path_orient_pt_in_poly(p, &pf.polys[idx]) == PATH_PT_POLY_INSIDE))
+      enclosing |= PATH_POLY_MASK(idx);
+  }
+
+  return enclosing;
+}
+
+// The robot may stand inside polygons, when it is closer to an obstacle than
+// the inflation margin (e.g. next to the teammate in the start area): all its
+// rays are then crossing them. Add the ray leaving them from the robot point,
+// toward the nearest of their vertices which is not hidden by another polygon.
+// Returns the new number of rays.
+static uint16_t path_compute_escape_ray(path_poly_t* polys, uint8_t n_polys,
+                                        path_poly_mask_t mask, path_ray_t* rays, uint16_t ray_n) {
+
+  const path_proc_pt_t* robot = &polys[0].pts[pf.robot_pt];
+  const path_proc_pt_t* pt;
+  path_poly_mask_t enclosing;
+  uint8_t j;
+  uint8_t k;
+  int32_t dist;
+  int32_t best_dist = INT32_MAX;
+  path_pt_idx_t best = 0;
+
+  enclosing = path_get_enclosing_polys(robot, mask);
+
+  if(!enclosing || (ray_n >= PATH_MAX_RAYS))
+    return ray_n;
+
+  for(j = 1; j < n_polys; j++) {
+
+    if(!(enclosing & PATH_POLY_MASK(j)))
+      continue;
+
+    for(k = 0; k < polys[j].n; k++) {
+
+      pt = &polys[j].pts[k];
+      dist = (pt->x - robot->x) * (pt->x - robot->x) + (pt->y - robot->y) * (pt->y - robot->y);
+
+      if(!PATH_IS_IN_PLAYGROUND(*pt) || (dist >= best_dist))
+        continue;
+
+      // The vertex must be out of the other polygons, and in sight
+      if(path_get_enclosing_polys(pt, enclosing & ~PATH_POLY_MASK(j)) ||
+         path_get_ray_blockers(robot, pt, mask & ~enclosing, 0, PATH_POLY_ALL))
+        continue;
+
+      best_dist = dist;
+      best = get_pt_global_idx(polys, j, k);
+    }
+  }
+
+  if(best_dist == INT32_MAX)
+    return ray_n;
+
+  rays[ray_n].pt1 = get_pt_global_idx(polys, 0, pf.robot_pt);
+  rays[ray_n].pt2 = best;
+  DEBUG_TRACE("Escape Ray #%u"DEBUG_EOL, ray_n + 1);
+
+  return ray_n + 1;
+}
+
 // Compute the "visibility rays" algorithm, given the list of polygons.
-// The rays array is composed of indexes representing 2 polygon vertices that
-// can "see" each others:
-//
-//  i  : the first polygon number in the input polygon list
-//  i+1: the vertex index of this polygon (vertex 1)
-//  i+2: the second polygon number in the input polygon list
-//  i+3: the vertex index of this polygon (vertex 2)
-//
-//  Here, vertex 1 can "see" vertex 2 in our visibility graph
+// The rays array is composed of pairs of vertices (indexes of the pts[] array)
+// that can "see" each others.
 //
 //  As the first polygon is not a real polygon but the start/stop
 //  point, the polygon is NOT an ocluding polygon (but its vertices
 //  are used to compute visibility to start/stop points)
 //
-// Returns the "i" value corresponding to 4x the number of rays found.
-uint16_t path_compute_rays(path_poly_t* polys, uint8_t n_polys, uint8_t* rays) {
+// Rays between obstacles come from the visibility-graph cache (which is updated
+// first), only the rays of the start/stop points are computed here. A robot
+// standing inside a polygon gets a single ray out of it.
+// Returns the number of rays found.
+uint16_t path_compute_rays(path_poly_t* polys, uint8_t n_polys, path_ray_t* rays) {
 
-  uint8_t i;
   uint8_t j;
-  uint8_t k;
-  uint8_t idx;
-  uint16_t ray_n = 0;
-  bool is_ok;
   uint8_t pt1;
   uint8_t pt2;
-  path_seg_cross_poly_e seg_crossing_poly;
+  uint16_t idx;
+  uint16_t ray_n = 0;
+  path_poly_mask_t mask;
+  const path_cached_ray_t* ray;
 
   // Warning: First poly is the starting point
 
+  path_update_rays_cache();
+
+  // Polygons taken into account
+  mask = pf.static_only ? pf.static_polys : PATH_POLY_ALL;
+
   // Pass #1
-  // Compute the inner polygon rays:
-  // For each polygon edge, if the vertices can see each others.
-  // This is useful only in case of overlaping polygons
-  for(i = 0; i < n_polys; i++) {
-    for(j = 0; j < polys[i].n; j++) {
-
-      // Get the index of the next point.
-      k = get_next_poly_pt(&polys[i], j);
-
-      // If one of the polygon's point is not in the playground,
-      // it's no use to compute rays to this point (they are invalid)
-      if(!PATH_IS_IN_PLAYGROUND(polys[i].pts[j]))
+  // Obstacle rays which are not crossed by any polygon
+  for(idx = 0; idx < pf.nb_cached_rays; idx++) {
+
+    ray = &pf.cache[idx];
+
+    if(ray->blockers & mask)
+      continue;
+
+    // Vertices of ignored polygons are not part of the graph
+    if(!(mask & PATH_POLY_MASK(pf.pt_poly[ray->ray.pt1])) ||
+       !(mask & PATH_POLY_MASK(pf.pt_poly[ray->ray.pt2])))
+      continue;
+
+    if(ray_n >= PATH_MAX_RAYS)
+      return ray_n;
+
+    rays[ray_n++] = ray->ray;
+  }
+
+  // Pass #2
+  // Compute the start/stop points rays
+  for(pt1 = 0; pt1 < polys[0].n; pt1++) {
+
+    if(!PATH_IS_IN_PLAYGROUND(polys[0].pts[pt1]))
+      continue;
+
+    // Start to stop rays (to each goal for a multi-goal search), checked once
+    for(pt2 = 1; (pt1 == 0) && (pt2 < polys[0].n); pt2++) {
+
+      if(!PATH_IS_IN_PLAYGROUND(polys[0].pts[pt2]) ||
+         path_get_ray_blockers(&polys[0].pts[0], &polys[0].pts[pt2], mask, 0, PATH_POLY_ALL))
         continue;
 
-      if(!PATH_IS_IN_PLAYGROUND(polys[i].pts[k]))
+      if(ray_n >= PATH_MAX_RAYS)
+        return ray_n;
+
+      rays[ray_n].pt1 = get_pt_global_idx(polys, 0, 0);
+      rays[ray_n].pt2 = get_pt_global_idx(polys, 0, pt2);
+      ray_n++;
+      DEBUG_TRACE("Objective Ray #%u"DEBUG_EOL, ray_n);
+    }
+
+    for(j = 1; j < n_polys; j++) {
+
+      if(!(mask & PATH_POLY_MASK(j)))
         continue;
 
-      // Check to see if the current ray crosses the polygon
-      is_ok = true;
-      for(idx = 1; idx < n_polys; idx++) {
+      for(pt2 = 0; pt2 < polys[j].n; pt2++) {
 
-        // Don't check polygon against itself
-        if(idx == i)
+        if(!PATH_IS_IN_PLAYGROUND(polys[j].pts[pt2]))
           continue;
 
-        seg_crossing_poly = path_seg_is_crossing_poly(polys[i].pts[j], polys[i].pts[k], &polys[idx]);
+        // Test if the [pt1;pt2] segment crosses a polygon
+        if(path_get_ray_blockers(&polys[0].pts[pt1], &polys[j].pts[pt2], mask, 0, PATH_POLY_ALL))
+          continue;
 
-        if(seg_crossing_poly == PATH_SEG_POLY_CROSS) {
-          is_ok = false;
-          break;
-        }
-      } // for(idx)
-
-      // If rays doesn't cross the polygon, add it
-      if(is_ok) {
-        rays[ray_n++] = i;
-        rays[ray_n++] = j;
-        rays[ray_n++] = i;
-        rays[ray_n++] = k;
-        DEBUG_TRACE("Inner Ray #%u : %d"DEBUG_EOL, ray_n>>2, seg_crossing_poly);
-      }
+        if(ray_n >= PATH_MAX_RAYS)
+          return ray_n;
+
+        rays[ray_n].pt1 = get_pt_global_idx(polys, 0, pt1);
+        rays[ray_n].pt2 = get_pt_global_idx(polys, j, pt2);
+        ray_n++;
+        DEBUG_TRACE("Inter-Ray #%u"DEBUG_EOL, ray_n);
+      } // for(pt2)
     } // for(j)
-  } // for(i)
+  } // for(pt1)
 
-  // Pass #2
-  // Compute inter-polygon rays
-  for(i = 0; i < n_polys-1; i++) {
-    for(pt1 = 0; pt1 < polys[i].n ; pt1++) {
+  // Pass #3
+  // Leave the polygons the robot stands in
+  return path_compute_escape_ray(polys, n_polys, mask, rays, ray_n);
 
-      // If a given point of a polygon is not in the playground, no rays is computed form it
-      if(!PATH_IS_IN_PLAYGROUND(polys[i].pts[pt1]))
-        continue;
+}
+
+// Penalty (ms) of each hazard at its center, faded with the age of its
+// position. Returns false when no hazard is to be taken into account.
+static bool path_hazards_penalty(float* penalty) {
+
+  uint8_t idx;
+  TickType_t age;
+  TickType_t max_age;
+  bool any = false;
 
-      // Sweep other polygons.
-      // Polygons from 0 to i were already checked
-      for(j = i+1; j < n_polys; j++) {
-        for(pt2 = 0; pt2 < polys[j].n; pt2++) {
+  for(idx = 0; idx < PATH_MAX_HAZARDS; idx++) {
 
-          // Same thing
-          if(!PATH_IS_IN_PLAYGROUND(polys[j].pts[pt2]))
-            continue;
+    penalty[idx] = 0;
 
-          // Test if the [pt1;pt2] segment crosses a polygon
-          is_ok = true;
-          for(idx = 1; idx < n_polys; idx++) {
-            seg_crossing_poly = path_seg_is_crossing_poly(polys[i].pts[pt1], polys[j].pts[pt2], &polys[idx]);
+    if(!pf.hazards[idx].active || pf.static_only)
+      continue;
 
-            if(seg_crossing_poly == PATH_SEG_POLY_CROSS) {
-              is_ok = false;
-              break;
-            }
-          } // for(idx)
+    age = xTaskGetTickCount() - pf.hazards[idx].stamp;
+    max_age = pdMS_TO_TICKS(pf.hazards[idx].max_age_ms);
+    if(age >= max_age)
+      continue;
 
-          // If not crossed, add it
-          if(is_ok) {
-            rays[ray_n++] = i;
-            rays[ray_n++] = pt1;
-            rays[ray_n++] = j;
-            rays[ray_n++] = pt2;
-            DEBUG_TRACE("Inter-Ray #%u : %d"DEBUG_EOL, ray_n>>2, seg_crossing_poly);
-          }
+    penalty[idx] = pf.hazards[idx].penalty_ms * (1.0f - (float) age / max_age);
+    any = true;
+  }
+
+  return any;
+}
 
-        } // for(pt2)
-      } // for(j)
-    } // for(pt1)
-  } // for(i)
+// Soft cost (ms) of a ray passing near the hazards, from their faded penalty:
+// it decreases linearly with the distance between the ray and their center.
+static uint32_t path_ray_hazards_cost(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+                                      const float* penalty) {
 
-  return ray_n;
+  uint8_t idx;
+  int32_t dx = x2 - x1;
+  int32_t dy = y2 - y1;
+  int32_t len2 = dx * dx + dy * dy;
+  int32_t hx;
+  int32_t hy;
+  float t;
+  float ex;
+  float ey;
+  float dist;
+  float cost = 0;
+
+  for(idx = 0; idx < PATH_MAX_HAZARDS; idx++) {
+
+    if(penalty[idx] <= 0)
+      continue;
+
+    // Closest point of the ray to the center
+    hx = pf.hazards[idx].x - x1;
+    hy = pf.hazards[idx].y - y1;
+    t = (len2 > 0) ? (float) prod_scal(hx, hy, dx, dy) / len2 : 0;
+    t = MIN(1.0f, MAX(0.0f, t));
+    ex = hx - t * dx;
+    ey = hy - t * dy;
+    dist = sqrtf(ex * ex + ey * ey);
+
+    if(dist < pf.hazards[idx].radius)
+      cost += penalty[idx] * (1.0f - dist / pf.hazards[idx].radius);
+  }
 
+  return (uint32_t) cost;
 }
 
 // Compute the weight of all rays.
-// The weighting function used here is the distance.
-void path_compute_rays_weight(const path_poly_t* polys, const uint8_t* rays, uint16_t ray_n,
-                              uint16_t* weight) {
+// The weighting function used here is the time (ms) to run the ray, rotations
+// at the checkpoints are charged by the search.
+// Rays passing near a hazard are charged its soft cost on top, so that the
+// search prefers keeping away from the opponents when it does not cost more.
+// It is not part of the estimated travel time of the result, but it is part of
+// the multi-goal search times (tasks close to an opponent are less attractive).
+void path_compute_rays_weight(const path_ray_t* rays, uint16_t ray_n, uint16_t* weight) {
 
   uint16_t i;
   int32_t x1, x2, y1, y2;
+  uint32_t time;
+  float penalty[PATH_MAX_HAZARDS];
+  bool hazards;
 
-  int32_t norm2;
+  float norm2;
 
-  for(i = 0; i < ray_n; i+=4) {
+  hazards = path_hazards_penalty(penalty);
 
-    x1 = polys[rays[i]].pts[rays[i+1]].x;
-    x2 = polys[rays[i+2]].pts[rays[i+3]].x;
-    y1 = polys[rays[i]].pts[rays[i+1]].y;
-    y2 = polys[rays[i+2]].pts[rays[i+3]].y;
+  for(i = 0; i < ray_n; i++) {
+
+    x1 = pf.pts[rays[i].pt1].x;
+    x2 = pf.pts[rays[i].pt2].x;
+    y1 = pf.pts[rays[i].pt1].y;
+    y2 = pf.pts[rays[i].pt2].y;
 
     norm2 = norm2_vect(x1 - x2, y1 - y2);
 
-    weight[i>>2] = norm2 + 1;
+    time = path_segment_time(10 * norm2) + 1;
+
+    if(hazards)
+      time += path_ray_hazards_cost(x1, y1, x2, y2, penalty);
+
+    weight[i] = MIN(time, UINT16_MAX);
 
     // Display Ray infos
     DEBUG_INFO_NOPFX("[PHYS] [RAY] %d %d;%d %d;%d"DEBUG_EOL,
-        weight[i>>2],
+        weight[i],
         10*x1, 10*y1,
         10*x2, 10*y2);
   }
 }
 
 
-// Iterative Dijkstra algorithm used for finding the shortest path
-// The valid field of a proc_pt is used to determine:
-// - If the point was not visited yet (no weight affected)
-// - The point has been visited and its weight is correct
-// - The point must be visited (the point is part of the solution path)
+// Build the adjacency lists of the visibility graph from the rays array,
+// so the search can walk the neighbours of a point without sweeping all rays.
+// Each ray is stored twice, once for each of its end points.
+void path_compute_adjacency(const path_ray_t* rays, uint16_t ray_n) {
+
+  uint16_t i;
+  path_pt_idx_t g1;
+  path_pt_idx_t g2;
+  path_pt_idx_t nb_pts = pf.cur_pt_idx;
+
+  // Count the number of rays of each point
+  memset(pf.adj_first, 0, sizeof(pf.adj_first));
+  for(i = 0; i < ray_n; i++) {
+    pf.adj_first[rays[i].pt1]++;
+    pf.adj_first[rays[i].pt2]++;
+  }
+
+  // Cumulate: adj_first[g] is now the end of the entries of point g
+  for(i = 1; i < nb_pts; i++) {
+    pf.adj_first[i] += pf.adj_first[i-1];
+  }
+  pf.adj_first[nb_pts] = pf.adj_first[nb_pts-1];
+
+  // Fill the entries backward: adj_first[g] ends up as the start of point g
+  for(i = 0; i < ray_n; i++) {
+    g1 = rays[i].pt1;
+    g2 = rays[i].pt2;
+
+    pf.adj_first[g1]--;
+    pf.adj_ray[pf.adj_first[g1]] = i;
+    pf.adj_pt[pf.adj_first[g1]] = g2;
+
+    pf.adj_first[g2]--;
+    pf.adj_ray[pf.adj_first[g2]] = i;
+    pf.adj_pt[pf.adj_first[g2]] = g1;
+  }
+}
+
+// A* algorithm used for finding the fastest path on the visibility graph.
+// The search runs backward, from the destination to the robot: a state is a
+// point reached through a given ray, so the rotation needed at this point
+// between the ray and the next one of the path is known and charged.
+// The rotation from the initial robot heading is charged when reaching the goal.
+// The open set is a binary heap of states sorted on time + heuristic, the
+// heuristic being the straight-line time at full speed to the goal (never
+// larger than the actual time, so the result is optimal).
 //
 // The algorithm's result will be stored in the point's field "poly" and "pt",
-// which corresponds to the parent's point in the solution path.
-// Thus, from the end point (destination), we can go back to the start with the
+// which corresponds to the parent's point in the solution path, and its
+// estimated time in pf.est_time_ms.
+// Thus, from the goal point, we can go back to the start with the
 // optimal solution.
-void path_compute_dijkstra(uint8_t start_poly, uint8_t start_pt) {
-
-  uint16_t i;
-  int8_t add;
+void path_compute_astar(uint8_t start_poly, uint8_t start_pt,
+                        uint8_t goal_poly, uint8_t goal_pt) {
+
+  path_state_t idx;
+  path_state_t cur;
+  path_state_t best = PATH_HEAP_NONE;
+  path_pt_idx_t pt;
+  path_pt_idx_t prev;
+  path_pt_idx_t next;
+  path_pt_idx_t start;
+  path_pt_idx_t goal;
+  int32_t cost;
   path_proc_pt_t* cur_pt;
-  path_proc_pt_t* pt_ray_i_j;
-  uint8_t ray_i;
-  uint8_t ray_j;
-  uint8_t ray_i_add;
-  uint8_t ray_j_add;
-  bool finished = false;
 
-  // Starting point must be visited
-  pf.polys[start_poly].pts[start_pt].valid = PATH_DIJ_PT_MUST_VISIT;
+  start = get_pt_global_idx(pf.polys, start_poly, start_pt);
+  goal  = get_pt_global_idx(pf.polys, goal_poly, goal_pt);
 
-  while(!finished) {
+  // Cleanup search states, compute the heuristic of each point
+  for(idx = 0; idx < pf.cur_pt_idx; idx++) {
+    pf.pts[idx].valid = PATH_DIJ_PT_NOT_VISITED;
+    pf.pts[idx].weight = 0;
+    pf.heuristic[idx] = (int32_t) (10 * norm2_vect(pf.pts[idx].x - pf.pts[goal].x,
+                                                   pf.pts[idx].y - pf.pts[goal].y)
+                                   * PHYS_ROBOT_NB_IMP_PER_MM / pf.speed_d * OS_AVERSIVE_PERIOD_MS);
+  }
+  for(idx = 0; idx < pf.adj_first[pf.cur_pt_idx]; idx++) {
+    pf.heap_pos[idx] = PATH_HEAP_NONE;
+  }
+  pf.heap_n = 0;
+  pf.est_time_ms = 0;
+  pf.nb_astar_iterations = 0;
+
+  // Starting state, standing at the start point
+  pf.adj_pt[PATH_START_STATE] = start;
+  pf.state_cost[PATH_START_STATE] = 0;
+  pf.state_parent[PATH_START_STATE] = PATH_START_STATE;
+  path_heap_push(PATH_START_STATE);
+
+  while(pf.heap_n > 0) {
+
+    // Expand the most promising state
+    cur = path_heap_pop();
+    pf.nb_astar_iterations++;
+    pt = pf.adj_pt[cur];
+
+    // Its cost is final, no need to look further
+    if(pt == goal) {
+      best = cur;
+      break;
+    }
 
-    finished = true;
+    // Point the robot goes to from this point
+    prev = pf.adj_pt[pf.state_parent[cur]];
 
-    // Check all polygons
-    for(start_poly = 0; start_poly < PATH_MAX_POLYS; start_poly++) {
+    // Relax all rays starting from this point
+    for(idx = pf.adj_first[pt]; idx < pf.adj_first[pt+1]; idx++) {
 
-      // Check all points of the current polygon
-      for(start_pt = 0; start_pt < pf.polys[start_poly].n; start_pt++) {
+      next = pf.adj_pt[idx];
 
-        // Store current point to avoid extensive array access
-        // and make the code more readable
-        cur_pt = &(pf.polys[start_poly].pts[start_pt]);
+      // Going back is never faster
+      if((pf.heap_pos[idx] == PATH_HEAP_CLOSED) || (next == prev))
+        continue;
 
-        // If the point must be already visited, no go on for the next point
-        if(cur_pt->valid != PATH_DIJ_PT_MUST_VISIT)
-          continue;
+      cost = pf.state_cost[cur] + pf.weight[pf.adj_ray[idx]];
 
-        add = -2;
+      // Rotation at this point, between the ray and the next one
+      if(cur != PATH_START_STATE)
+        cost += path_turn_time(pf.pts[pt].x - pf.pts[next].x, pf.pts[pt].y - pf.pts[next].y,
+                               pf.pts[prev].x - pf.pts[pt].x, pf.pts[prev].y - pf.pts[pt].y);
 
-        // Look for rays that start or stop at a point that must be visited
-        for(i = 0; i < pf.nb_rays ; i += 2) {
+      // Rotation of the robot before its first ray
+      if(next == goal)
+        cost += path_start_turn_time(pf.pts[pt].x - pf.pts[next].x, pf.pts[pt].y - pf.pts[next].y);
 
-          // If index is even it is a start point and connected point is i+2
-          // If index is odd, it is a stop  point and connected point is i-2
-          add = -add;
+      if((pf.heap_pos[idx] == PATH_HEAP_NONE) || (cost < pf.state_cost[idx])) {
 
-          // Use some local values to avoid extensive array access
-          // and make the code more readable
-          ray_i = pf.u.rays[i];
-          ray_j = pf.u.rays[i+1];
-          ray_i_add = pf.u.rays[i+add];
-          ray_j_add = pf.u.rays[i+add+1];
-          pt_ray_i_j = &(pf.polys[ray_i_add].pts[ray_j_add]);
+        pf.state_cost[idx] = cost;
+        pf.state_parent[idx] = cur;
 
-          if((start_poly == ray_i) && (start_pt == ray_j)) {
+        if(pf.heap_pos[idx] == PATH_HEAP_NONE) {
+          path_heap_push(idx);
+        } else {
+          path_heap_up(pf.heap_pos[idx]);
+        }
+      }
 
-            if(    (pt_ray_i_j->weight == PATH_DIJ_PT_NOT_VISITED)
-                || ((cur_pt->weight + pf.weight[i>>2]) < pt_ray_i_j->weight)) {
+    } // for(idx)
+  } // while(heap)
 
-              pt_ray_i_j->poly = start_poly;
-              pt_ray_i_j->pt = start_pt;
-              pt_ray_i_j->valid = PATH_DIJ_PT_MUST_VISIT;
-              pt_ray_i_j->weight = cur_pt->weight + pf.weight[i>>2];
+  // Goal not reached
+  if(best == PATH_HEAP_NONE)
+    return;
 
-              cur_pt->valid = PATH_DIJ_PT_VISITED;
-              finished = false;
-            }
-          }
+  pf.est_time_ms = pf.state_cost[best];
 
-        } // for(i)
-      } // for(start_pt)
-    } // for(start_poly)
-  } // while(!finished)
+  // Store the parent of each point of the best path
+  for(cur = best; cur != PATH_START_STATE; cur = pf.state_parent[cur]) {
+    cur_pt = &pf.pts[pf.adj_pt[cur]];
+    prev = pf.adj_pt[pf.state_parent[cur]];
+    cur_pt->valid = PATH_DIJ_PT_VISITED;
+    cur_pt->weight = pf.state_cost[cur];
+    cur_pt->poly = pf.pt_poly[prev];
+    cur_pt->pt = pf.pt_idx[prev];
+  }
+  pf.pts[start].valid = PATH_DIJ_PT_VISITED;
+}
+
+// Multi-goal variant of the search: the fastest time from the start point
+// (poly 0, point 0) to every goal (poly 0, points 1 to n) is found at once.
+// The search runs forward from the robot with the same states and motion
+// model than path_compute_astar(), without heuristic (it could not be
+// admissible for all the goals) and until all the goals are reached.
+// Times are stored in pf.goal_time_ms[], PATH_TIME_UNREACHABLE if not reached.
+void path_compute_goals_search(void) {
+
+  path_state_t idx;
+  path_state_t cur;
+  path_pt_idx_t pt;
+  path_pt_idx_t prev;
+  path_pt_idx_t next;
+  uint8_t nb_left = pf.nb_goals;
+  int32_t cost;
+
+  // Cleanup search states
+  for(idx = 0; idx < pf.cur_pt_idx; idx++) {
+    pf.pts[idx].valid = PATH_DIJ_PT_NOT_VISITED;
+    pf.pts[idx].weight = 0;
+    pf.heuristic[idx] = 0;
+  }
+  for(idx = 0; idx < pf.adj_first[pf.cur_pt_idx]; idx++) {
+    pf.heap_pos[idx] = PATH_HEAP_NONE;
+  }
+  for(idx = 0; idx < pf.nb_goals; idx++) {
+    pf.goal_time_ms[idx] = PATH_TIME_UNREACHABLE;
+  }
+  pf.heap_n = 0;
+  pf.nb_astar_iterations = 0;
+
+  // Starting state, standing at the robot point
+  pf.adj_pt[PATH_START_STATE] = 0;
+  pf.state_cost[PATH_START_STATE] = 0;
+  pf.state_parent[PATH_START_STATE] = PATH_START_STATE;
+  path_heap_push(PATH_START_STATE);
+
+  while((pf.heap_n > 0) && (nb_left > 0)) {
+
+    cur = path_heap_pop();
+    pf.nb_astar_iterations++;
+    pt = pf.adj_pt[cur];
+
+    // First time a goal is expanded: its time is final.
+    // Goals are not crossed, so the times are the ones of path_find().
+    if((pt >= 1) && (pt <= pf.nb_goals)) {
+      if(pf.pts[pt].valid == PATH_DIJ_PT_NOT_VISITED) {
+        pf.pts[pt].valid = PATH_DIJ_PT_VISITED;
+        pf.goal_time_ms[pt-1] = pf.state_cost[cur];
+        nb_left--;
+      }
+      continue;
+    }
+
+    // Point the robot comes from
+    prev = pf.adj_pt[pf.state_parent[cur]];
+
+    for(idx = pf.adj_first[pt]; idx < pf.adj_first[pt+1]; idx++) {
+
+      next = pf.adj_pt[idx];
+
+      if((pf.heap_pos[idx] == PATH_HEAP_CLOSED) || (next == prev))
+        continue;
+
+      cost = pf.state_cost[cur] + pf.weight[pf.adj_ray[idx]];
+
+      // Rotation at this point, or from the initial robot heading
+      if(cur != PATH_START_STATE)
+        cost += path_turn_time(pf.pts[pt].x - pf.pts[prev].x, pf.pts[pt].y - pf.pts[prev].y,
+                               pf.pts[next].x - pf.pts[pt].x, pf.pts[next].y - pf.pts[pt].y);
+      else
+        cost += path_start_turn_time(pf.pts[next].x - pf.pts[pt].x, pf.pts[next].y - pf.pts[pt].y);
+
+      if((pf.heap_pos[idx] == PATH_HEAP_NONE) || (cost < pf.state_cost[idx])) {
+
+        pf.state_cost[idx] = cost;
+        pf.state_parent[idx] = cur;
+
+        if(pf.heap_pos[idx] == PATH_HEAP_NONE) {
+          path_heap_push(idx);
+        } else {
+          path_heap_up(pf.heap_pos[idx]);
+        }
+      }
+
+    } // for(idx)
+  } // while(heap)
 }
 
 // Affect the result value in the main path-finding container
 // Returns -1 if there is no correct solution
 // otherwise returns the number of checkpoints
-int8_t path_get_result(path_poly_t* polys, uint8_t* rays) {
+int8_t path_get_result(path_poly_t* polys, path_ray_t* rays) {
 
   // Start from the destination point (0,1)
   uint8_t poly = 0;
@@ -714,7 +1761,7 @@ int8_t path_get_result(path_poly_t* polys, uint8_t* rays) {
     if(nb_checkpoints >= PATH_MAX_CHECKPOINTS)
       return PATH_RESULT_ERROR;
 
-    // Invalid path since it was not visited by the Dijkstra algorithm!
+    // Invalid path since it was not reached by the search algorithm!
     if(cur_pt->valid == PATH_DIJ_PT_NOT_VISITED) {
       return PATH_RESULT_ERROR;
     }
@@ -738,28 +1785,357 @@ int8_t path_get_result(path_poly_t* polys, uint8_t* rays) {
   return nb_checkpoints;
 }
 
-// Find the shortest path between the source and destination point by taking
+#if PATH_SMOOTH_CLEARANCE_MM > 0
+
+// Push the checkpoints of the result (but the destination) outward of their
+// turn by PATH_SMOOTH_CLEARANCE_MM, when the resulting segments are still free.
+static void path_smooth_clearance(int32_t src_x, int32_t src_y, uint8_t nb_checkpoints) {
+
+  uint8_t k;
+  int32_t x = src_x;
+  int32_t y = src_y;
+  int32_t new_x;
+  int32_t new_y;
+  float dx1;
+  float dy1;
+  float dx2;
+  float dy2;
+  float norm;
+
+  for(k = 0; k + 1 < nb_checkpoints; k++) {
+
+    // Unit vectors of the segments before and after the checkpoint
+    dx1 = pf.u.res[k].x - x;
+    dy1 = pf.u.res[k].y - y;
+    norm = sqrtf(dx1 * dx1 + dy1 * dy1);
+    if(norm > 0) {
+      dx1 /= norm;
+      dy1 /= norm;
+    }
+
+    dx2 = pf.u.res[k+1].x - pf.u.res[k].x;
+    dy2 = pf.u.res[k+1].y - pf.u.res[k].y;
+    norm = sqrtf(dx2 * dx2 + dy2 * dy2);
+    if(norm > 0) {
+      dx2 /= norm;
+      dy2 /= norm;
+    }
+
+    // The obstacle is inside the turn, move away along its bisector
+    dx1 -= dx2;
+    dy1 -= dy2;
+    norm = sqrtf(dx1 * dx1 + dy1 * dy1);
+
+    if(norm > 0.01f) {
+
+      new_x = pf.u.res[k].x + (int32_t) (dx1 * PATH_SMOOTH_CLEARANCE_MM / norm);
+      new_y = pf.u.res[k].y + (int32_t) (dy1 * PATH_SMOOTH_CLEARANCE_MM / norm);
+
+      if((new_x > TABLE_X_MIN) && (new_x < TABLE_X_MAX) &&
+         (new_y > TABLE_Y_MIN) && (new_y < TABLE_Y_MAX) &&
+         path_is_segment_free(x, y, new_x, new_y) &&
+         path_is_segment_free(new_x, new_y, pf.u.res[k+1].x, pf.u.res[k+1].y)) {
+        pf.u.res[k].x = new_x;
+        pf.u.res[k].y = new_y;
+      }
+    }
+
+    x = pf.u.res[k].x;
+    y = pf.u.res[k].y;
+  }
+}
+
+#endif /* PATH_SMOOTH_CLEARANCE_MM > 0 */
+
+// Smooth the result path from a source point (mm), which may not be the one
+// it was computed from (cached or precomputed paths):
+// - Checkpoints that can be skipped in straight line are dropped, going from
+//   each kept checkpoint to the furthest one it sees. This removes the
+//   collinear checkpoints and shortcuts the ones not needed anymore.
+// - Optionally, remaining checkpoints (polygon corners) are moved away from
+//   the obstacles by PATH_SMOOTH_CLEARANCE_MM.
+// The destination point is never modified.
+// Returns the new number of checkpoints.
+int8_t path_smooth(int32_t src_x, int32_t src_y, uint8_t nb_checkpoints) {
+
+  uint8_t k;
+  uint8_t next;
+  uint8_t nb_kept = 0;
+  int32_t x = src_x;
+  int32_t y = src_y;
+
+  for(k = 0; k < nb_checkpoints; k = next + 1) {
+
+    // Furthest checkpoint in sight, the next one always is
+    for(next = nb_checkpoints - 1; next > k; next--) {
+      if(path_is_segment_free(x, y, pf.u.res[next].x, pf.u.res[next].y))
+        break;
+    }
+
+    pf.u.res[nb_kept++] = pf.u.res[next];
+    x = pf.u.res[next].x;
+    y = pf.u.res[next].y;
+  }
+
+#if PATH_SMOOTH_CLEARANCE_MM > 0
+  path_smooth_clearance(src_x, src_y, nb_kept);
+#endif
+
+  pf.nb_checkpoint = nb_kept;
+
+  return nb_kept;
+}
+
+// Estimate the time (ms) needed to run the first checkpoints of the result
+// from a source point, with the same motion model than the search.
+// The estimation is also kept in pf.est_time_ms.
+uint32_t path_estimate_time(int32_t src_x, int32_t src_y, uint8_t nb_checkpoints) {
+
+  uint8_t k;
+  float dx;
+  float dy;
+  float prev_dx = 0;
+  float prev_dy = 0;
+  uint32_t time = 0;
+
+  for(k = 0; k < nb_checkpoints; k++) {
+
+    dx = pf.u.res[k].x - src_x;
+    dy = pf.u.res[k].y - src_y;
+
+    if(k == 0)
+      time += path_start_turn_time(dx, dy);
+    else
+      time += path_turn_time(prev_dx, prev_dy, dx, dy);
+
+    time += path_segment_time(sqrtf(dx * dx + dy * dy));
+
+    prev_dx = dx;
+    prev_dy = dy;
+    src_x = pf.u.res[k].x;
+    src_y = pf.u.res[k].y;
+  }
+
+  pf.est_time_ms = time;
+
+  return time;
+}
+
+// Find the fastest path between the source and destination point by taking
 // into account the polygons as obstacles.
 // Returns -1 if an error occured
 // Otherwise returns the number of checkpoints used by the solution.
 // Path points are contained in pf.u.res[] array (start point not present)
+// The search is done on the occupancy grid when the grid backend is selected.
 int8_t path_process(void) {
 
   uint16_t nb_rays;
+  int8_t ret;
+
+  pf.nb_poly_tests = 0;
+  pf.nb_poly_culled = 0;
+
+#if PATH_GRID_ENABLE
+  if(pf.backend == PATH_BACKEND_GRID)
+    return path_grid_process();
+#endif
 
   // First compute the visibility graph
   nb_rays = path_compute_rays(pf.polys, pf.cur_poly_idx, pf.u.rays);
 
   // Affect each ray with a weight
-  path_compute_rays_weight(pf.polys, pf.u.rays, nb_rays, pf.weight);
+  path_compute_rays_weight(pf.u.rays, nb_rays, pf.weight);
 
-  // Apply Dijkstra Algorithm on the visibility graph
+  // Apply A* Algorithm on the visibility graph
   // from start (poly 0, point 0) to the end (poly 0, point 1)
   pf.nb_rays = nb_rays;
-  path_compute_dijkstra(0, 0);
+  path_compute_adjacency(pf.u.rays, nb_rays);
+  path_compute_astar(0, 0, 0, 1);
 
   // From here we can backtrack the result path from end to the start
-  return path_get_result(pf.polys, pf.u.rays);
+  ret = path_get_result(pf.polys, pf.u.rays);
+
+  // Remove the checkpoints that are not needed and keep away from the corners
+  if(ret != PATH_RESULT_ERROR) {
+    ret = path_smooth(10 * pf.pts[1].x, 10 * pf.pts[1].y, ret);
+    path_estimate_time(10 * pf.pts[1].x, 10 * pf.pts[1].y, ret);
+  }
+
+  DEBUG_INFO("[PATH] %u rays, %lu/%lu polygon tests culled, est. %lu ms"DEBUG_EOL,
+      nb_rays, pf.nb_poly_culled, pf.nb_poly_tests, pf.est_time_ms);
+
+  return ret;
+}
+
+// Heading cell of the results cache keys, from the current robot heading
+static int16_t path_results_heading_cell(void) {
+  if(pf.heading == PATH_HEADING_NONE)
+    return PATH_HEADING_NONE;
+  return ((pf.heading % 360 + 360) % 360) / PATH_RESULTS_HEADING_DEG;
 }
 
+// Returns true when a results cache entry has been computed for the same
+// start cell, destination, obstacles epoch, motion model and heading cell.
+// A path computed without initial heading is used for any heading.
+static bool path_result_matches(const path_cached_result_t* entry,
+                                int16_t cell_x, int16_t cell_y,
+                                int32_t dst_x, int32_t dst_y, int16_t heading_cell) {
+  return entry->valid && (entry->epoch == pf.epoch) &&
+         (entry->src_cell_x == cell_x) && (entry->src_cell_y == cell_y) &&
+         (entry->dst_x == dst_x) && (entry->dst_y == dst_y) &&
+         (entry->speed == pf.speed) && (entry->type == pf.type) &&
+         ((entry->heading_cell == heading_cell) || (entry->heading_cell == PATH_HEADING_NONE));
+}
+
+// Returns true when path_find() would use the results cache for these points,
+// with the current motion model and heading. The cached path is not checked.
+bool path_has_result(int32_t src_x, int32_t src_y, int32_t dst_x, int32_t dst_y) {
+
+  uint8_t idx;
+  int16_t heading_cell = path_results_heading_cell();
+
+  for(idx = 0; idx < PATH_RESULTS_CACHE_SIZE; idx++) {
+    if(path_result_matches(&pf.results[idx], src_x / PATH_RESULTS_CELL_MM, src_y / PATH_RESULTS_CELL_MM,
+                           dst_x, dst_y, heading_cell))
+      return true;
+  }
+
+  return false;
+}
+
+// Find a path between the source and destination points, using the results
+// cache when a path was already computed from the same start cell to the same
+// destination during the current obstacles epoch, with the same motion model
+// and a close initial heading.
+// A cached path is still checked against the polygons from the actual source
+// point before being used.
+// Same return value and result than path_process().
+int8_t path_find(int32_t src_x, int32_t src_y, int32_t dst_x, int32_t dst_y) {
+
+  uint8_t idx;
+  uint8_t k;
+  int16_t cell_x = src_x / PATH_RESULTS_CELL_MM;
+  int16_t cell_y = src_y / PATH_RESULTS_CELL_MM;
+  int16_t heading_cell = path_results_heading_cell();
+  int32_t x;
+  int32_t y;
+  int8_t ret;
+  path_cached_result_t* entry;
+  path_cached_result_t* lru = &pf.results[0];
+
+  pf.results_tick++;
+
+  for(idx = 0; idx < PATH_RESULTS_CACHE_SIZE; idx++) {
+
+    entry = &pf.results[idx];
+
+    // Remember the least recently used entry (or a free one) for replacement
+    if(!entry->valid || (lru->valid && entry->last_use < lru->last_use))
+      lru = entry;
+
+    if(!path_result_matches(entry, cell_x, cell_y, dst_x, dst_y, heading_cell))
+      continue;
 
+    // Rebuild the result, destination included (same precision than the
+    // one given by path_get_result())
+    for(k = 0; k < entry->nb_checkpoint; k++) {
+      pf.u.res[k] = entry->res[k];
+    }
+    pf.u.res[k].x = (dst_x / 10) * 10;
+    pf.u.res[k].y = (dst_y / 10) * 10;
+
+    // Check the path from the actual source point
+    x = src_x;
+    y = src_y;
+    for(k = 0; k <= entry->nb_checkpoint; k++) {
+      if(!path_is_segment_free(x, y, pf.u.res[k].x, pf.u.res[k].y))
+        break;
+      x = pf.u.res[k].x;
+      y = pf.u.res[k].y;
+    }
+
+    // Not valid anymore: re-use this entry
+    if(k <= entry->nb_checkpoint) {
+      entry->valid = false;
+      lru = entry;
+      break;
+    }
+
+    entry->last_use = pf.results_tick;
+    pf.nb_results_hits++;
+    path_smooth(src_x, src_y, entry->nb_checkpoint + 1);
+    path_estimate_time(src_x, src_y, pf.nb_checkpoint);
+    return pf.nb_checkpoint;
+  }
+
+  pf.nb_results_misses++;
+
+  path_set_objective(src_x, src_y, dst_x, dst_y);
+  ret = path_process();
+
+  // Keep the new path (without its destination)
+  if(ret != PATH_RESULT_ERROR) {
+    lru->valid = true;
+    lru->src_cell_x = cell_x;
+    lru->src_cell_y = cell_y;
+    lru->dst_x = dst_x;
+    lru->dst_y = dst_y;
+    lru->epoch = pf.epoch;
+    lru->speed = pf.speed;
+    lru->type = pf.type;
+    lru->heading_cell = heading_cell;
+    lru->last_use = pf.results_tick;
+    lru->nb_checkpoint = ret - 1;
+    for(k = 0; k < ret - 1; k++) {
+      lru->res[k] = pf.u.res[k];
+    }
+  }
+
+  return ret;
+}
+
+// Compute the travel time (ms) from a source point to several goals (mm) with
+// a single search on the visibility graph, using the current motion model and
+// robot heading. Goals are not checked against the results cache, and no path
+// is kept: path_find() must still be used for the chosen goal.
+// Returns the number of goals reached, times are in pf.goal_time_ms[].
+uint8_t path_compute_travel_times(int32_t src_x, int32_t src_y,
+                                  const poi_t* goals, uint8_t nb_goals) {
+
+  uint8_t idx;
+  uint8_t nb_reached = 0;
+  uint16_t nb_rays;
+
+  if(nb_goals > PATH_MAX_GOALS)
+    nb_goals = PATH_MAX_GOALS;
+
+  // The objective polygon holds the source and all the goals
+  pf.nb_goals = nb_goals;
+  pf.polys[0].n = 1 + nb_goals;
+  pf.robot_pt = 0;
+  pf.pts[0].x = src_x/10;
+  pf.pts[0].y = src_y/10;
+  for(idx = 0; idx < nb_goals; idx++) {
+    pf.pts[1+idx].x = goals[idx].x/10;
+    pf.pts[1+idx].y = goals[idx].y/10;
+  }
+
+  pf.nb_poly_tests = 0;
+  pf.nb_poly_culled = 0;
+
+  nb_rays = path_compute_rays(pf.polys, pf.cur_poly_idx, pf.u.rays);
+  path_compute_rays_weight(pf.u.rays, nb_rays, pf.weight);
+  pf.nb_rays = nb_rays;
+  path_compute_adjacency(pf.u.rays, nb_rays);
+  path_compute_goals_search();
+
+  for(idx = 0; idx < nb_goals; idx++) {
+    if(pf.goal_time_ms[idx] != PATH_TIME_UNREACHABLE)
+      nb_reached++;
+  }
+
+  DEBUG_INFO("[PATH] %u rays, %u/%u goals reached in %lu iterations"DEBUG_EOL,
+      nb_rays, nb_reached, nb_goals, pf.nb_astar_iterations);
+
+  return nb_reached;
+}
@@ -0,0 +1,274 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       path_bench.c
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Path-finder benchmark and stress scenarios.
+ *   Random obstacles are added on top of the current polygons (up to the
+ *   PATH_MAX_POLYS / PATH_MAX_POINTS capacities), a random objective is
+ *   processed and the cost of the processing is reported as a CSV line:
+ *
+ *     scenario,polys,points,rays,iterations,time_us,checkpoints,est_ms
+ *
+ *   checkpoints is PATH_RESULT_ERROR (-1) when no path is found.
+ *   Scenarios only depend on the seed, so a layout can be replayed with the
+ *   same seed after a change of the planner. Added obstacles are removed
+ *   after each scenario. Must not be used while a match is running.
+ *
+ *   The RAM used by the path-finder for the capacities of path_config.h is
+ *   also reported here.
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#include "../../2018_T1_R1/include/main.h"
+
+// -----------------------------------------------------------------------------
+// GLOBALS
+// -----------------------------------------------------------------------------
+
+extern path_t pf;
+#if PATH_GRID_ENABLE
+extern path_grid_t pf_grid;
+#endif
+
+// State of the benchmark random generator
+static uint32_t path_bench_rand_state;
+
+// -----------------------------------------------------------------------------
+// STATIC HANDLERS
+// -----------------------------------------------------------------------------
+
+// Pseudo-random number in [min; max[, independent from the libc rand()
+// so that the scenarios of a seed never change
+static int32_t path_bench_rand(int32_t min, int32_t max) {
+  path_bench_rand_state = path_bench_rand_state * 1103515245UL + 12345UL;
+  return min + (int32_t) ((path_bench_rand_state >> 8) % (uint32_t) (max - min));
+}
+
+// Start the cycle counter used for measuring the processing time.
+// It is shared with the control system, so it is never cleared.
+static void path_bench_start_cycles(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+// Add random obstacles, alternating rectangles and octogons, half of them static.
+// Returns the number of polygons added.
+static uint8_t path_bench_add_obstacles(uint8_t nb_polys) {
+
+  uint8_t idx;
+  int32_t x;
+  int32_t y;
+  int32_t w;
+  int32_t h;
+  path_poly_t* poly;
+
+  for(idx = 0; idx < nb_polys; idx++) {
+
+    x = path_bench_rand(300, TABLE_X_MAX - 300);
+    y = path_bench_rand(300, TABLE_Y_MAX - 300);
+    w = path_bench_rand(50, 200);
+    h = path_bench_rand(50, 200);
+
+    poly = path_add_new_poly((idx & 1) ? 8 : 4);
+    if(poly == NULL)
+      break;
+
+    if(idx & 1) {
+      path_poly_set_points(poly, 0, x -   w/2, y - 3*w/2);
+      path_poly_set_points(poly, 1, x +   w/2, y - 3*w/2);
+      path_poly_set_points(poly, 2, x + 3*w/2, y -   w/2);
+      path_poly_set_points(poly, 3, x + 3*w/2, y +   w/2);
+      path_poly_set_points(poly, 4, x +   w/2, y + 3*w/2);
+      path_poly_set_points(poly, 5, x -   w/2, y + 3*w/2);
+      path_poly_set_points(poly, 6, x - 3*w/2, y +   w/2);
+      path_poly_set_points(poly, 7, x - 3*w/2, y -   w/2);
+    } else {
+      path_poly_set_points(poly, 0, x - w, y - h);
+      path_poly_set_points(poly, 1, x + w, y - h);
+      path_poly_set_points(poly, 2, x + w, y + h);
+      path_poly_set_points(poly, 3, x - w, y + h);
+      path_poly_set_static(poly, true);
+    }
+  }
+
+  return idx;
+}
+
+// -----------------------------------------------------------------------------
+// BENCHMARK
+// -----------------------------------------------------------------------------
+
+// Run the benchmark scenarios, one per call so the shell can print the
+// results line by line. Scenario i adds (i modulo the number of free polygons
+// + 1) random obstacles, so successive scenarios sweep up to full capacity.
+// Each scene is solved by both backends: visibility graph, then grid (when
+// PATH_GRID_ENABLE is set).
+// Returns pdTRUE while there are scenarios left.
+BaseType_t path_bench_print(char* ret, size_t len, uint16_t nb_scenarios, uint32_t seed) {
+
+  static uint16_t scenario = 0;
+  static uint16_t nb_errors;
+  static uint32_t max_time_us;
+#if PATH_GRID_ENABLE
+  static uint16_t nb_grid_errors;
+  static uint32_t max_grid_time_us;
+  uint32_t grid_time_us;
+  int8_t nb_grid_checkpoints;
+#endif
+  uint8_t nb_polys = pf.cur_poly_idx;
+  uint8_t nb_points = pf.cur_pt_idx;
+  uint8_t nb_src_points = pf.cur_src_idx;
+  path_backend_e backend = pf.backend;
+  uint32_t cycles;
+  uint32_t time_us;
+  uint32_t est_ms;
+  int8_t nb_checkpoints;
+
+  // Starting
+  if(scenario == 0) {
+    path_bench_rand_state = seed;
+    path_bench_start_cycles();
+    nb_errors = 0;
+    max_time_us = 0;
+#if PATH_GRID_ENABLE
+    nb_grid_errors = 0;
+    max_grid_time_us = 0;
+    snprintf(ret, len, "scenario,polys,points,rays,iterations,time_us,checkpoints,est_ms,"
+                       "grid_expanded,grid_time_us,grid_checkpoints,grid_est_ms"SHELL_EOL);
+#else
+    snprintf(ret, len, "scenario,polys,points,rays,iterations,time_us,checkpoints,est_ms"SHELL_EOL);
+#endif
+    len -= strlen(ret);
+    ret += strlen(ret);
+  }
+
+  path_lock();
+
+  // Current obstacles and random ones
+  path_bench_add_obstacles(scenario % (PATH_MAX_POLYS - nb_polys + 1));
+
+  path_set_objective(path_bench_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50),
+                     path_bench_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50),
+                     path_bench_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50),
+                     path_bench_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50));
+
+  // Full processing, rays cache rebuilt included
+  pf.backend = PATH_BACKEND_VISIBILITY;
+  pf.cache_valid = false;
+  cycles = DWT->CYCCNT;
+  nb_checkpoints = path_process();
+  cycles = DWT->CYCCNT - cycles;
+  time_us = cycles / (SystemCoreClock / 1000000UL);
+  est_ms = (nb_checkpoints == PATH_RESULT_ERROR) ? 0 : pf.est_time_ms;
+
+  if(nb_checkpoints == PATH_RESULT_ERROR)
+    nb_errors++;
+  max_time_us = MAX(max_time_us, time_us);
+
+#if PATH_GRID_ENABLE
+  // Same scene on the grid, fully rasterised
+  pf.backend = PATH_BACKEND_GRID;
+  path_grid_invalidate();
+  cycles = DWT->CYCCNT;
+  nb_grid_checkpoints = path_process();
+  cycles = DWT->CYCCNT - cycles;
+  grid_time_us = cycles / (SystemCoreClock / 1000000UL);
+
+  if(nb_grid_checkpoints == PATH_RESULT_ERROR)
+    nb_grid_errors++;
+  max_grid_time_us = MAX(max_grid_time_us, grid_time_us);
+
+  snprintf(ret, len, "%u,%u,%u,%u,%lu,%lu,%d,%lu,%lu,%lu,%d,%lu"SHELL_EOL,
+           scenario, pf.cur_poly_idx, pf.cur_pt_idx, pf.nb_rays,
+           pf.nb_astar_iterations, time_us, nb_checkpoints, est_ms,
+           pf_grid.nb_expanded, grid_time_us, nb_grid_checkpoints,
+           (nb_grid_checkpoints == PATH_RESULT_ERROR) ? 0 : pf.est_time_ms);
+#else
+  snprintf(ret, len, "%u,%u,%u,%u,%lu,%lu,%d,%lu"SHELL_EOL,
+           scenario, pf.cur_poly_idx, pf.cur_pt_idx, pf.nb_rays,
+           pf.nb_astar_iterations, time_us, nb_checkpoints, est_ms);
+#endif
+
+  // Remove the random obstacles
+  pf.static_polys &= PATH_POLY_MASK(nb_polys) - 1;
+  pf.cur_poly_idx = nb_polys;
+  pf.cur_pt_idx = nb_points;
+  pf.cur_src_idx = nb_src_points;
+  pf.cache_valid = false;
+#if PATH_GRID_ENABLE
+  path_grid_invalidate();
+#endif
+  pf.backend = backend;
+  path_new_epoch();
+
+  path_unlock();
+
+  // Manage next call
+  scenario++;
+  if(scenario < nb_scenarios)
+    return pdTRUE;
+
+  // Finished
+  len -= strlen(ret);
+  ret += strlen(ret);
+#if PATH_GRID_ENABLE
+  snprintf(ret, len, "# %u scenarios, %u errors, max %lu us (grid: %u errors, max %lu us)"SHELL_EOL,
+           scenario, nb_errors, max_time_us, nb_grid_errors, max_grid_time_us);
+#else
+  snprintf(ret, len, "# %u scenarios, %u errors, max %lu us"SHELL_EOL,
+           scenario, nb_errors, max_time_us);
+#endif
+  scenario = 0;
+  return pdFALSE;
+}
+
+// -----------------------------------------------------------------------------
+// MEMORY REPORT
+// -----------------------------------------------------------------------------
+
+// Print the RAM (bytes) used by the path-finder container, by usage, then
+// by the grid backend when it is built
+void path_mem_print(char* ret, size_t len) {
+
+  snprintf(ret, len,
+      "Capacities: %u points, %u polygons, %u rays, %u cached rays, %u checkpoints"SHELL_EOL
+      "Index sizes: point %u, state %u, polygon mask %u"SHELL_EOL
+      "  polygons     %6u"SHELL_EOL
+      "  graph        %6u"SHELL_EOL
+      "  search       %6u"SHELL_EOL
+      "  rays cache   %6u"SHELL_EOL
+      "  results      %6u"SHELL_EOL
+      "  total        %6u / %u"SHELL_EOL,
+      PATH_MAX_POINTS, PATH_MAX_POLYS, PATH_MAX_RAYS, PATH_MAX_CACHED_RAYS, PATH_MAX_CHECKPOINTS,
+      sizeof(path_pt_idx_t), sizeof(path_state_t), sizeof(path_poly_mask_t),
+      sizeof(pf.pts) + sizeof(pf.polys) + sizeof(pf.src_pts) + sizeof(pf.pt_poly) + sizeof(pf.pt_idx),
+      sizeof(pf.weight) + sizeof(pf.adj_first) + sizeof(pf.adj_ray) + sizeof(pf.u),
+      sizeof(pf.adj_pt) + sizeof(pf.heuristic) + sizeof(pf.state_cost) + sizeof(pf.state_parent) +
+      sizeof(pf.heap) + sizeof(pf.heap_pos),
+      sizeof(pf.cache),
+      sizeof(pf.results),
+      sizeof(pf), PATH_RAM_BUDGET);
+
+#if PATH_GRID_ENABLE
+  len -= strlen(ret);
+  ret += strlen(ret);
+  snprintf(ret, len,
+      "Grid: %ux%u cells of %u mm"SHELL_EOL
+      "  occupancy    %6u"SHELL_EOL
+      "  search       %6u"SHELL_EOL
+      "  total        %6u / %u"SHELL_EOL,
+      PATH_GRID_W, PATH_GRID_H, PATH_GRID_CELL_MM,
+      sizeof(pf_grid.occ_static) + sizeof(pf_grid.occ),
+      sizeof(pf_grid.closed) + sizeof(pf_grid.cost) + sizeof(pf_grid.parent) +
+      sizeof(pf_grid.open) + sizeof(pf_grid.jumps),
+      sizeof(pf_grid), PATH_GRID_RAM_BUDGET);
+#endif
+}
@@ -0,0 +1,627 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       path_grid.c
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Grid backend of the path-finder.
+ *   The table is rasterised into a bit-packed occupancy grid, in which the
+ *   (inflated) polygons are stamped, and searched with the jump-point search
+ *   algorithm (JPS) on 8-connected cells. Diagonal moves are only allowed
+ *   when both orthogonal cells are free, so that no polygon corner is cut.
+ *   Jump points are then shortcut with the polygons (same as the visibility
+ *   graph results), and given in the pf.u.res[] array.
+ *   Search cost is the octile distance, not the travel time: the travel time
+ *   of the result is still estimated.
+ *   Only built when PATH_GRID_ENABLE is set (path_config.h).
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#include "../../2018_T1_R1/include/main.h"
+
+#if PATH_GRID_ENABLE
+
+// -----------------------------------------------------------------------------
+// GLOBALS
+// -----------------------------------------------------------------------------
+
+extern path_t pf;
+
+// Grid backend container
+path_grid_t pf_grid;
+
+_Static_assert(sizeof(path_grid_t) <= PATH_GRID_RAM_BUDGET, "path_grid_t exceeds PATH_GRID_RAM_BUDGET (path_config.h)");
+
+// Moves of the 8 directions
+static const int8_t path_grid_dx[8] = { 1, 1, 0, -1, -1, -1,  0,  1 };
+static const int8_t path_grid_dy[8] = { 0, 1, 1,  1,  0, -1, -1, -1 };
+
+// Goal cell of the current search, always walkable
+static int16_t goal_x;
+static int16_t goal_y;
+
+// -----------------------------------------------------------------------------
+// CELLS HANDLERS
+// -----------------------------------------------------------------------------
+
+#define PATH_GRID_BIT_SET(map, x, y) ((map)[y][(x) >> 5] |= (1UL << ((x) & 31)))
+#define PATH_GRID_BIT_GET(map, x, y) (((map)[y][(x) >> 5] >> ((x) & 31)) & 1)
+#define PATH_GRID_CELL(x, y) ((uint16_t) ((y) * PATH_GRID_W + (x)))
+
+// A cell can be crossed: in the table and not blocked (the goal always is)
+static bool path_grid_walkable(int16_t x, int16_t y) {
+
+  if((x < 0) || (y < 0) || (x >= PATH_GRID_W) || (y >= PATH_GRID_H))
+    return false;
+
+  if((x == goal_x) && (y == goal_y))
+    return true;
+
+  if(pf.static_only)
+    return !PATH_GRID_BIT_GET(pf_grid.occ_static, x, y);
+
+  return !PATH_GRID_BIT_GET(pf_grid.occ, x, y);
+}
+
+static uint8_t path_grid_get_parent(uint16_t cell) {
+  return (pf_grid.parent[cell >> 1] >> ((cell & 1) << 2)) & 0x0F;
+}
+
+static void path_grid_set_parent(uint16_t cell, uint8_t dir) {
+  pf_grid.parent[cell >> 1] &= ~(0x0F << ((cell & 1) << 2));
+  pf_grid.parent[cell >> 1] |= dir << ((cell & 1) << 2);
+}
+
+// Index of a direction, from its moves
+static uint8_t path_grid_dir(int8_t dx, int8_t dy) {
+
+  uint8_t dir;
+
+  for(dir = 0; dir < 8; dir++) {
+    if((path_grid_dx[dir] == dx) && (path_grid_dy[dir] == dy))
+      break;
+  }
+  return dir;
+}
+
+// Octile distance between 2 cells, in cost units
+static path_grid_cost_t path_grid_distance(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+
+  int16_t dx = ABS(x2 - x1);
+  int16_t dy = ABS(y2 - y1);
+
+  return PATH_GRID_COST_STRAIGHT * MAX(dx, dy) +
+         (PATH_GRID_COST_DIAGONAL - PATH_GRID_COST_STRAIGHT) * MIN(dx, dy);
+}
+
+// -----------------------------------------------------------------------------
+// RASTERISATION
+// -----------------------------------------------------------------------------
+
+// Block all the cells crossed by a segment (mm), with an exact traversal of
+// the cells so that thin polygons are never missed.
+static void path_grid_stamp_segment(uint32_t map[PATH_GRID_H][PATH_GRID_WORDS],
+                                    float x1, float y1, float x2, float y2) {
+
+  int16_t x = (int16_t) floorf(x1 / PATH_GRID_CELL_MM);
+  int16_t y = (int16_t) floorf(y1 / PATH_GRID_CELL_MM);
+  int16_t x_end = (int16_t) floorf(x2 / PATH_GRID_CELL_MM);
+  int16_t y_end = (int16_t) floorf(y2 / PATH_GRID_CELL_MM);
+  int8_t step_x = (x2 > x1) ? 1 : -1;
+  int8_t step_y = (y2 > y1) ? 1 : -1;
+  float dx = fabsf(x2 - x1);
+  float dy = fabsf(y2 - y1);
+  float t_max_x;
+  float t_max_y;
+  float t_delta_x;
+  float t_delta_y;
+  uint16_t nb_steps = ABS(x_end - x) + ABS(y_end - y);
+
+  // Segment parameters of the next cell boundaries
+  t_delta_x = (dx > 0) ? PATH_GRID_CELL_MM / dx : INFINITY;
+  t_delta_y = (dy > 0) ? PATH_GRID_CELL_MM / dy : INFINITY;
+  t_max_x = (dx > 0) ? ((step_x > 0) ? (x + 1) * PATH_GRID_CELL_MM - x1 : x1 - x * PATH_GRID_CELL_MM) / dx : INFINITY;
+  t_max_y = (dy > 0) ? ((step_y > 0) ? (y + 1) * PATH_GRID_CELL_MM - y1 : y1 - y * PATH_GRID_CELL_MM) / dy : INFINITY;
+
+  for(;;) {
+
+    if((x >= 0) && (y >= 0) && (x < PATH_GRID_W) && (y < PATH_GRID_H))
+      PATH_GRID_BIT_SET(map, x, y);
+
+    if(!nb_steps--)
+      break;
+
+    if(t_max_x < t_max_y) {
+      t_max_x += t_delta_x;
+      x += step_x;
+    } else {
+      t_max_y += t_delta_y;
+      y += step_y;
+    }
+  }
+}
+
+// Block the cells of a polygon: the ones whose center is inside it and the
+// ones crossed by its edges.
+static void path_grid_stamp_poly(uint32_t map[PATH_GRID_H][PATH_GRID_WORDS], const path_poly_t* poly) {
+
+  int16_t x;
+  int16_t y;
+  int16_t x_min = MAX(0, 10 * poly->x_min / PATH_GRID_CELL_MM);
+  int16_t x_max = MIN(PATH_GRID_W - 1, 10 * poly->x_max / PATH_GRID_CELL_MM);
+  int16_t y_min = MAX(0, 10 * poly->y_min / PATH_GRID_CELL_MM);
+  int16_t y_max = MIN(PATH_GRID_H - 1, 10 * poly->y_max / PATH_GRID_CELL_MM);
+  uint8_t i;
+  uint8_t j;
+  path_proc_pt_t center;
+
+  for(y = y_min; y <= y_max; y++) {
+    for(x = x_min; x <= x_max; x++) {
+      center.x = (x * PATH_GRID_CELL_MM + PATH_GRID_CELL_MM / 2) / 10;
+      center.y = (y * PATH_GRID_CELL_MM + PATH_GRID_CELL_MM / 2) / 10;
+      if(path_orient_pt_in_poly(&center, poly) != PATH_PT_POLY_OUTSIDE)
+        PATH_GRID_BIT_SET(map, x, y);
+    }
+  }
+
+  for(i = 0; i < poly->n; i++) {
+    j = (i + 1 < poly->n) ? i + 1 : 0;
+    path_grid_stamp_segment(map, 10 * poly->pts[i].x, 10 * poly->pts[i].y,
+                                 10 * poly->pts[j].x, 10 * poly->pts[j].y);
+  }
+}
+
+// Force a full rebuild of the grid, e.g. when polygons are removed or
+// change from static to dynamic.
+void path_grid_invalidate(void) {
+  pf_grid.valid = false;
+}
+
+// Update the occupancy grid with the polygons which changed since the last
+// update. Static polygons are stamped in their own grid, rebuilt only when one
+// of them changes. The dynamic ones are then stamped over a copy of it.
+void path_grid_update(void) {
+
+  uint8_t i;
+  int16_t x;
+  int16_t y;
+  path_poly_mask_t dirty = 0;
+
+  path_update_inflated_polys();
+
+  for(i = 1; i < pf.cur_poly_idx; i++) {
+    if(pf.polys[i].dirty & PATH_DIRTY_GRID) {
+      dirty |= PATH_POLY_MASK(i);
+      pf.polys[i].dirty &= ~PATH_DIRTY_GRID;
+    }
+  }
+
+  if(pf_grid.valid && !dirty)
+    return;
+
+  if(!pf_grid.valid || (dirty & pf.static_polys)) {
+
+    memset(pf_grid.occ_static, 0, sizeof(pf_grid.occ_static));
+
+    // Cells whose center is out of the playground
+    for(y = 0; y < PATH_GRID_H; y++) {
+      for(x = 0; x < PATH_GRID_W; x++) {
+        if((x * PATH_GRID_CELL_MM + PATH_GRID_CELL_MM / 2 >= TABLE_X_MAX) ||
+           (y * PATH_GRID_CELL_MM + PATH_GRID_CELL_MM / 2 >= TABLE_Y_MAX))
+          PATH_GRID_BIT_SET(pf_grid.occ_static, x, y);
+      }
+    }
+
+    for(i = 1; i < pf.cur_poly_idx; i++) {
+      if(pf.static_polys & PATH_POLY_MASK(i))
+        path_grid_stamp_poly(pf_grid.occ_static, &pf.polys[i]);
+    }
+
+    pf_grid.valid = true;
+  }
+
+  memcpy(pf_grid.occ, pf_grid.occ_static, sizeof(pf_grid.occ));
+
+  for(i = 1; i < pf.cur_poly_idx; i++) {
+    if(!(pf.static_polys & PATH_POLY_MASK(i)))
+      path_grid_stamp_poly(pf_grid.occ, &pf.polys[i]);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// OPEN SET
+// -----------------------------------------------------------------------------
+
+static bool path_grid_push(uint16_t cell, path_grid_cost_t key) {
+
+  uint16_t i;
+  path_grid_open_t tmp;
+
+  if(pf_grid.nb_open >= PATH_GRID_MAX_OPEN)
+    return false;
+
+  i = pf_grid.nb_open++;
+  pf_grid.open[i].cell = cell;
+  pf_grid.open[i].key = key;
+
+  while((i > 0) && (pf_grid.open[(i - 1) >> 1].key > pf_grid.open[i].key)) {
+    tmp = pf_grid.open[i];
+    pf_grid.open[i] = pf_grid.open[(i - 1) >> 1];
+    pf_grid.open[(i - 1) >> 1] = tmp;
+    i = (i - 1) >> 1;
+  }
+
+  return true;
+}
+
+static uint16_t path_grid_pop(void) {
+
+  uint16_t cell = pf_grid.open[0].cell;
+  uint16_t i = 0;
+  uint16_t child;
+  path_grid_open_t tmp;
+
+  pf_grid.open[0] = pf_grid.open[--pf_grid.nb_open];
+
+  for(;;) {
+    child = 2 * i + 1;
+    if(child >= pf_grid.nb_open)
+      break;
+    if((child + 1 < pf_grid.nb_open) && (pf_grid.open[child + 1].key < pf_grid.open[child].key))
+      child++;
+    if(pf_grid.open[i].key <= pf_grid.open[child].key)
+      break;
+    tmp = pf_grid.open[i];
+    pf_grid.open[i] = pf_grid.open[child];
+    pf_grid.open[child] = tmp;
+    i = child;
+  }
+
+  return cell;
+}
+
+// -----------------------------------------------------------------------------
+// JUMP-POINT SEARCH
+// -----------------------------------------------------------------------------
+
+// Jump in a straight direction from a cell, until a jump point is found:
+// the goal, or a cell with a forced neighbour (a free cell next to the move,
+// behind which there is an obstacle).
+// Returns true when found, its coordinates are updated.
+static bool path_grid_jump_straight(int16_t* px, int16_t* py, int8_t dx, int8_t dy) {
+
+  int16_t x = *px;
+  int16_t y = *py;
+
+  for(;;) {
+
+    if(!path_grid_walkable(x, y))
+      return false;
+
+    if((x == goal_x) && (y == goal_y))
+      break;
+
+    if(dx != 0) {
+      if((path_grid_walkable(x, y - 1) && !path_grid_walkable(x - dx, y - 1)) ||
+         (path_grid_walkable(x, y + 1) && !path_grid_walkable(x - dx, y + 1)))
+        break;
+    } else {
+      if((path_grid_walkable(x - 1, y) && !path_grid_walkable(x - 1, y - dy)) ||
+         (path_grid_walkable(x + 1, y) && !path_grid_walkable(x + 1, y - dy)))
+        break;
+    }
+
+    x += dx;
+    y += dy;
+  }
+
+  *px = x;
+  *py = y;
+  return true;
+}
+
+// Jump from a cell in any direction. A diagonal jump stops where one of the
+// straight jumps of its components finds a jump point.
+// Returns true when found, its coordinates are updated.
+static bool path_grid_jump(int16_t* px, int16_t* py, int8_t dx, int8_t dy) {
+
+  int16_t x = *px;
+  int16_t y = *py;
+  int16_t jx;
+  int16_t jy;
+
+  if((dx == 0) || (dy == 0))
+    return path_grid_jump_straight(px, py, dx, dy);
+
+  for(;;) {
+
+    if(!path_grid_walkable(x, y))
+      return false;
+
+    if((x == goal_x) && (y == goal_y))
+      break;
+
+    jx = x + dx;
+    jy = y;
+    if(path_grid_jump_straight(&jx, &jy, dx, 0))
+      break;
+
+    jx = x;
+    jy = y + dy;
+    if(path_grid_jump_straight(&jx, &jy, 0, dy))
+      break;
+
+    // Corners are not cut
+    if(!path_grid_walkable(x + dx, y) || !path_grid_walkable(x, y + dy))
+      return false;
+
+    x += dx;
+    y += dy;
+  }
+
+  *px = x;
+  *py = y;
+  return true;
+}
+
+// Directions to explore from a cell, pruned with the direction it was reached
+// from. Returns the mask of the directions.
+static uint8_t path_grid_neighbours(int16_t x, int16_t y, uint8_t parent_dir) {
+
+  uint8_t mask = 0;
+  uint8_t dir;
+  int8_t dx;
+  int8_t dy;
+  bool next;
+  bool side1;
+  bool side2;
+
+  // Start: all the directions, corners are not cut. The start cell itself
+  // may be blocked (robot close to an obstacle).
+  if(parent_dir == PATH_GRID_DIR_NONE) {
+    for(dir = 0; dir < 8; dir++) {
+      dx = path_grid_dx[dir];
+      dy = path_grid_dy[dir];
+      if(path_grid_walkable(x + dx, y + dy) &&
+         ((dx == 0) || (dy == 0) || (path_grid_walkable(x + dx, y) && path_grid_walkable(x, y + dy))))
+        mask |= 1 << dir;
+    }
+    return mask;
+  }
+
+  // Move direction, from the parent
+  dx = -path_grid_dx[parent_dir];
+  dy = -path_grid_dy[parent_dir];
+
+  if((dx != 0) && (dy != 0)) {
+    side1 = path_grid_walkable(x, y + dy);
+    side2 = path_grid_walkable(x + dx, y);
+    if(side1)
+      mask |= 1 << path_grid_dir(0, dy);
+    if(side2)
+      mask |= 1 << path_grid_dir(dx, 0);
+    if(side1 && side2)
+      mask |= 1 << path_grid_dir(dx, dy);
+
+  } else if(dx != 0) {
+    next = path_grid_walkable(x + dx, y);
+    side1 = path_grid_walkable(x, y + 1);
+    side2 = path_grid_walkable(x, y - 1);
+    if(next) {
+      mask |= 1 << path_grid_dir(dx, 0);
+      if(side1)
+        mask |= 1 << path_grid_dir(dx, 1);
+      if(side2)
+        mask |= 1 << path_grid_dir(dx, -1);
+    }
+    if(side1)
+      mask |= 1 << path_grid_dir(0, 1);
+    if(side2)
+      mask |= 1 << path_grid_dir(0, -1);
+
+  } else {
+    next = path_grid_walkable(x, y + dy);
+    side1 = path_grid_walkable(x + 1, y);
+    side2 = path_grid_walkable(x - 1, y);
+    if(next) {
+      mask |= 1 << path_grid_dir(0, dy);
+      if(side1)
+        mask |= 1 << path_grid_dir(1, dy);
+      if(side2)
+        mask |= 1 << path_grid_dir(-1, dy);
+    }
+    if(side1)
+      mask |= 1 << path_grid_dir(1, 0);
+    if(side2)
+      mask |= 1 << path_grid_dir(-1, 0);
+  }
+
+  return mask;
+}
+
+// Jump-point search between 2 cells.
+// Returns false if the goal cannot be reached (or the open set is full).
+static bool path_grid_search(int16_t start_x, int16_t start_y) {
+
+  uint16_t cell;
+  uint16_t next_cell;
+  uint8_t mask;
+  uint8_t dir;
+  int16_t x;
+  int16_t y;
+  int16_t jx;
+  int16_t jy;
+  path_grid_cost_t cost;
+
+  memset(pf_grid.closed, 0, sizeof(pf_grid.closed));
+  memset(pf_grid.cost, 0xFF, sizeof(pf_grid.cost));
+  memset(pf_grid.parent, 0xFF, sizeof(pf_grid.parent));
+  pf_grid.nb_open = 0;
+  pf_grid.nb_expanded = 0;
+
+  cell = PATH_GRID_CELL(start_x, start_y);
+  pf_grid.cost[cell] = 0;
+  path_grid_push(cell, path_grid_distance(start_x, start_y, goal_x, goal_y));
+
+  while(pf_grid.nb_open > 0) {
+
+    cell = path_grid_pop();
+    x = cell % PATH_GRID_W;
+    y = cell / PATH_GRID_W;
+
+    // Cells can be pushed more than once, only the best is expanded
+    if(PATH_GRID_BIT_GET(pf_grid.closed, x, y))
+      continue;
+    PATH_GRID_BIT_SET(pf_grid.closed, x, y);
+    pf_grid.nb_expanded++;
+
+    if((x == goal_x) && (y == goal_y))
+      return true;
+
+    mask = path_grid_neighbours(x, y, path_grid_get_parent(cell));
+
+    for(dir = 0; dir < 8; dir++) {
+
+      if(!(mask & (1 << dir)))
+        continue;
+
+      jx = x + path_grid_dx[dir];
+      jy = y + path_grid_dy[dir];
+      if(!path_grid_jump(&jx, &jy, path_grid_dx[dir], path_grid_dy[dir]))
+        continue;
+
+      next_cell = PATH_GRID_CELL(jx, jy);
+      if(PATH_GRID_BIT_GET(pf_grid.closed, jx, jy))
+        continue;
+
+      // Jump points are in line with the cell they come from
+      cost = pf_grid.cost[cell] + path_grid_distance(x, y, jx, jy);
+      if(cost >= pf_grid.cost[next_cell])
+        continue;
+
+      pf_grid.cost[next_cell] = cost;
+      path_grid_set_parent(next_cell, (dir + 4) & 7);
+      if(!path_grid_push(next_cell, cost + path_grid_distance(jx, jy, goal_x, goal_y))) {
+        DEBUG_INFO("[PATH] Grid open set is full"DEBUG_EOL);
+        return false;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Backtrack the jump points from the goal to the start.
+// The parent of a jump point is the first expanded cell found in its parent
+// direction whose cost is consistent with the one of the jump point.
+// Returns false if there are too many jump points.
+static bool path_grid_backtrack(int16_t start_x, int16_t start_y) {
+
+  int16_t x = goal_x;
+  int16_t y = goal_y;
+  uint16_t cell;
+  uint8_t dir;
+  path_grid_cost_t cost;
+  path_grid_cost_t step;
+
+  pf_grid.nb_jumps = 0;
+
+  while((x != start_x) || (y != start_y)) {
+
+    if(pf_grid.nb_jumps >= PATH_GRID_MAX_JUMPS)
+      return false;
+
+    pf_grid.jumps[pf_grid.nb_jumps].x = x * PATH_GRID_CELL_MM + PATH_GRID_CELL_MM / 2;
+    pf_grid.jumps[pf_grid.nb_jumps].y = y * PATH_GRID_CELL_MM + PATH_GRID_CELL_MM / 2;
+    pf_grid.nb_jumps++;
+
+    cell = PATH_GRID_CELL(x, y);
+    cost = pf_grid.cost[cell];
+    dir = path_grid_get_parent(cell);
+    if(dir == PATH_GRID_DIR_NONE)
+      return false;
+    step = (dir & 1) ? PATH_GRID_COST_DIAGONAL : PATH_GRID_COST_STRAIGHT;
+
+    do {
+      x += path_grid_dx[dir];
+      y += path_grid_dy[dir];
+      cost -= step;
+      if((x < 0) || (y < 0) || (x >= PATH_GRID_W) || (y >= PATH_GRID_H))
+        return false;
+      cell = PATH_GRID_CELL(x, y);
+    } while(!PATH_GRID_BIT_GET(pf_grid.closed, x, y) || (pf_grid.cost[cell] != cost));
+  }
+
+  return true;
+}
+
+// Find a path between the objective points (pf.pts[1] to pf.pts[0]) on the
+// occupancy grid. Same return value and result than path_process().
+int8_t path_grid_process(void) {
+
+  int32_t src_x = 10 * pf.pts[1].x;
+  int32_t src_y = 10 * pf.pts[1].y;
+  int32_t x = src_x;
+  int32_t y = src_y;
+  int16_t start_x = MIN(PATH_GRID_W - 1, MAX(0, src_x / PATH_GRID_CELL_MM));
+  int16_t start_y = MIN(PATH_GRID_H - 1, MAX(0, src_y / PATH_GRID_CELL_MM));
+  int16_t k;
+  int16_t next;
+  uint8_t nb_checkpoints = 0;
+
+  goal_x = MIN(PATH_GRID_W - 1, MAX(0, 10 * pf.pts[0].x / PATH_GRID_CELL_MM));
+  goal_y = MIN(PATH_GRID_H - 1, MAX(0, 10 * pf.pts[0].y / PATH_GRID_CELL_MM));
+
+  path_grid_update();
+
+  if(!path_grid_search(start_x, start_y) || !path_grid_backtrack(start_x, start_y)) {
+    DEBUG_INFO("[PATH] No grid path, %lu jump points expanded"DEBUG_EOL, pf_grid.nb_expanded);
+    return PATH_RESULT_ERROR;
+  }
+
+  // The goal cell center is replaced by the destination itself
+  // (same precision than the visibility graph results)
+  pf_grid.jumps[0].x = 10 * pf.pts[0].x;
+  pf_grid.jumps[0].y = 10 * pf.pts[0].y;
+
+  // Keep the furthest jump point in sight of the last checkpoint, from the
+  // source (jump points are stored from the destination)
+  for(k = pf_grid.nb_jumps - 1; k >= 0; k = next - 1) {
+
+    for(next = 0; next < k; next++) {
+      if(path_is_segment_free(x, y, pf_grid.jumps[next].x, pf_grid.jumps[next].y))
+        break;
+    }
+
+    // The source and the destination are not checked by the grid search:
+    // as for the visibility graph, there is no path from or to an obstacle.
+    if(((next == 0) || (k == pf_grid.nb_jumps - 1)) &&
+       !path_is_segment_free(x, y, pf_grid.jumps[next].x, pf_grid.jumps[next].y)) {
+      DEBUG_INFO("[PATH] No grid path, source or destination is blocked"DEBUG_EOL);
+      return PATH_RESULT_ERROR;
+    }
+
+    if(nb_checkpoints >= PATH_MAX_CHECKPOINTS)
+      return PATH_RESULT_ERROR;
+
+    pf.u.res[nb_checkpoints++] = pf_grid.jumps[next];
+    x = pf_grid.jumps[next].x;
+    y = pf_grid.jumps[next].y;
+  }
+
+  pf.nb_checkpoint = nb_checkpoints;
+  path_estimate_time(src_x, src_y, nb_checkpoints);
+
+  DEBUG_INFO("[PATH] Grid: %lu jump points expanded, %u checkpoints, est. %lu ms"DEBUG_EOL,
+      pf_grid.nb_expanded, nb_checkpoints, pf.est_time_ms);
+
+  return nb_checkpoints;
+}
+
+#endif /* PATH_GRID_ENABLE */
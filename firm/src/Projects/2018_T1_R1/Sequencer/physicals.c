@@ -27,6 +27,18 @@ phys_t phys;
 extern match_t match;
 extern robot_t robot;
 extern path_t pf; // temp
+extern TaskHandle_t handle_task_sequencer;
+
+// Last positions of the opponents given to the path-finder, used to predict
+// where they are going
+static poi_t opp_last_pos[2];
+static TickType_t opp_last_tick[2];
+static bool opp_last_valid[2];
+
+// Local, Private functions
+static void phys_set_opponent_poly(uint8_t robot_idx, int16_t x, int16_t y);
+static void phys_set_opponent_hazards(uint8_t opp, int16_t x, int16_t y);
+static void phys_request_path_check(void);
 
 // -----------------------------------------------------------------------------
 // INITIALIZE GAME ELEMENTS COORDINATES
@@ -131,8 +143,13 @@ void phys_init(void)
   // Define static & dynamic obstacles positions
   phys_set_obstacle_positions();
   phys_set_teammate_position(robot.teammate_pos.x, robot.teammate_pos.y);
-  phys_set_opponent_position(1, robot.opp1_pos.x, robot.opp1_pos.y);
-  phys_set_opponent_position(2, robot.opp2_pos.x, robot.opp2_pos.y);
+
+  // Opponents initial guesses: polygons only, no soft costs until they are
+  // actually detected (see phys_set_opponent_hazards())
+  path_lock();
+  phys_set_opponent_poly(1, robot.opp1_pos.x, robot.opp1_pos.y);
+  phys_set_opponent_poly(2, robot.opp2_pos.x, robot.opp2_pos.y);
+  path_unlock();
 }
 
 // Update POIs depending on the match color
@@ -156,6 +173,17 @@ void phys_update_color_polys(void)
   phys_update_with_color_poly(phys.pf_teammate);
   phys_update_with_color_poly(phys.pf_opponent1);
   phys_update_with_color_poly(phys.pf_opponent2);
+
+  // Soft costs around the opponents are dropped: the mirrored positions
+  // are guesses, and cannot be used for a prediction with the next ones
+  opp_last_valid[0] = false;
+  opp_last_valid[1] = false;
+  path_clear_hazard(0);
+  path_clear_hazard(1);
+  path_clear_hazard(2);
+  path_clear_hazard(3);
+
+  path_new_epoch();
 }
 
 // -----------------------------------------------------------------------------
@@ -215,14 +243,26 @@ void phys_update_with_color_poly(path_poly_t* poly) {
   int16_t x;
   int16_t y;
 
+  // Inflated polygons: mirror their true geometry, they are inflated again
+  if(poly->src_n)
+  {
+    for(idx_pt = 0; idx_pt < poly->src_n; idx_pt++)
+    {
+      x = poly->src[idx_pt].x;
+      y = poly->src[idx_pt].y;
+      phys_update_with_color_xy(&x, &y);
+      path_poly_set_src_points(poly, idx_pt, x, y);
+    }
+    return;
+  }
+
+  // Points are redefined through the path-finder so the polygon is flagged as moved
   for(idx_pt = 0; idx_pt < poly->n; idx_pt++)
   {
     x = (int16_t) 10*poly->pts[idx_pt].x;
     y = (int16_t) 10*poly->pts[idx_pt].y;
     phys_update_with_color_xy(&x, &y);
-    poly->pts[idx_pt].x = (int32_t) x/10;
-    poly->pts[idx_pt].y = (int32_t) y/10;
-
+    path_poly_set_points(poly, idx_pt, x, y);
   }
 }
 
@@ -312,28 +352,34 @@ void phys_set_obstacle_positions(void) {
   // Path-finding static polygons
   // -----------------------------
 
+  // Static polygons are given with their true geometry (inflated by the
+  // path-finder), their corners are bevelled with 2 points.
+
   // Opponent starting area (also includes the border)
-  phys.pf_opp_start_zone = path_add_new_poly(4);
-  path_poly_set_points(phys.pf_opp_start_zone, 0, TABLE_X_MAX - 400 - ROBOT_RADIUS 	, 0);
-  path_poly_set_points(phys.pf_opp_start_zone, 1, TABLE_X_MAX       				, 0);
-  path_poly_set_points(phys.pf_opp_start_zone, 2, TABLE_X_MAX       				, 650 + ROBOT_RADIUS);
-  path_poly_set_points(phys.pf_opp_start_zone, 3, TABLE_X_MAX - 400 - ROBOT_RADIUS 	, 650 + ROBOT_RADIUS);
+  phys.pf_opp_start_zone = path_add_new_inflated_poly(4, 8, PHYS_PF_MARGIN);
+  path_poly_set_src_points(phys.pf_opp_start_zone, 0, TABLE_X_MAX - 400 	, 0);
+  path_poly_set_src_points(phys.pf_opp_start_zone, 1, TABLE_X_MAX       	, 0);
+  path_poly_set_src_points(phys.pf_opp_start_zone, 2, TABLE_X_MAX       	, 650);
+  path_poly_set_src_points(phys.pf_opp_start_zone, 3, TABLE_X_MAX - 400 	, 650);
+  path_poly_set_static(phys.pf_opp_start_zone, true);
 
   // Treatment plant
-  phys.pf_treatment_plant = path_add_new_poly(4);
-  path_poly_set_points(phys.pf_treatment_plant, 0, 2106 + ROBOT_RADIUS 	, TABLE_Y_MAX);
-  path_poly_set_points(phys.pf_treatment_plant, 1, 2106 + ROBOT_RADIUS 	, TABLE_Y_MAX - 250 - ROBOT_RADIUS);
-  path_poly_set_points(phys.pf_treatment_plant, 2, 894 - ROBOT_RADIUS 	, TABLE_Y_MAX - 250 - ROBOT_RADIUS);
-  path_poly_set_points(phys.pf_treatment_plant, 3, 894 - ROBOT_RADIUS 	, TABLE_Y_MAX);
+  phys.pf_treatment_plant = path_add_new_inflated_poly(4, 8, PHYS_PF_MARGIN);
+  path_poly_set_src_points(phys.pf_treatment_plant, 0, 2106 	, TABLE_Y_MAX);
+  path_poly_set_src_points(phys.pf_treatment_plant, 1, 2106 	, TABLE_Y_MAX - 250);
+  path_poly_set_src_points(phys.pf_treatment_plant, 2, 894 	, TABLE_Y_MAX - 250);
+  path_poly_set_src_points(phys.pf_treatment_plant, 3, 894 	, TABLE_Y_MAX);
+  path_poly_set_static(phys.pf_treatment_plant, true);
 
   // Path-finding dynamic polygons
   // -----------------------------
 
   // Other robots:
-  // They are all represented as an octogon with identical segments length.
-  phys.pf_teammate  = path_add_new_poly(8);
-  phys.pf_opponent1 = path_add_new_poly(8);
-  phys.pf_opponent2 = path_add_new_poly(8);
+  // They are all represented as an octogon with identical segments length,
+  // inflated with the same number of points.
+  phys.pf_teammate  = path_add_new_inflated_poly(8, 8, PHYS_PF_MARGIN);
+  phys.pf_opponent1 = path_add_new_inflated_poly(8, 8, PHYS_PF_MARGIN);
+  phys.pf_opponent2 = path_add_new_inflated_poly(8, 8, PHYS_PF_MARGIN);
   
 }
 
@@ -355,46 +401,299 @@ void phys_set_obstacle_positions(void) {
 
 */
 
+// The robots positions are only set by phys_init() (best guesses) for now:
+// no sensor gives them during the match (do_avoidance() is disabled and the
+// beacons are not decoded). The followed path check below is ready for such
+// a source, and inert until then.
+
+// The followed path is checked by the sequencer (see ai_manage()), the search
+// must not run in the task updating the obstacles
+static void phys_request_path_check(void)
+{
+  if(handle_task_sequencer != NULL)
+    xTaskNotify(handle_task_sequencer, OS_NOTIFY_PATH_CHECK, eSetBits);
+}
+
 // Redefine the path-finder polygon associated with the teammate's robot
 void phys_set_teammate_position(int16_t x, int16_t y)
 {
-  path_poly_set_points(phys.pf_teammate, 0, x -   TEAMMATE_SIZE/2,  y - 3*TEAMMATE_SIZE/2);
-  path_poly_set_points(phys.pf_teammate, 1, x +   TEAMMATE_SIZE/2,  y - 3*TEAMMATE_SIZE/2);
-  path_poly_set_points(phys.pf_teammate, 2, x + 3*TEAMMATE_SIZE/2,  y -   TEAMMATE_SIZE/2);
-  path_poly_set_points(phys.pf_teammate, 3, x + 3*TEAMMATE_SIZE/2,  y +   TEAMMATE_SIZE/2);
-  path_poly_set_points(phys.pf_teammate, 4, x +   TEAMMATE_SIZE/2,  y + 3*TEAMMATE_SIZE/2);
-  path_poly_set_points(phys.pf_teammate, 5, x -   TEAMMATE_SIZE/2,  y + 3*TEAMMATE_SIZE/2);
-  path_poly_set_points(phys.pf_teammate, 6, x - 3*TEAMMATE_SIZE/2,  y +   TEAMMATE_SIZE/2);
-  path_poly_set_points(phys.pf_teammate, 7, x - 3*TEAMMATE_SIZE/2,  y -   TEAMMATE_SIZE/2);
+  path_lock();
+
+  path_poly_set_src_points(phys.pf_teammate, 0, x -   TEAMMATE_SIZE/2,  y - 3*TEAMMATE_SIZE/2);
+  path_poly_set_src_points(phys.pf_teammate, 1, x +   TEAMMATE_SIZE/2,  y - 3*TEAMMATE_SIZE/2);
+  path_poly_set_src_points(phys.pf_teammate, 2, x + 3*TEAMMATE_SIZE/2,  y -   TEAMMATE_SIZE/2);
+  path_poly_set_src_points(phys.pf_teammate, 3, x + 3*TEAMMATE_SIZE/2,  y +   TEAMMATE_SIZE/2);
+  path_poly_set_src_points(phys.pf_teammate, 4, x +   TEAMMATE_SIZE/2,  y + 3*TEAMMATE_SIZE/2);
+  path_poly_set_src_points(phys.pf_teammate, 5, x -   TEAMMATE_SIZE/2,  y + 3*TEAMMATE_SIZE/2);
+  path_poly_set_src_points(phys.pf_teammate, 6, x - 3*TEAMMATE_SIZE/2,  y +   TEAMMATE_SIZE/2);
+  path_poly_set_src_points(phys.pf_teammate, 7, x - 3*TEAMMATE_SIZE/2,  y -   TEAMMATE_SIZE/2);
+
+  // Previously computed paths may not be valid anymore
+  path_new_epoch();
+
+  path_unlock();
+
+  // The followed one too
+  phys_request_path_check();
 }
 
-// Redefine the path-finder polygon associated with the opponent's robot
+// Redefine the path-finder polygon associated with the opponent's robot, and
+// its soft costs: the position comes from a detection
 void phys_set_opponent_position(uint8_t robot_idx, int16_t x, int16_t y)
 {
+  path_lock();
+
+  phys_set_opponent_poly(robot_idx, x, y);
+  phys_set_opponent_hazards((robot_idx == 1) ? 0 : 1, x, y);
+
+  // Previously computed paths may not be valid anymore
+  path_new_epoch();
+
+  path_unlock();
 
+  // The followed one too
+  phys_request_path_check();
+}
+
+// Set the points of an opponent's polygon (path-finder locked)
+static void phys_set_opponent_poly(uint8_t robot_idx, int16_t x, int16_t y)
+{
   // Primary robot
   if(robot_idx == 1) {
-    path_poly_set_points(phys.pf_opponent1, 0, x -   OPPONENT1_SIZE/2,  y - 3*OPPONENT1_SIZE/2);
-    path_poly_set_points(phys.pf_opponent1, 1, x +   OPPONENT1_SIZE/2,  y - 3*OPPONENT1_SIZE/2);
-    path_poly_set_points(phys.pf_opponent1, 2, x + 3*OPPONENT1_SIZE/2,  y -   OPPONENT1_SIZE/2);
-    path_poly_set_points(phys.pf_opponent1, 3, x + 3*OPPONENT1_SIZE/2,  y +   OPPONENT1_SIZE/2);
-    path_poly_set_points(phys.pf_opponent1, 4, x +   OPPONENT1_SIZE/2,  y + 3*OPPONENT1_SIZE/2);
-    path_poly_set_points(phys.pf_opponent1, 5, x -   OPPONENT1_SIZE/2,  y + 3*OPPONENT1_SIZE/2);
-    path_poly_set_points(phys.pf_opponent1, 6, x - 3*OPPONENT1_SIZE/2,  y +   OPPONENT1_SIZE/2);
-    path_poly_set_points(phys.pf_opponent1, 7, x - 3*OPPONENT1_SIZE/2,  y -   OPPONENT1_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent1, 0, x -   OPPONENT1_SIZE/2,  y - 3*OPPONENT1_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent1, 1, x +   OPPONENT1_SIZE/2,  y - 3*OPPONENT1_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent1, 2, x + 3*OPPONENT1_SIZE/2,  y -   OPPONENT1_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent1, 3, x + 3*OPPONENT1_SIZE/2,  y +   OPPONENT1_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent1, 4, x +   OPPONENT1_SIZE/2,  y + 3*OPPONENT1_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent1, 5, x -   OPPONENT1_SIZE/2,  y + 3*OPPONENT1_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent1, 6, x - 3*OPPONENT1_SIZE/2,  y +   OPPONENT1_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent1, 7, x - 3*OPPONENT1_SIZE/2,  y -   OPPONENT1_SIZE/2);
 
     // Secondary robot: smaller lengths
   } else {
-    path_poly_set_points(phys.pf_opponent2, 0, x -   OPPONENT2_SIZE/2,  y - 3*OPPONENT2_SIZE/2);
-    path_poly_set_points(phys.pf_opponent2, 1, x +   OPPONENT2_SIZE/2,  y - 3*OPPONENT2_SIZE/2);
-    path_poly_set_points(phys.pf_opponent2, 2, x + 3*OPPONENT2_SIZE/2,  y -   OPPONENT2_SIZE/2);
-    path_poly_set_points(phys.pf_opponent2, 3, x + 3*OPPONENT2_SIZE/2,  y +   OPPONENT2_SIZE/2);
-    path_poly_set_points(phys.pf_opponent2, 4, x +   OPPONENT2_SIZE/2,  y + 3*OPPONENT2_SIZE/2);
-    path_poly_set_points(phys.pf_opponent2, 5, x -   OPPONENT2_SIZE/2,  y + 3*OPPONENT2_SIZE/2);
-    path_poly_set_points(phys.pf_opponent2, 6, x - 3*OPPONENT2_SIZE/2,  y +   OPPONENT2_SIZE/2);
-    path_poly_set_points(phys.pf_opponent2, 7, x - 3*OPPONENT2_SIZE/2,  y -   OPPONENT2_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent2, 0, x -   OPPONENT2_SIZE/2,  y - 3*OPPONENT2_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent2, 1, x +   OPPONENT2_SIZE/2,  y - 3*OPPONENT2_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent2, 2, x + 3*OPPONENT2_SIZE/2,  y -   OPPONENT2_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent2, 3, x + 3*OPPONENT2_SIZE/2,  y +   OPPONENT2_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent2, 4, x +   OPPONENT2_SIZE/2,  y + 3*OPPONENT2_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent2, 5, x -   OPPONENT2_SIZE/2,  y + 3*OPPONENT2_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent2, 6, x - 3*OPPONENT2_SIZE/2,  y +   OPPONENT2_SIZE/2);
+    path_poly_set_src_points(phys.pf_opponent2, 7, x - 3*OPPONENT2_SIZE/2,  y -   OPPONENT2_SIZE/2);
   }
-  
+}
+
+// Define the path-finder soft costs around an opponent (0 or 1): its position
+// and the one predicted from its speed, estimated with its previous position.
+// Paths going close to them are charged, even outside of their polygon, so
+// that they are avoided when possible instead of stopping on a detection.
+// Only set from detections: the initial guesses of phys_init() and their
+// mirroring at the color update leave the paths uncharged.
+static void phys_set_opponent_hazards(uint8_t opp, int16_t x, int16_t y)
+{
+  TickType_t now = xTaskGetTickCount();
+  float dt_ms = (float) (now - opp_last_tick[opp]) * portTICK_PERIOD_MS;
+  float vx;
+  float vy;
+  float speed;
+
+  if(opp == 0) {
+    robot.opp1_pos.x = x;
+    robot.opp1_pos.y = y;
+  } else {
+    robot.opp2_pos.x = x;
+    robot.opp2_pos.y = y;
+  }
+
+  path_set_hazard(2*opp, x, y, PHYS_PF_OPP_RADIUS, PHYS_PF_OPP_PENALTY_MS, PHYS_PF_OPP_MAX_AGE_MS);
+
+  // Speed (mm/ms) from the previous position, when it is recent enough
+  if(opp_last_valid[opp] && (dt_ms > 0) && (dt_ms < PHYS_PF_OPP_MAX_AGE_MS)) {
+    vx = (x - opp_last_pos[opp].x) / dt_ms;
+    vy = (y - opp_last_pos[opp].y) / dt_ms;
+    speed = sqrtf(vx * vx + vy * vy);
+
+    // A bad detection should not throw the prediction across the table
+    if(speed > PHYS_PF_OPP_MAX_SPEED / 1000.0f) {
+      vx *= PHYS_PF_OPP_MAX_SPEED / 1000.0f / speed;
+      vy *= PHYS_PF_OPP_MAX_SPEED / 1000.0f / speed;
+    }
+
+    path_set_hazard(2*opp + 1, x + vx * PHYS_PF_OPP_PREDICT_MS, y + vy * PHYS_PF_OPP_PREDICT_MS,
+                    PHYS_PF_OPP_RADIUS, PHYS_PF_OPP_PREDICT_PENALTY_MS, PHYS_PF_OPP_MAX_AGE_MS);
+  } else {
+    path_clear_hazard(2*opp + 1);
+  }
+
+  opp_last_pos[opp].x = x;
+  opp_last_pos[opp].y = y;
+  opp_last_tick[opp] = now;
+  opp_last_valid[opp] = true;
+}
+
+// -----------------------------------------------------------------------------
+// PATH-FINDING POI TABLE
+// -----------------------------------------------------------------------------
+
+// Index of the path between 2 POIs (lo < hi) in the table
+#define PHYS_POI_PAIR_IDX(lo, hi) ((lo)*PHYS_NB_POI_PATHS - (lo)*((lo)+1)/2 + (hi) - (lo) - 1)
+
+_Static_assert(sizeof(phys_poi_path_t) * PHYS_NB_POI_PAIRS <= PATH_POI_PATHS_RAM_BUDGET,
+               "POI paths table exceeds PATH_POI_PATHS_RAM_BUDGET (path_config.h)");
+
+// Compute the paths between each pair of the main POIs, on the static map.
+// Must be called once the color is known (POIs and polygons updated).
+// The path-finder is only locked for one pair at a time, the table being
+// emptied first: meanwhile, the paths not computed yet are searched.
+void phys_build_poi_paths(void)
+{
+  uint8_t i;
+  uint8_t j;
+  uint8_t k;
+  int8_t nb_checkpoints;
+  uint8_t nb_paths = 0;
+  phys_poi_path_t* path = phys.pf_poi_paths;
+  poi_t prev;
+
+  path_lock();
+
+  // POIs used as destinations, they are transformed with the color the same
+  // way than ai_move_with_pf() does with its destination.
+  phys.pf_pois[0]  = phys.reset;
+  phys.pf_pois[1]  = phys.exit_start;
+  phys.pf_pois[2]  = phys.beehive;
+  phys.pf_pois[3]  = phys.home_automation_switch;
+  phys.pf_pois[4]  = phys.wastewater_recuperator;
+  phys.pf_pois[5]  = phys.mixed_wastewater_recuperator[PHYS_ID_MIXED_G];
+  phys.pf_pois[6]  = phys.mixed_wastewater_recuperator[PHYS_ID_MIXED_O];
+  phys.pf_pois[7]  = phys.construction_cubes[PHYS_ID_CUBES_WG];
+  phys.pf_pois[8]  = phys.construction_cubes[PHYS_ID_CUBES_SG];
+  phys.pf_pois[9]  = phys.construction_cubes[PHYS_ID_CUBES_EG];
+  phys.pf_pois[10] = phys.construction_cubes[PHYS_ID_CUBES_WO];
+  phys.pf_pois[11] = phys.construction_cubes[PHYS_ID_CUBES_NO];
+  phys.pf_pois[12] = phys.construction_cubes[PHYS_ID_CUBES_EO];
+
+  for(i = 0; i < PHYS_NB_POI_PATHS; i++) {
+    phys_update_with_color_xy(&phys.pf_pois[i].x, &phys.pf_pois[i].y);
+  }
+
+  for(k = 0; k < PHYS_NB_POI_PAIRS; k++) {
+    phys.pf_poi_paths[k].nb_checkpoints = PATH_RESULT_ERROR;
+  }
+
+  path_unlock();
+
+  for(i = 0; i < PHYS_NB_POI_PATHS; i++)
+  {
+    for(j = i+1; j < PHYS_NB_POI_PATHS; j++, path++)
+    {
+      path_lock();
+
+      // Robots are not taken into account, nor their heading (paths are used
+      // in both directions)
+      path_set_static_only(true);
+      path_set_heading(PATH_HEADING_NONE);
+
+      path_set_objective(phys.pf_pois[i].x, phys.pf_pois[i].y,
+                         phys.pf_pois[j].x, phys.pf_pois[j].y);
+      nb_checkpoints = path_process();
+
+      path_set_static_only(false);
+
+      path->distance = 0;
+
+      if(nb_checkpoints == PATH_RESULT_ERROR) {
+        path_unlock();
+        continue;
+      }
+
+      // Last checkpoint is the destination itself, it is not stored
+      prev = phys.pf_pois[i];
+      for(k = 0; k < nb_checkpoints; k++)
+      {
+        if(k < nb_checkpoints - 1)
+          path->checkpoints[k] = pf.u.res[k];
+
+        path->distance += (uint16_t) sqrt((pf.u.res[k].x - prev.x) * (pf.u.res[k].x - prev.x) +
+                                          (pf.u.res[k].y - prev.y) * (pf.u.res[k].y - prev.y));
+        prev = pf.u.res[k];
+      }
+
+      path->nb_checkpoints = nb_checkpoints - 1;
+      nb_paths++;
+
+      path_unlock();
+    }
+  }
+
+  DEBUG_INFO("[PHYS] POI paths table: %u/%u paths"DEBUG_EOL, nb_paths, PHYS_NB_POI_PAIRS);
+}
+
+// Find the POI of the table located at the given coordinates (within the
+// tolerance). Returns its index, or -1 if there is none.
+static int8_t phys_find_poi(int16_t x, int16_t y)
+{
+  uint8_t idx;
+
+  for(idx = 0; idx < PHYS_NB_POI_PATHS; idx++)
+  {
+    if(ABS(x - phys.pf_pois[idx].x) <= PHYS_POI_PATH_TOLERANCE &&
+       ABS(y - phys.pf_pois[idx].y) <= PHYS_POI_PATH_TOLERANCE)
+      return idx;
+  }
+
+  return -1;
+}
+
+// Get the path between 2 POIs from the table.
+// The path is only used if none of its segments, starting from the actual
+// source point, crosses a polygon (robots included).
+// The checkpoints are stored in the path-finder result, destination included,
+// as path_process() does.
+// Returns the number of checkpoints, or PATH_RESULT_ERROR if the path must be
+// computed.
+int8_t phys_get_poi_path(int16_t src_x, int16_t src_y, int16_t dst_x, int16_t dst_y)
+{
+  int8_t src;
+  int8_t dst;
+  uint8_t k;
+  int16_t x = src_x;
+  int16_t y = src_y;
+  const phys_poi_path_t* path;
+
+  src = phys_find_poi(src_x, src_y);
+  dst = phys_find_poi(dst_x, dst_y);
+
+  if(src < 0 || dst < 0 || src == dst)
+    return PATH_RESULT_ERROR;
+
+  path = &phys.pf_poi_paths[PHYS_POI_PAIR_IDX(MIN(src, dst), MAX(src, dst))];
+
+  if(path->nb_checkpoints == PATH_RESULT_ERROR)
+    return PATH_RESULT_ERROR;
+
+  // Stored paths start from the POI with the lowest index
+  for(k = 0; k < path->nb_checkpoints; k++)
+  {
+    pf.u.res[k] = path->checkpoints[(src < dst) ? k : path->nb_checkpoints - 1 - k];
+  }
+  pf.u.res[k].x = dst_x;
+  pf.u.res[k].y = dst_y;
+
+  // Check that the path is still free
+  for(k = 0; k <= path->nb_checkpoints; k++)
+  {
+    if(!path_is_segment_free(x, y, pf.u.res[k].x, pf.u.res[k].y))
+      return PATH_RESULT_ERROR;
+
+    x = pf.u.res[k].x;
+    y = pf.u.res[k].y;
+  }
+
+  // The robot is not exactly on the POI, some checkpoints may not be needed
+  path_smooth(src_x, src_y, path->nb_checkpoints + 1);
+  path_estimate_time(src_x, src_y, pf.nb_checkpoint);
+
+  return pf.nb_checkpoint;
 }
 
 // -----------------------------------------------------------------------------
@@ -423,11 +722,13 @@ void phys_pf_poly_to_str(path_poly_t* poly, uint8_t idx_poly, char* str, size_t
 void phys_pf_path_to_str(char* ret, size_t len)
 {
   uint8_t idx_checkpoint;
+  struct robot_pose pose;
 
   // Add the robot current position
+  motion_get_pose(&pose);
   snprintf(ret, len, "[PHYS] [PATH] %d;%d ",
-           robot.cs.pos.pos_s16.x,
-           robot.cs.pos.pos_s16.y);
+           pose.pos_s16.x,
+           pose.pos_s16.y);
   ret += strlen(ret);
 
   // Print each checkpoint if result is valid
@@ -0,0 +1,144 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       planner.c
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Background path planner.
+ *   During the match, this low priority task uses the idle time of the CPU to
+ *   compute the paths to the best ranked AI tasks, from the destination of the
+ *   running task (or from the robot position when nothing is running).
+ *   Paths are kept in the path-finder results cache, so that the next
+ *   ai_move_with_pf() finds them without any search.
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#include "../../2018_T1_R1/include/main.h"
+
+/**
+********************************************************************************
+**
+**  Globals
+**
+********************************************************************************
+*/
+
+// Planner task handle
+TaskHandle_t handle_task_planner;
+
+// External definitions
+extern robot_t robot;
+extern match_t match;
+extern task_mgt_t task_mgt;
+
+// Local, Private functions
+static void planner_task(void *pvParameters);
+static bool planner_plan_next(TickType_t start_time);
+
+/**
+********************************************************************************
+**
+**  Initialization
+**
+********************************************************************************
+*/
+
+BaseType_t planner_start(void)
+{
+  return sys_create_task(planner_task, "PLANNER", OS_TASK_STACK_PLANNER, NULL, OS_TASK_PRIORITY_PLANNER, &handle_task_planner);
+}
+
+/**
+********************************************************************************
+**
+**  Planning
+**
+********************************************************************************
+*/
+
+// Compute the path to the best ranked task which has no path in the results
+// cache yet. The path-finder is locked for one search only, so a motion request
+// never waits for more than that.
+// Returns true when a path has been computed.
+static bool planner_plan_next(TickType_t start_time)
+{
+  task_t* candidates[PLANNER_NB_CANDIDATES];
+  task_t* active = task_mgt.active_task;
+  uint8_t nb_candidates;
+  uint8_t idx;
+  int16_t src_x;
+  int16_t src_y;
+  int16_t dst_x;
+  int16_t dst_y;
+  struct robot_pose pose;
+  bool planned = false;
+
+  nb_candidates = task_get_ranked(candidates, PLANNER_NB_CANDIDATES);
+
+  path_lock();
+
+  // The next motion starts where the running task goes, with an unknown heading
+  if((active != NULL) && (active->state == TASK_STATE_RUNNING) &&
+     ai_get_task_dest(active, &src_x, &src_y)) {
+    path_set_heading(PATH_HEADING_NONE);
+  } else {
+    motion_get_pose(&pose);
+    src_x = pose.pos_s16.x;
+    src_y = pose.pos_s16.y;
+    path_set_heading(pose.pos_s16.a);
+  }
+
+  for(idx = 0; idx < nb_candidates; idx++) {
+
+    if((candidates[idx] == active) || (candidates[idx]->travel_ms == PATH_TIME_UNREACHABLE) ||
+       !ai_get_task_dest(candidates[idx], &dst_x, &dst_y))
+      continue;
+
+    // Same destination and motion than the ai_move_with_pf() of the task,
+    // which the results cache is keyed on
+    path_set_motion(candidates[idx]->dest_speed, candidates[idx]->dest_type);
+
+    if(path_has_result(src_x, src_y, dst_x, dst_y))
+      continue;
+
+    path_find(src_x, src_y, dst_x, dst_y);
+    planned = true;
+
+    DEBUG_INFO("[PLANNER] Path to task %u, %lu ms"DEBUG_EOL,
+               candidates[idx]->id, xTaskGetTickCount() - start_time);
+    break;
+  }
+
+  path_unlock();
+
+  return planned;
+}
+
+void planner_task(void *pvParameters)
+{
+  TickType_t next_wake_time = xTaskGetTickCount();
+  TickType_t start_time;
+
+  // Remove compiler warning about unused parameter.
+  ( void ) pvParameters;
+
+  for( ;; )
+  {
+    vTaskDelayUntil(&next_wake_time, pdMS_TO_TICKS(OS_PLANNER_PERIOD_MS));
+
+    if((match.state != MATCH_STATE_RUN) || match.paused)
+      continue;
+
+    // Plan as many paths as the budget allows, a new search is not started
+    // once the budget is spent.
+    start_time = xTaskGetTickCount();
+    while(planner_plan_next(start_time) &&
+          (xTaskGetTickCount() - start_time < pdMS_TO_TICKS(OS_PLANNER_BUDGET_MS)));
+  }
+}
@@ -114,6 +114,7 @@ void sequencer_task( void *pvParameters )
   path_init();
   phys_init();
   tasks_init();
+  planner_start();
 
   // Sequencer main loop
   for( ;; )
@@ -50,6 +50,11 @@ void tasks_init(void)
     tasks[id].state = TASK_STATE_INACTIVE;
     tasks[id].nb_dependencies = 0;
     tasks[id].trials = 0;
+    tasks[id].dest = NULL;
+    tasks[id].dest_speed = WP_SPEED_NORMAL;
+    tasks[id].dest_type = WP_GOTO_FWD;
+    tasks[id].duration_ms = TASK_DEFAULT_DURATION_MS;
+    tasks[id].travel_ms = 0;
   }
 
   // Define AI Tasks
@@ -136,6 +141,36 @@ task_t* task_get_next(void) {
 
 }
 
+// Get the valid tasks ordered by decreasing priority, as they were computed by
+// the last call to task_get_next(). At most nb_tasks are kept.
+// Returns the number of tasks put in the ranked array.
+uint8_t task_get_ranked(task_t** ranked, uint8_t nb_tasks) {
+
+  task_t* task;
+  uint8_t nb_ranked = 0;
+  uint8_t idx;
+
+  for(task = tasks; task < tasks + TASKS_NB; task++) {
+
+    if(!task_is_valid(task))
+      continue;
+
+    // Insert the task in the ranked array, dropping the lowest one if full
+    for(idx = nb_ranked; (idx > 0) && (ranked[idx-1]->priority < task->priority); idx--) {
+      if(idx < nb_tasks)
+        ranked[idx] = ranked[idx-1];
+    }
+
+    if(idx < nb_tasks) {
+      ranked[idx] = task;
+      if(nb_ranked < nb_tasks)
+        nb_ranked++;
+    }
+  }
+
+  return nb_ranked;
+}
+
 
 // Add a dependency to the task's array
 void task_add_dep(task_t* task, task_t* dep) {
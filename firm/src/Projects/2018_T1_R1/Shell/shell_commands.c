@@ -241,6 +241,10 @@ static const CLI_Command_Definition_t xAvs =
     "avs [command] [value1]... [valueN]: Run an Aversive command."SHELL_EOL
     " List of available commands:"SHELL_EOL
     "  - [cmd1] [value1] [value2]"SHELL_EOL
+    "  - cs: control-system processing time against its budget"SHELL_EOL
+    "  - csclr: clear the control-system processing time statistics"SHELL_EOL
+    "  - math: cost and accuracy of the motion trigonometry"SHELL_EOL
+    "  - traj: trajectory command latency and heap usage"SHELL_EOL
     ,OS_SHL_AvsCmd,
     -1 // Variable
 };
@@ -265,6 +269,11 @@ static const CLI_Command_Definition_t xSeq =
     "seq [command] [value1]... [valueN]: Run a Sequencer command."SHELL_EOL
     " List of available commands:"SHELL_EOL
     "  - [cmd1] [value1] [value2]"SHELL_EOL
+    "  - pfbench [scenarios] [seed]: path-finder benchmark (CSV)"SHELL_EOL
+    "  - pfmem: path-finder RAM usage"SHELL_EOL
+#if PATH_GRID_ENABLE
+    "  - pfgrid [0/1]: path-finder on the visibility graph (0) or on the grid (1)"SHELL_EOL
+#endif
     ,OS_SHL_SeqCmd,
     -1 // Variable
 };
@@ -642,7 +651,7 @@ static BaseType_t OS_SHL_MotCmd( char *pcWriteBuffer, size_t xWriteBufferLen, co
                 snprintf( pcWriteBuffer, xWriteBufferLen, SHELL_MOT_PFX"Goto Auto (%d;%d)"SHELL_EOL, wp.coord.abs.x, wp.coord.abs.y);
                 pcWriteBuffer += strlen(pcWriteBuffer);
                 wp.type = WP_GOTO_AUTO;
-                //motion_add_new_wp(&wp);
+                //motion_add_new_wp(&wp, NULL);
                 ai_move_with_pf(&wp);
                 phys_pf_path_to_str(pcWriteBuffer, xWriteBufferLen);
 
@@ -652,14 +661,14 @@ static BaseType_t OS_SHL_MotCmd( char *pcWriteBuffer, size_t xWriteBufferLen, co
               snprintf( pcWriteBuffer, xWriteBufferLen, SHELL_MOT_PFX"Goto Forward (%d;%d)"SHELL_EOL, wp.coord.abs.x, wp.coord.abs.y);
               pcWriteBuffer += strlen(pcWriteBuffer);
               wp.type = WP_GOTO_FWD;
-              motion_add_new_wp(&wp);
+              motion_add_new_wp(&wp, NULL);
             }
 
             else if((!strcasecmp(command, "goto_bwd")) && (lParameterNumber == 4)) {
               snprintf( pcWriteBuffer, xWriteBufferLen, SHELL_MOT_PFX"Goto Backward (%d;%d)"SHELL_EOL, wp.coord.abs.x, wp.coord.abs.y);
               pcWriteBuffer += strlen(pcWriteBuffer);
               wp.type = WP_GOTO_BWD;
-              motion_add_new_wp(&wp);
+              motion_add_new_wp(&wp, NULL);
             }
 
             // Turnto Cases
@@ -667,14 +676,14 @@ static BaseType_t OS_SHL_MotCmd( char *pcWriteBuffer, size_t xWriteBufferLen, co
               snprintf( pcWriteBuffer, xWriteBufferLen, SHELL_MOT_PFX"Turnto Front (%d;%d)"SHELL_EOL, wp.coord.abs.x, wp.coord.abs.y);
               pcWriteBuffer += strlen(pcWriteBuffer);
               wp.type = WP_ORIENT_FRONT;
-              motion_add_new_wp(&wp);
+              motion_add_new_wp(&wp, NULL);
             }
 
             else if((!strcasecmp(command, "turnto_behind")) && (lParameterNumber == 4)) {
               snprintf( pcWriteBuffer, xWriteBufferLen, SHELL_MOT_PFX"Turnto Behind (%d;%d)"SHELL_EOL, wp.coord.abs.x, wp.coord.abs.y);
               pcWriteBuffer += strlen(pcWriteBuffer);
               wp.type = WP_ORIENT_BEHIND;
-              motion_add_new_wp(&wp);
+              motion_add_new_wp(&wp, NULL);
             }
 
             // Stop/Break
@@ -1312,9 +1321,43 @@ static BaseType_t OS_SHL_LedCmd( char *pcWriteBuffer, size_t xWriteBufferLen, co
     return pdFALSE;
 }
 
+// avs [cmd]
 static BaseType_t OS_SHL_AvsCmd( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
+  char* command;
+  BaseType_t command_str_length;
+
+  // Nothing to display by default
+  memset( pcWriteBuffer, 0x00, xWriteBufferLen );
+
+  command = (char*) FreeRTOS_CLIGetParameter(pcCommandString, 1, &command_str_length);
+  if(command == NULL) {
+    snprintf( pcWriteBuffer, xWriteBufferLen, SHELL_ERR_PFX"Missing command"SHELL_EOL);
     return pdFALSE;
+  }
+
+  // Control-system processing time
+  if(!strncasecmp(command, "csclr", strlen("csclr"))) {
+    motion_cs_stats_reset();
+  }
+
+  else if(!strncasecmp(command, "cs", strlen("cs"))) {
+    motion_cs_stats_print(pcWriteBuffer, xWriteBufferLen);
+  }
+
+  else if(!strncasecmp(command, "math", strlen("math"))) {
+    motion_cs_math_bench_print(pcWriteBuffer, xWriteBufferLen);
+  }
+
+  else if(!strncasecmp(command, "traj", strlen("traj"))) {
+    motion_traj_stats_print(pcWriteBuffer, xWriteBufferLen);
+  }
+
+  else {
+    snprintf( pcWriteBuffer, xWriteBufferLen, SHELL_ERR_PFX"Unrecognized command '%.*s'"SHELL_EOL, (int) command_str_length, command);
+  }
+
+  return pdFALSE;
 }
 
 static BaseType_t OS_SHL_AvdCmd( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
@@ -1434,6 +1477,32 @@ static BaseType_t OS_SHL_SeqCmd( char *pcWriteBuffer, size_t xWriteBufferLen, co
         return xReturn;
       }
 
+      // Path-finder benchmark: value1 scenarios from the value2 seed
+      else if((!strcasecmp(command, "pfbench")) && (lParameterNumber == 4)) {
+
+        xReturn = path_bench_print(pcWriteBuffer, xWriteBufferLen, value1, value2);
+
+        // Cleanup when finished
+        if(xReturn == pdFALSE) {
+          lParameterNumber = 0;
+        }
+        return xReturn;
+      }
+
+      // Path-finder memory usage
+      else if((!strcasecmp(command, "pfmem")) && (lParameterNumber == 2)) {
+        path_mem_print(pcWriteBuffer, xWriteBufferLen);
+      }
+
+#if PATH_GRID_ENABLE
+      // Path-finder search backend
+      else if((!strcasecmp(command, "pfgrid")) && (lParameterNumber == 3)) {
+        path_lock();
+        path_set_backend(value1 ? PATH_BACKEND_GRID : PATH_BACKEND_VISIBILITY);
+        path_unlock();
+      }
+#endif
+
       else {
         snprintf( pcWriteBuffer, xWriteBufferLen, SHELL_ERR_PFX"Unrecognized command '%s' or parameters error"SHELL_EOL, command);
       }
@@ -28,6 +28,8 @@ extern dsv_channel_t dsv_chan2;
 extern mon_cfg_t mon_config;
 extern mon_values_t mon_values;
 
+extern path_t pf;
+
 /*
  * Variables definition list holder
  * Do not leave "unit" column empty! Leave 'NA' if not applicable
@@ -53,11 +55,13 @@ const OS_SHL_VarItemTypeDef OS_SHL_varList[] = {
          ,{"mon.cfg.shunt_ip1"          , TYPE_UINT16,  ACC_WR, &mon_config.shunt_ip1_mohm,        "mOhm"}
          ,{"mon.cfg.shunt_ip2"          , TYPE_UINT16,  ACC_WR, &mon_config.shunt_ip2_mohm,        "mOhm"}
          ,{"mon.cfg.shunt_ip3"          , TYPE_UINT16,  ACC_WR, &mon_config.shunt_ip3_mohm,        "mOhm"}
+         ,{"mon.cfg.vbat_div"           , TYPE_UINT16,  ACC_WR, &mon_config.vbat_divider_x100,     "x100"}
          ,{"mon.val.ibat"               , TYPE_UINT32,  ACC_RD, &mon_values.ibat_ma,               "mA"}
          ,{"mon.val.ip1"                , TYPE_UINT32,  ACC_RD, &mon_values.ip1_ma,                "mA"}
          ,{"mon.val.ip2"                , TYPE_UINT32,  ACC_RD, &mon_values.ip2_ma,                "mA"}
          ,{"mon.val.ip3"                , TYPE_UINT32,  ACC_RD, &mon_values.ip3_ma,                "mA"}
          ,{"mon.val.temp"               , TYPE_INT32,   ACC_RD, &mon_values.temp,                  "degC"}
+         ,{"mon.val.vbat"               , TYPE_UINT32,  ACC_RD, &mon_values.vbat_mv,               "mV"}
 
          // Digital Servos Configuration
          ,{"dsv.nb_channels"            , TYPE_UINT8,   ACC_RD, &dsv_nb_channels,            			   "NA"}
@@ -77,6 +81,18 @@ const OS_SHL_VarItemTypeDef OS_SHL_varList[] = {
          ,{"robot.cs.qr_d.neg_speed"    , TYPE_UINT32, ACC_WR, &robot.cs.qr_d.var_1st_ord_neg,           "mm/s"}
          ,{"robot.cs.qr_d.pos_accel"    , TYPE_UINT32, ACC_WR, &robot.cs.qr_d.var_2nd_ord_pos,           "mm/s2"}
          ,{"robot.cs.qr_d.neg_accel"    , TYPE_UINT32, ACC_WR, &robot.cs.qr_d.var_2nd_ord_neg,           "mm/s2"}
+         ,{"robot.cs.qr_d.jerk"         , TYPE_UINT32, ACC_WR, &robot.cs.qr_d.var_3rd_ord,               "mm/s3"}
+         ,{"robot.cs.ff_d.kv"           , TYPE_FLOAT,  ACC_WR, &robot.cs.ff_d.kv,                        "NA"}
+         ,{"robot.cs.ff_d.ka"           , TYPE_FLOAT,  ACC_WR, &robot.cs.ff_d.ka,                        "NA"}
+         ,{"robot.cs.cascade_d"         , TYPE_BOOL,   ACC_WR, &robot.cs.cascade_d,                     "NA"}
+         ,{"robot.cs.pid_pd.kp"         , TYPE_INT16,  ACC_WR, &robot.cs.pid_pd.gain_P,                  "NA"}
+         ,{"robot.cs.pid_pd.max_out"    , TYPE_INT32,  ACC_WR, &robot.cs.pid_pd.max_out,                 "NA"}
+         ,{"robot.cs.pid_pd.out_shift"  , TYPE_UINT8,  ACC_WR, &robot.cs.pid_pd.out_shift,               "NA"}
+         ,{"robot.cs.pid_vd.kp"         , TYPE_INT16,  ACC_WR, &robot.cs.pid_vd.gain_P,                  "NA"}
+         ,{"robot.cs.pid_vd.ki"         , TYPE_INT16,  ACC_WR, &robot.cs.pid_vd.gain_I,                  "NA"}
+         ,{"robot.cs.pid_vd.max_i"      , TYPE_INT32,  ACC_WR, &robot.cs.pid_vd.max_I,                   "NA"}
+         ,{"robot.cs.pid_vd.max_out"    , TYPE_INT32,  ACC_WR, &robot.cs.pid_vd.max_out,                 "NA"}
+         ,{"robot.cs.pid_vd.out_shift"  , TYPE_UINT8,  ACC_WR, &robot.cs.pid_vd.out_shift,               "NA"}
 
          // Motion configuration for A filter
          ,{"robot.cs.pid_a.kp"          , TYPE_INT16,  ACC_WR, &robot.cs.pid_a.gain_P,                   "NA"}
@@ -91,13 +107,31 @@ const OS_SHL_VarItemTypeDef OS_SHL_varList[] = {
          ,{"robot.cs.qr_a.neg_speed"    , TYPE_UINT32, ACC_WR, &robot.cs.qr_a.var_1st_ord_neg,           "deg/s"}
          ,{"robot.cs.qr_a.pos_accel"    , TYPE_UINT32, ACC_WR, &robot.cs.qr_a.var_2nd_ord_pos,           "deg/s2"}
          ,{"robot.cs.qr_a.neg_accel"    , TYPE_UINT32, ACC_WR, &robot.cs.qr_a.var_2nd_ord_neg,           "deg/s2"}
+         ,{"robot.cs.qr_a.jerk"         , TYPE_UINT32, ACC_WR, &robot.cs.qr_a.var_3rd_ord,               "deg/s3"}
+         ,{"robot.cs.ff_a.kv"           , TYPE_FLOAT,  ACC_WR, &robot.cs.ff_a.kv,                        "NA"}
+         ,{"robot.cs.ff_a.ka"           , TYPE_FLOAT,  ACC_WR, &robot.cs.ff_a.ka,                        "NA"}
+         ,{"robot.cs.cascade_a"         , TYPE_BOOL,   ACC_WR, &robot.cs.cascade_a,                     "NA"}
+         ,{"robot.cs.pid_pa.kp"         , TYPE_INT16,  ACC_WR, &robot.cs.pid_pa.gain_P,                  "NA"}
+         ,{"robot.cs.pid_pa.max_out"    , TYPE_INT32,  ACC_WR, &robot.cs.pid_pa.max_out,                 "NA"}
+         ,{"robot.cs.pid_pa.out_shift"  , TYPE_UINT8,  ACC_WR, &robot.cs.pid_pa.out_shift,               "NA"}
+         ,{"robot.cs.pid_va.kp"         , TYPE_INT16,  ACC_WR, &robot.cs.pid_va.gain_P,                  "NA"}
+         ,{"robot.cs.pid_va.ki"         , TYPE_INT16,  ACC_WR, &robot.cs.pid_va.gain_I,                  "NA"}
+         ,{"robot.cs.pid_va.max_i"      , TYPE_INT32,  ACC_WR, &robot.cs.pid_va.max_I,                   "NA"}
+         ,{"robot.cs.pid_va.max_out"    , TYPE_INT32,  ACC_WR, &robot.cs.pid_va.max_out,                 "NA"}
+         ,{"robot.cs.pid_va.out_shift"  , TYPE_UINT8,  ACC_WR, &robot.cs.pid_va.out_shift,               "NA"}
+
+         // Motors battery voltage compensation
+         ,{"robot.cs.vbat_nominal"      , TYPE_UINT32, ACC_WR, &robot.cs.vbat_nominal_mv,                "mV"}
+         ,{"robot.cs.vbat_gain"         , TYPE_FLOAT,  ACC_RD, &robot.cs.vbat_gain,                      "NA"}
 
          // Motion feedbacks
-         ,{"robot.cs.pos.x"           , TYPE_INT16, ACC_RD, &robot.cs.pos.pos_s16.x,          "mm"}
-         ,{"robot.cs.pos.y"           , TYPE_INT16, ACC_RD, &robot.cs.pos.pos_s16.y,          "mm"}
-         ,{"robot.cs.pos.a"           , TYPE_INT16, ACC_RD, &robot.cs.pos.pos_s16.a,          "deg"}
+         ,{"robot.cs.pos.x"           , TYPE_INT16, ACC_RD, &robot.cs.pos.pose.pos_s16.x,     "mm"}
+         ,{"robot.cs.pos.y"           , TYPE_INT16, ACC_RD, &robot.cs.pos.pose.pos_s16.y,     "mm"}
+         ,{"robot.cs.pos.a"           , TYPE_INT16, ACC_RD, &robot.cs.pos.pose.pos_s16.a,     "deg"}
          ,{"robot.cs.speed.d"         , TYPE_INT16, ACC_RD, &robot.cs.speed_d,                "mm/s"}
          ,{"robot.cs.speed.a"         , TYPE_INT16, ACC_RD, &robot.cs.speed_a,                "deg/s"}
+         ,{"robot.cs.speed.l"         , TYPE_INT32, ACC_RD, &robot.cs.wheel_speed_l,          "NA"}
+         ,{"robot.cs.speed.r"         , TYPE_INT32, ACC_RD, &robot.cs.wheel_speed_r,          "NA"}
          ,{"robot.cs.accel.d"         , TYPE_INT16, ACC_RD, &robot.cs.acceleration_d,         "mm/s2"}
          ,{"robot.cs.accel.a"         , TYPE_INT16, ACC_RD, &robot.cs.acceleration_a,         "deg/s2"}
          ,{"robot.cs.cs_d.consign"    , TYPE_INT32, ACC_RD, &robot.cs.cs_d.consign_value,     "mm"}
@@ -106,6 +140,8 @@ const OS_SHL_VarItemTypeDef OS_SHL_varList[] = {
          ,{"robot.cs.cs_a.consign"    , TYPE_INT32, ACC_RD, &robot.cs.cs_a.consign_value,     "deg"}
          ,{"robot.cs.cs_a.output"     , TYPE_INT32, ACC_RD, &robot.cs.cs_a.out_value,         "deg"}
          ,{"robot.cs.cs_a.error"      , TYPE_INT32, ACC_RD, &robot.cs.cs_a.error_value,       "deg"}
+         ,{"robot.cs.pwm_l"           , TYPE_INT32, ACC_RD, &robot.cs.pwm_l,                  "NA"}
+         ,{"robot.cs.pwm_r"           , TYPE_INT32, ACC_RD, &robot.cs.pwm_r,                  "NA"}
 
          // Avoidance
          ,{"av.mask_static"         , TYPE_UINT16, ACC_RD, &av.mask_static_word,      "NA"}
@@ -113,6 +149,15 @@ const OS_SHL_VarItemTypeDef OS_SHL_varList[] = {
          ,{"av.det"                 , TYPE_UINT16, ACC_RD, &av.det_word,              "NA"}
          ,{"av.det_effective"       , TYPE_UINT16, ACC_RD, &av.det_effective_word,    "NA"}
 
+         // Path-finder
+         ,{"pf.nb_cached_rays"      , TYPE_UINT16, ACC_RD, &pf.nb_cached_rays,        "NA"}
+         ,{"pf.nb_poly_tests"       , TYPE_UINT32, ACC_RD, &pf.nb_poly_tests,         "NA"}
+         ,{"pf.nb_poly_culled"      , TYPE_UINT32, ACC_RD, &pf.nb_poly_culled,        "NA"}
+         ,{"pf.epoch"               , TYPE_UINT32, ACC_RD, &pf.epoch,                 "NA"}
+         ,{"pf.results.hits"        , TYPE_UINT32, ACC_RD, &pf.nb_results_hits,       "NA"}
+         ,{"pf.results.misses"      , TYPE_UINT32, ACC_RD, &pf.nb_results_misses,     "NA"}
+         ,{"pf.est_time"            , TYPE_UINT32, ACC_RD, &pf.est_time_ms,           "ms"}
+
 };
 const size_t OS_SHL_varListLength = sizeof(OS_SHL_varList) / sizeof(OS_SHL_VarItemTypeDef);
 
@@ -67,13 +67,9 @@
 #define DO_STATUS 64 /* status events*/
 
 // Mutexes handlers
-extern void vLockEncoderAngle(void);
-extern void vLockEncoderDistance(void);
 extern void vLockAngleConsign(void);
 extern void vLockDistanceConsign(void);
 extern void vLockRobotPosition(void);
-extern void vUnlockEncoderAngle(void);
-extern void vUnlockEncoderDistance(void);
 extern void vUnlockAngleConsign(void);
 extern void vUnlockDistanceConsign(void);
 extern void vUnlockRobotPosition(void);
@@ -95,6 +95,12 @@
 #define ADC_SHUNT_IP2_MOHM    10L
 #define ADC_SHUNT_IP3_MOHM    10L
 
+/* Battery voltage measurement, on the cell tap of the whole pack, through a
+ * resistor divider (ratio x100, default). The cell inputs suffer from a
+ * hardware bug: value TO BE ADJUSTED before the measurement is trusted */
+#define MON_VBAT_CHANNEL      BB_MON_CEL4
+#define MON_VBAT_DIVIDER_X100 600L
+
 
 /**
  ********************************************************************************
@@ -114,6 +120,11 @@
 /* NVIC priority of the system runstats timer */
 #define BB_PRIORITY_SYS_RUNSTATS    (15) // configLIBRARY_LOWEST_INTERRUPT_PRIORITY
 
+ /* Prescaler of the control-system sampling timer
+  * APB1 Timers Running at   96000 kHz
+  */
+#define SYS_CTRL_PRESCALER          (95) // 1 MHz, period is given in us
+
 
 
 #endif /* __BB_CONFIG_H */
@@ -0,0 +1,94 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       path_config.h
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Capacities of the path-finder, to be adapted for each project (season)
+ *   depending on the number of obstacles of the table.
+ *   The index types of the path-finder are chosen from these values, and the
+ *   RAM it uses is checked against PATH_RAM_BUDGET at build time
+ *   ('seq pfmem' shell command gives the details).
+ *   The 2018 table uses 6 polygons (objective included), 49 points and 32
+ *   true geometry points. Its searches need up to ~150 rays and ~75 cached
+ *   rays, and up to ~220 rays and ~290 cached rays with 2 more obstacles.
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _PATH_CONFIG_H_
+#define _PATH_CONFIG_H_
+
+// Maximum number of points used by the polygons, objective included.
+// Since we mostly use rectangles, this number should be at least 4 times
+// larger than the PATH_MAX_POLY value
+#define PATH_MAX_POINTS 64
+
+// Maximum number of points used by the true geometry of the inflated polygons
+#define PATH_MAX_SRC_POINTS 40
+
+// Maximum number of polygons used to represent objects to avoid.
+#define PATH_MAX_POLYS 8 // must be <= 32 (polygon masks)
+
+// Maximum number of rays of the visibility graph, i.e. the segments found by
+// the "visible point" algorithm.
+#define PATH_MAX_RAYS 256
+
+// Maximum number of candidate rays held by the visibility-graph cache.
+// Rays hidden by dynamic polygons are kept, so it is larger than the number
+// of rays of a single graph (up to 1 per pair of points: n.(n-1)/2).
+#define PATH_MAX_CACHED_RAYS 320
+
+// Maximum number of pass-by points allowed for a resulting trajectory path.
+#define PATH_MAX_CHECKPOINTS 8
+
+// Maximum number of goals of a multi-goal search (see path_compute_travel_times()).
+#define PATH_MAX_GOALS 8
+
+// Number of resulting paths kept in the results cache
+#define PATH_RESULTS_CACHE_SIZE 4
+
+// Maximum number of soft-cost areas (opponents current and predicted positions)
+#define PATH_MAX_HAZARDS 4
+
+// RAM allotted to the path-finder (bytes), out of the 320 KB of the STM32F746
+// (the FreeRTOS heap is 15 KB): its container and the table of the paths
+// between the POIs. The capacities above are set to fit in it.
+#define PATH_RAM_ALLOTMENT 16384
+
+// Maximum size of the table of the paths between the POIs (bytes), filled by
+// phys_build_poi_paths() and checked at build time. It holds a path of
+// PATH_MAX_CHECKPOINTS-1 checkpoints per pair of POIs: 78 paths of 46 bytes
+// (3588 bytes) for the 13 POIs of 2018.
+#define PATH_POI_PATHS_RAM_BUDGET 4096
+
+// Maximum size of the path-finder container (bytes), checked at build time
+#define PATH_RAM_BUDGET (PATH_RAM_ALLOTMENT - PATH_POI_PATHS_RAM_BUDGET)
+
+// Grid backend of the path-finder (path_grid.c), off by default: its buffers
+// alone take PATH_GRID_RAM_BUDGET bytes. It can be enabled from the compiler
+// command line (-DPATH_GRID_ENABLE=1), 'seq pfgrid' then selects it.
+#ifndef PATH_GRID_ENABLE
+#define PATH_GRID_ENABLE 0
+#endif
+
+// Size of the cells of the occupancy grid used by the grid backend (mm).
+// The table is rasterised with it, so smaller cells need a lot more RAM.
+#define PATH_GRID_CELL_MM 30
+
+// Maximum number of entries of the open set of the grid search (jump points)
+#define PATH_GRID_MAX_OPEN 1024
+
+// Maximum number of jump points of a grid path, before it is smoothed
+#define PATH_GRID_MAX_JUMPS 64
+
+// Maximum size of the grid backend container (bytes), checked at build time.
+// It comes on top of PATH_RAM_ALLOTMENT when the grid is built.
+#define PATH_GRID_RAM_BUDGET 24576
+
+#endif  /* _PATH_CONFIG_H_ */
@@ -61,9 +61,12 @@
  * All debug messages of higher priority are printed.
  * E.g:  in "ERR", Critical errors + Errors are displayed
  *       in "INF", All debug messages are printed
+ * It can be overridden from the compiler command line (host checks).
  * */
 
+#ifndef DEBUG_LEVEL
 #define DEBUG_LEVEL     DEBUG_LEVEL_INFO
+#endif
 
 /**
 ********************************************************************************
@@ -117,6 +117,7 @@
  * Higher value means higher priority
  */
 #define OS_TASK_PRIORITY_SHELL        ( tskIDLE_PRIORITY + 1  )
+#define OS_TASK_PRIORITY_PLANNER      ( tskIDLE_PRIORITY + 1  )
 
 #define OS_TASK_PRIORITY_LED          ( tskIDLE_PRIORITY + 2  )
 #define OS_TASK_PRIORITY_MONITORING   ( tskIDLE_PRIORITY + 2  )
@@ -151,12 +152,14 @@
 #define OS_TASK_STACK_AVOIDANCE         200
 #define OS_TASK_STACK_BEACONS           configMINIMAL_STACK_SIZE
 #define OS_TASK_STACK_SYS_MODULES       200
+#define OS_TASK_STACK_PLANNER           300
 
  /* NVIC Priorities. Lower value means higher priority.
   * Beware to use priorities smaller than configLIBRARY_LOWEST_INTERRUPT_PRIORITY
   * and higher than configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY when using
   * ISR Save FreeRTOS API Routines!
   */
+#define OS_ISR_PRIORITY_MOTION_CS       ( configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY     )
 #define OS_ISR_PRIORITY_SER             ( configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1 )
 #define OS_ISR_PRIORITY_DSV             ( configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 2 )
 
@@ -169,13 +172,23 @@
   * Events periodicity
   */
 #define OS_MOTION_CONTROL_PERIOD_MS       50
-#define OS_AVERSIVE_PERIOD_MS             50
+#define OS_AVERSIVE_PERIOD_MS             50  // Period of the Aversive speeds, accelerations and gains
+#define OS_MOTION_CS_PERIOD_US          1000  // Control-system sampling (timer), 500 to 1000 us
 #define OS_MONITORING_PERIOD_MS          100
 #define OS_SEQUENCER_PERIOD_MS           100
 #define OS_AI_TASKS_PERIOD_MS            100
 #define OS_BEACONS_PERIOD_MS             100
 #define OS_AVOIDANCE_PERIOD_MS            10
 #define OS_SYS_MODULES_PERIOD_MS         100
+#define OS_PLANNER_PERIOD_MS             100
+#define OS_PLANNER_BUDGET_MS              30  // CPU time given to the planner in each period
+
+// Number of control-system samples per Aversive period
+#define OS_MOTION_CS_DIVIDER             ( (OS_AVERSIVE_PERIOD_MS * 1000) / OS_MOTION_CS_PERIOD_US )
+
+#if ((OS_AVERSIVE_PERIOD_MS * 1000) % OS_MOTION_CS_PERIOD_US) != 0
+#error "OS_MOTION_CS_PERIOD_US must divide OS_AVERSIVE_PERIOD_MS"
+#endif
 
 /*
  * Software task 32 bits notifiers
@@ -190,6 +203,8 @@
 #define OS_NOTIFY_MATCH_PAUSE         0x00000400    // Software pause of the match (freeze everything)
 #define OS_NOTIFY_MATCH_RESUME        0x00000800    // Software resume of the match (continues)
 #define OS_NOTIFY_MATCH_ABORT         0x00001000    // Software abort of the match (clean end, no reset)
+#define OS_NOTIFY_MOTION_WP_DONE      0x00010000    // Waypoint done (see motion_set_wp_done_task())
+#define OS_NOTIFY_PATH_CHECK          0x00020000    // Dynamic obstacle moved, check the followed path
 
 // Modules system notifiers
 #define OS_NOTIFY_SYS_MOD_INIT        0x00000001    // Initialize the modules system
@@ -314,13 +329,13 @@ int16_t motion_get_y(void);
 int16_t motion_get_a(void);
 void motion_power_enable(void);
 void motion_power_disable(void);
-void vLockEncoderAngle(void);
-void vLockEncoderDistance(void);
+void motion_cs_stats_print(char* ret, size_t len);
+void motion_cs_stats_reset(void);
+void motion_cs_math_bench_print(char* ret, size_t len);
+void motion_get_pose(struct robot_pose* pose);
 void vLockAngleConsign(void);
 void vLockDistanceConsign(void);
 void vLockRobotPosition(void);
-void vUnlockEncoderAngle(void);
-void vUnlockEncoderDistance(void);
 void vUnlockAngleConsign(void);
 void vUnlockDistanceConsign(void);
 void vUnlockRobotPosition(void);
@@ -332,6 +347,7 @@ void vUnlockRobotPosition(void);
 BaseType_t motion_traj_start(void);
 bool motion_is_traj_near(void);
 bool motion_is_traj_finished(void);
+void motion_traj_stats_print(char* ret, size_t len);
 
 void motion_traj_hard_stop(void);
 
@@ -349,7 +365,12 @@ void motion_turnto_front(double pos_x, double pos_y);
 void motion_turnto_behind(double pos_x, double pos_y);
 
 void motion_clear_all_wp(void);
-BaseType_t motion_add_new_wp(wp_t *waypoint);
+BaseType_t motion_add_new_wp(wp_t *waypoint, uint32_t *ticket);
+BaseType_t motion_replace_all_wp(wp_t *waypoints, uint8_t nb_waypoints, uint32_t *first_ticket);
+bool motion_get_current_wp_ticket(uint32_t *ticket);
+bool motion_is_wp_done(uint32_t ticket);
+void motion_set_wp_done_task(TaskHandle_t task);
+void motion_set_path_tracking(bool enable);
 bool motion_is_traj_done(wp_t *waypoint);
 void motion_execute_wp(wp_t *waypoint);
 
@@ -362,6 +383,9 @@ void sequencer_print_match(void);
 const char* match_state_to_str(match_state_e state);
 const char* match_color_to_str(match_color_e color);
 
+// Background path planner
+BaseType_t planner_start(void);
+
 // -----------------------------------------------------------------------------
 // Task manager
 // -----------------------------------------------------------------------------
@@ -369,6 +393,7 @@ const char* match_color_to_str(match_color_e color);
 void tasks_init(void);
 bool task_is_valid(task_t* task);
 task_t* task_get_next(void);
+uint8_t task_get_ranked(task_t** ranked, uint8_t nb_tasks);
 void task_add_dep(task_t* task, task_t* dep);
 void task_print(task_t* task);
 BaseType_t task_print_list(char* ret, size_t retLength);
@@ -396,6 +421,8 @@ void phys_apply_polar_offset(int16_t* x, int16_t* y, int16_t d, int16_t a_deg);
 void phys_set_obstacle_positions(void);
 void phys_set_teammate_position(int16_t x, int16_t y);
 void phys_set_opponent_position(uint8_t robot_idx, int16_t x, int16_t y);
+void phys_build_poi_paths(void);
+int8_t phys_get_poi_path(int16_t src_x, int16_t src_y, int16_t dst_x, int16_t dst_y);
 
 void phys_pf_poly_to_str(path_poly_t* poly, uint8_t idx_poly, char* str, size_t len);
 void phys_pf_path_to_str(char* ret, size_t len);
@@ -413,6 +440,8 @@ BaseType_t ai_stop(void);
 void ai_manage(bool notified, uint32_t sw_notification);
 void ai_tasks_def(void);
 BaseType_t ai_task_launch(task_t* task);
+bool ai_get_task_dest(const task_t* task, int16_t* x, int16_t* y);
+void ai_compute_task_travel_times(void);
 void ai_compute_task_priorities(void);
 void ai_on_suspend_policy(task_t* task);
 void ai_on_failure_policy(task_t* task);
@@ -422,6 +451,8 @@ void ai_task_start(void *params);
 
 
 BaseType_t ai_move_with_pf(wp_t* wp);
+BaseType_t ai_move_with_pf_block_on_avd(wp_t* wp);
+void ai_check_path(void);
 void motion_move_block_on_avd(wp_t* wp);
 
 // -----------------------------------------------------------------------------
@@ -430,11 +461,26 @@ void motion_move_block_on_avd(wp_t* wp);
 
 // Initializer
 void path_init(void);
+void path_lock(void);
+void path_unlock(void);
 
 // Inputs definitions
 void path_set_objective(int32_t src_x, int32_t src_y, int32_t dst_x, int32_t dst_y);
 path_poly_t* path_add_new_poly(uint8_t nb_points);
+path_poly_t* path_add_new_inflated_poly(uint8_t nb_points, uint8_t max_points, int16_t margin);
+void path_poly_set_src_points(path_poly_t* poly, uint8_t idx, int16_t x, int16_t y);
+void path_update_inflated_polys(void);
 void path_poly_set_points(path_poly_t* poly, uint8_t idx, int32_t x, int32_t y);
+void path_poly_set_static(path_poly_t* poly, bool is_static);
+void path_set_static_only(bool static_only);
+void path_new_epoch(void);
+void path_set_backend(path_backend_e backend);
+void path_set_hazard(uint8_t idx, int32_t x, int32_t y, int16_t radius,
+                     uint16_t penalty_ms, uint32_t max_age_ms);
+void path_clear_hazard(uint8_t idx);
+void path_set_motion(wp_speed_e speed, wp_type_e type);
+void path_set_heading(int16_t heading);
+uint32_t path_estimate_time(int32_t src_x, int32_t src_y, uint8_t nb_checkpoints);
 
 // Core functions
 void path_point_to_line(const path_proc_pt_t* p1, const path_proc_pt_t* p2, path_line_t* l);
@@ -445,16 +491,40 @@ path_seg_cross_e path_intersect_segment(path_proc_pt_t* s1, path_proc_pt_t* s2,
                                         path_proc_pt_t* t1, path_proc_pt_t* t2,
                                         path_proc_pt_t* p);
 path_pt_in_poly_e path_pt_is_in_poly(const path_proc_pt_t* p, const path_poly_t* poly);
+path_seg_cross_e path_orient_segments(const path_proc_pt_t* s1, const path_proc_pt_t* s2,
+                                      const path_proc_pt_t* t1, const path_proc_pt_t* t2);
+path_pt_in_poly_e path_orient_pt_in_poly(const path_proc_pt_t* p, const path_poly_t* poly);
+bool path_is_segment_free(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
 path_seg_cross_poly_e path_seg_is_crossing_poly(path_proc_pt_t p1,
                                                 path_proc_pt_t p2,
                                                 const path_poly_t* poly);
 
 // Main processing functions
-uint16_t path_compute_rays(path_poly_t* polys, uint8_t n_polys, uint8_t* rays);
-void path_compute_rays_weight(const path_poly_t* polys, const uint8_t* rays, uint16_t ray_n, uint16_t* weight);
-void path_compute_dijkstra(uint8_t start_poly, uint8_t start_pt);
-int8_t path_get_result(path_poly_t* polys, uint8_t* rays);
+void path_update_rays_cache(void);
+uint16_t path_compute_rays(path_poly_t* polys, uint8_t n_polys, path_ray_t* rays);
+void path_compute_rays_weight(const path_ray_t* rays, uint16_t ray_n, uint16_t* weight);
+void path_compute_adjacency(const path_ray_t* rays, uint16_t ray_n);
+void path_compute_astar(uint8_t start_poly, uint8_t start_pt,
+                        uint8_t goal_poly, uint8_t goal_pt);
+void path_compute_goals_search(void);
+int8_t path_get_result(path_poly_t* polys, path_ray_t* rays);
+int8_t path_smooth(int32_t src_x, int32_t src_y, uint8_t nb_checkpoints);
 int8_t path_process(void);
+bool path_has_result(int32_t src_x, int32_t src_y, int32_t dst_x, int32_t dst_y);
+int8_t path_find(int32_t src_x, int32_t src_y, int32_t dst_x, int32_t dst_y);
+uint8_t path_compute_travel_times(int32_t src_x, int32_t src_y,
+                                  const poi_t* goals, uint8_t nb_goals);
+
+// Grid backend
+#if PATH_GRID_ENABLE
+void path_grid_invalidate(void);
+void path_grid_update(void);
+int8_t path_grid_process(void);
+#endif
+
+// Benchmark
+BaseType_t path_bench_print(char* ret, size_t len, uint16_t nb_scenarios, uint32_t seed);
+void path_mem_print(char* ret, size_t len);
 
 // TODO: result
 
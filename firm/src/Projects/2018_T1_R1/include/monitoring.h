@@ -38,6 +38,9 @@ typedef struct
   uint16_t shunt_ip2_mohm;  // Value of the VP1 resistor shunt in milliohm
   uint16_t shunt_ip3_mohm;  // Value of the VP1 resistor shunt in milliohm
 
+  // Battery voltage
+  uint16_t vbat_divider_x100; // Ratio of the VBAT resistor divider, x100
+
 } mon_cfg_t;
 
 typedef struct
@@ -49,6 +52,7 @@ typedef struct
   uint32_t ip3_ma;  // VP3 power-supply current in mA
 
   // Cells: TODO (hardware bug)
+  uint32_t vbat_mv;  // Battery voltage in mV, filtered (0 until measured)
 
   // Motors: TODO
 
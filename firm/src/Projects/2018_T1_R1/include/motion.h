@@ -23,9 +23,11 @@
 #include "aversive.h"
 #include "pid.h"
 #include "biquad.h"
+#include "cascade.h"
 #include "quadramp.h"
 #include "quadramp_derivate.h"
 #include "ramp.h"
+#include "fast_math.h"
 #include "angle_distance.h"
 #include "blocking_detection_manager.h"
 #include "control_system_manager.h"
@@ -42,8 +44,13 @@
 */
 
 // Number of waypoints that can be stored in the motion controller's FIFO
-// We don't need to have a large amount since we feed it one after the other
-#define MOTION_MAX_WP_IN_QUEUE    5U // Maximum amount of waypoints in the queue
+// It must hold a full path-finder result (PATH_MAX_CHECKPOINTS), since the
+// checkpoints are all queued at once
+#define MOTION_MAX_WP_IN_QUEUE    8U // Maximum amount of waypoints in the queue
+
+// Chained forward waypoints are followed as a path (pure pursuit) rather
+// than reached one after the other
+#define MOTION_PATH_TRACKING      true
 
 // Pre-defined speeds
 #define SPEED_FAST_D         1200L // For long motions only
@@ -63,6 +70,15 @@
 ********************************************************************************
 */
 
+/* Feed-forward of a control system, from the speed and acceleration planned
+ * by its quadramp (per Aversive period) to the PWM, so that the PID only
+ * corrects the residual error */
+typedef struct
+{
+  float kv; // PWM per speed unit
+  float ka; // PWM per acceleration unit
+} motion_ff_t;
+
 /* Aversive's Control System manager structure
  * Contains all required control variables for the robot motion
  */
@@ -82,11 +98,21 @@ typedef struct
   struct cs cs_a;
   struct pid_filter pid_a;
   struct quadramp_filter qr_a;
+  motion_ff_t ff_a;
+  bool cascade_a;              // Cascaded loops instead of pid_a
+  struct cascade_filter cas_a;
+  struct pid_filter pid_pa;    // Outer loop, angle error to speed consign
+  struct pid_filter pid_va;    // Inner loop, speed error to PWM
 
   /* Control system in Distance */
   struct cs cs_d;
   struct pid_filter pid_d;
   struct quadramp_filter qr_d;
+  motion_ff_t ff_d;
+  bool cascade_d;              // Cascaded loops instead of pid_d
+  struct cascade_filter cas_d;
+  struct pid_filter pid_pd;    // Outer loop, distance error to speed consign
+  struct pid_filter pid_vd;    // Inner loop, speed error to PWM
 
   /* Blocking detection */
   struct blocking_detection bd_l;
@@ -96,16 +122,37 @@ typedef struct
   int32_t pwm_l;
   int32_t pwm_r;
 
+  /* Battery voltage compensation of the PWM */
+  uint32_t vbat_nominal_mv; // Voltage the gains are tuned at, 0 to disable
+  float vbat_gain;          // Applied to the PWM
+
   /* Speed */
   volatile int16_t speed_a;
   volatile int16_t speed_d;
 
+  /* Wheels speed, estimated at each sample for the cascaded loops
+   * (Aversive periods units) */
+  volatile int32_t wheel_speed_l;
+  volatile int32_t wheel_speed_r;
+
   /* Acceleration */
   volatile int16_t acceleration_a;
   volatile int16_t acceleration_d;
 
 } avs_cs_t;
 
+/* Processing time of the control-system samples (CPU cycles), against the
+ * sampling period budget */
+typedef struct
+{
+  uint32_t nb_samples;      // Samples processed
+  uint32_t nb_missed;       // Timer periods elapsed without processing
+  uint32_t nb_overruns;     // Samples longer than the budget
+  uint32_t last_cycles;
+  uint32_t max_cycles;
+  uint64_t total_cycles;
+} motion_cs_stats_t;
+
 
 /* Waypoint type (kind of trajectory) */
 typedef enum
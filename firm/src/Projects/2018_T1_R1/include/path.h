@@ -17,6 +17,8 @@
 #ifndef _PATH_H_
 #define _PATH_H_
 
+// Capacities of the path-finder
+#include "../../2018_T1_R1/include/config/path_config.h"
 
 /**
 ********************************************************************************
@@ -26,19 +28,23 @@
 ********************************************************************************
 */
 
-// Maximum number of points used by the polygons.
-// Since we mostly use rectangles, this number should be at least 4 times
-// larger than the PATH_MAX_POLY value
-#define PATH_MAX_POINTS 100 // must be < 256
+// The objective polygon reserves a point for the source and each goal
+#define PATH_OBJECTIVE_POINTS (1 + PATH_MAX_GOALS)
 
-// Maximum number of polygons used to represent objects to avoid.
-#define PATH_MAX_POLYS 16 // must be < 256
+// Maximum direction change (deg) of the outline at each vertex of an inflated
+// polygon corner: corners are bevelled with more vertices when it is smaller.
+#define PATH_INFLATE_STEP_DEG 45
 
-// Maximum number of rays, i.e. resulting segments the "visible point" algorithm.
-#define PATH_MAX_RAYS 1000   // i.e. twice more points references
+// Distance the checkpoints are pushed away from the polygon corners by the
+// path smoothing, when possible (mm). Disabled when 0: polygons already
+// include a margin and it makes the paths longer.
+#define PATH_SMOOTH_CLEARANCE_MM 0
 
-// Maximum number of pass-by points allowed for a resulting trajectory path.
-#define PATH_MAX_CHECKPOINTS 8
+// Size of the cells used to quantize the start point of the cached paths (mm)
+#define PATH_RESULTS_CELL_MM 50
+
+// Size of the sectors used to quantize the initial heading of the cached paths (deg)
+#define PATH_RESULTS_HEADING_DEG 45
 
 // Defines the precision of a line equation. The algorithm will only use line
 // coefficients smaller than this value. A too small value will reduce the precision,
@@ -49,6 +55,43 @@
 // no valid path.
 #define PATH_RESULT_ERROR -1
 
+// Number of A* search states: the adjacency entries, i.e. a ray taken in one
+// direction, and the state standing at the start point (no ray taken yet).
+#define PATH_MAX_STATES (2*PATH_MAX_RAYS + 1)
+#define PATH_START_STATE (2*PATH_MAX_RAYS)
+
+// Values of a search state's heap position when it is not in the A* open set
+#define PATH_HEAP_NONE ((path_state_t) -1)      // Not reached yet
+#define PATH_HEAP_CLOSED ((path_state_t) -2)    // Expanded, its cost is final
+
+// Travel time of a goal that cannot be reached by the multi-goal search
+#define PATH_TIME_UNREACHABLE UINT32_MAX
+
+// Robot heading value meaning that no initial rotation has to be charged
+#define PATH_HEADING_NONE INT16_MAX
+
+// Flags of the polygon points changes, one per structure built from them
+#define PATH_DIRTY_RAYS 0x01    // Visibility-graph cache
+#define PATH_DIRTY_GRID 0x02    // Occupancy grid
+#define PATH_DIRTY_ALL  (PATH_DIRTY_RAYS | PATH_DIRTY_GRID)
+
+#if PATH_GRID_ENABLE
+
+// Occupancy grid dimensions: cells, and 32-bit words of each row
+#define PATH_GRID_W ((TABLE_X_MAX - TABLE_X_MIN + PATH_GRID_CELL_MM - 1) / PATH_GRID_CELL_MM)
+#define PATH_GRID_H ((TABLE_Y_MAX - TABLE_Y_MIN + PATH_GRID_CELL_MM - 1) / PATH_GRID_CELL_MM)
+#define PATH_GRID_WORDS ((PATH_GRID_W + 31) / 32)
+#define PATH_GRID_CELLS (PATH_GRID_W * PATH_GRID_H)
+
+// Cost of a grid move, in the ratio of the diagonal (octile distance)
+#define PATH_GRID_COST_STRAIGHT 5
+#define PATH_GRID_COST_DIAGONAL 7
+
+// Parent direction of a grid cell which has none (start or not reached)
+#define PATH_GRID_DIR_NONE 0x0F
+
+#endif /* PATH_GRID_ENABLE */
+
 /**
 ********************************************************************************
 **
@@ -63,6 +106,10 @@
 #define PATH_IS_IN_PLAYGROUND(pt) ( (pt).x > TABLE_X_MIN/10 && (pt).x < TABLE_X_MAX/10 && \
                                     (pt).y > TABLE_Y_MIN/10 && (pt).y < TABLE_Y_MAX/10 )
 
+// Bit of a polygon index in a polygon mask, and mask of all the polygons
+#define PATH_POLY_MASK(idx) ((path_poly_mask_t) 1 << (idx))
+#define PATH_POLY_ALL ((path_poly_mask_t) -1)
+
 /**
 ********************************************************************************
 **
@@ -71,6 +118,58 @@
 ********************************************************************************
 */
 
+// Index types, as small as the capacities allow
+#if PATH_MAX_POINTS <= UINT8_MAX
+typedef uint8_t path_pt_idx_t;      // Point of the pts[] array
+#elif PATH_MAX_POINTS <= UINT16_MAX
+typedef uint16_t path_pt_idx_t;
+#else
+#error "PATH_MAX_POINTS is too large"
+#endif
+
+#if PATH_MAX_POLYS <= 16
+typedef uint16_t path_poly_mask_t;  // One bit per polygon
+#elif PATH_MAX_POLYS <= 32
+typedef uint32_t path_poly_mask_t;
+#else
+#error "PATH_MAX_POLYS is too large"
+#endif
+
+#if PATH_MAX_STATES < UINT16_MAX - 1
+typedef uint16_t path_state_t;      // Search state or adjacency entry
+#else
+typedef uint32_t path_state_t;
+#endif
+
+#if (PATH_MAX_RAYS > UINT16_MAX) || (PATH_MAX_CACHED_RAYS > UINT16_MAX)
+#error "PATH_MAX_RAYS and PATH_MAX_CACHED_RAYS must fit on 16 bits"
+#endif
+
+#if PATH_MAX_POINTS < PATH_OBJECTIVE_POINTS
+#error "PATH_MAX_POINTS is too small for the objective points"
+#endif
+
+#if PATH_GRID_ENABLE
+
+#if PATH_GRID_CELLS > UINT16_MAX
+#error "PATH_GRID_CELL_MM is too small, cells must be indexed on 16 bits"
+#endif
+
+#if PATH_GRID_CELLS * PATH_GRID_COST_DIAGONAL < UINT16_MAX
+typedef uint16_t path_grid_cost_t;  // Cost of a grid path
+#else
+typedef uint32_t path_grid_cost_t;
+#endif
+
+#endif /* PATH_GRID_ENABLE */
+
+// Search backend of the path-finder
+typedef enum
+{
+    PATH_BACKEND_VISIBILITY,    // A* on the visibility graph of the polygons
+    PATH_BACKEND_GRID           // Jump-point search on the occupancy grid (PATH_GRID_ENABLE)
+} path_backend_e;
+
 // Enumeration type to represent how 2 lines can cross each others
 typedef enum
 {
@@ -105,7 +204,8 @@ typedef enum
     PATH_SEG_POLY_TOUCH_EDGE,   // One of the segment's boundary is on one of the polygon's edge
 } path_seg_cross_poly_e;
 
-// Enumeration type to represent the dijkstra algorithm points state
+// Enumeration type to represent the shortest-path search points state
+// (VISITED: closed set, MUST_VISIT: open set)
 typedef enum
 {
     PATH_DIJ_PT_NOT_VISITED,
@@ -123,7 +223,7 @@ typedef struct
     int32_t x;      // X coordinate
     int32_t y;      // Y coordinate
 
-    // Variables used for Dijkstra
+    // Variables used for the shortest-path search
     int32_t weight;
     uint8_t poly;
     uint8_t pt;
@@ -148,26 +248,187 @@ typedef struct
     uint8_t n;              // Number of points
     path_proc_pt_t* pts;    // Pointer on an array containing those points
                             // Actual data is not held by this structure.
+    uint8_t dirty;          // Points changed since the last update (PATH_DIRTY_xxx)
+
+    // Inflated polygons: points are computed from the true geometry of the
+    // obstacle, offset by a margin (e.g. the robot radius)
+    poi_t* src;             // True geometry points (mm)
+    uint8_t src_n;          // Number of true geometry points, 0 if not inflated
+    uint8_t max_n;          // Number of points reserved in pts
+    int16_t margin;         // Inflation distance (mm)
+    bool inflate;           // True geometry changed since the last inflation
+
+    // Axis-aligned bounding box of the points
+    int32_t x_min;
+    int32_t x_max;
+    int32_t y_min;
+    int32_t y_max;
 } path_poly_t;
 
+// Ray of the visibility graph: 2 vertices (indexes of the pts[] array)
+// that can "see" each others.
+typedef struct
+{
+    path_pt_idx_t pt1;
+    path_pt_idx_t pt2;
+} path_ray_t;
+
+// Entry of the visibility-graph cache: 2 vertices that are not hidden from
+// each other by a static polygon.
+typedef struct
+{
+    path_ray_t ray;
+    path_poly_mask_t blockers;  // Mask of the dynamic polygons crossing the ray
+} path_cached_ray_t;
+
+// Soft-cost area: rays passing closer than the radius from its center are
+// charged a penalty, decreasing linearly with the distance and with the age
+// of the position (nothing is charged once it is max_age_ms old).
+typedef struct
+{
+    bool active;
+    int32_t x;                  // Center (mm/10, same as the points)
+    int32_t y;
+    int32_t radius;             // mm/10
+    uint16_t penalty_ms;        // Penalty of a ray crossing the center
+    uint32_t max_age_ms;
+    TickType_t stamp;           // When the position was set
+} path_hazard_t;
+
+// Entry of the results cache: path found from a start cell to a destination,
+// for a given obstacles epoch.
+typedef struct
+{
+    bool valid;
+    int16_t src_cell_x;
+    int16_t src_cell_y;
+    int32_t dst_x;
+    int32_t dst_y;
+    uint32_t epoch;
+    uint32_t last_use;
+    wp_speed_e speed;
+    wp_type_e type;
+    int16_t heading_cell;
+    uint8_t nb_checkpoint;
+    poi_t res[PATH_MAX_CHECKPOINTS-1];      // Checkpoints, destination excluded
+} path_cached_result_t;
+
 // Main structure holding the different elements for the path-finding algorithm.
 typedef struct
 {
     path_proc_pt_t pts[PATH_MAX_POINTS];    // Points of the different polygons
     path_poly_t polys[PATH_MAX_POLYS];      // Polygons (obstacles), using pts.
+    poi_t src_pts[PATH_MAX_SRC_POINTS];     // True geometry of inflated polygons
+    uint8_t cur_src_idx;
 
     uint16_t nb_rays;
     uint8_t cur_poly_idx;
-    uint8_t cur_pt_idx;
+    path_pt_idx_t cur_pt_idx;
+    uint8_t robot_pt;                       // Objective point where the robot stands
 
     uint16_t weight[PATH_MAX_RAYS];
+
+    // Adjacency lists of the visibility graph (compressed rows).
+    // Entries of point g are [adj_first[g]; adj_first[g+1][, indexes are the
+    // ones of the pts[] array.
+    path_state_t adj_first[PATH_MAX_POINTS+1];  // First entry of each point
+    uint16_t adj_ray[2*PATH_MAX_RAYS];          // Ray (weight) index of the entry
+    path_pt_idx_t adj_pt[PATH_MAX_STATES];      // Point seen through this ray
+                                                // (start point for PATH_START_STATE)
+    uint8_t pt_poly[PATH_MAX_POINTS];           // Polygon owning each point
+    uint8_t pt_idx[PATH_MAX_POINTS];            // Index of each point in its polygon
+
+    // A* search states: a point reached through a given ray, so the rotation
+    // needed at each checkpoint is known. Costs are travel times (ms).
+    int32_t heuristic[PATH_MAX_POINTS];         // Time to the goal at full speed
+    int32_t state_cost[PATH_MAX_STATES];        // Time from the start
+    path_state_t state_parent[PATH_MAX_STATES]; // Previous state on the best path
+
+    // A* open set: binary min-heap of states sorted on cost + heuristic
+    path_state_t heap[PATH_MAX_STATES];
+    path_state_t heap_pos[PATH_MAX_STATES];     // Position in heap[] or PATH_HEAP_xxx
+    path_state_t heap_n;
+
+    // Motion model used to estimate the travel time (impulses and periods)
+    wp_speed_e speed;                       // Speed of the path motions
+    wp_type_e type;                         // Forward, backward or both (auto)
+    int16_t heading;                        // Initial robot heading (deg)
+    float speed_d;                          // Distance speed
+    float speed_a;                          // Angle speed
+    uint32_t turn_start_ms;                 // Rotation before moving in distance
+    uint32_t est_time_ms;                   // Estimated time of the last result
+
+    // Results of the last multi-goal search
+    uint8_t nb_goals;
+    uint32_t goal_time_ms[PATH_MAX_GOALS];  // Travel time to each goal
+
+    // Visibility-graph cache of the obstacles (the objective is never cached)
+    path_cached_ray_t cache[PATH_MAX_CACHED_RAYS];
+    uint16_t nb_cached_rays;
+    path_poly_mask_t static_polys;          // Mask of the static polygons
+    bool cache_valid;                       // Cleared to force a full rebuild
+    bool static_only;                       // Dynamic polygons (and hazards) are ignored
+    path_backend_e backend;                 // Search used by path_process()
+
+    // Soft costs of the search, added to the rays weight
+    path_hazard_t hazards[PATH_MAX_HAZARDS];
+
+    // Results cache, invalidated by any change of the obstacles epoch
+    path_cached_result_t results[PATH_RESULTS_CACHE_SIZE];
+    uint32_t epoch;                         // Bumped when obstacles move
+    uint32_t results_tick;                  // Last use reference
+    uint32_t nb_results_hits;
+    uint32_t nb_results_misses;
+
+    // Statistics of the last processing
+    uint32_t nb_poly_tests;                 // Segment / polygon crossing tests
+    uint32_t nb_poly_culled;                // Tests rejected on bounding boxes
+    uint32_t nb_astar_iterations;           // States expanded by the search
+
     union {
-        uint8_t rays[PATH_MAX_RAYS*2];
+        path_ray_t rays[PATH_MAX_RAYS];
         poi_t res[PATH_MAX_CHECKPOINTS];
     } u;
     uint8_t nb_checkpoint;
 } path_t;
 
+#if PATH_GRID_ENABLE
+
+// Entry of the open set of the grid search
+typedef struct
+{
+    uint16_t cell;
+    path_grid_cost_t key;   // Cost + heuristic
+} path_grid_open_t;
+
+// Grid backend of the path-finder: the table is rasterised into bit-packed
+// occupancy grids (1 bit per cell, set when blocked) searched with jump-point
+// search. Static polygons are stamped once, dynamic ones on top of them.
+typedef struct
+{
+    uint32_t occ_static[PATH_GRID_H][PATH_GRID_WORDS];  // Static polygons
+    uint32_t occ[PATH_GRID_H][PATH_GRID_WORDS];         // All the polygons
+    bool valid;                                         // Cleared to force a full rebuild
+
+    // Search state of each cell
+    uint32_t closed[PATH_GRID_H][PATH_GRID_WORDS];      // Expanded cells
+    path_grid_cost_t cost[PATH_GRID_CELLS];             // Cost from the start
+    uint8_t parent[(PATH_GRID_CELLS + 1) / 2];          // Direction of the parent (4 bits)
+
+    // Open set: binary min-heap, cells may be pushed more than once
+    path_grid_open_t open[PATH_GRID_MAX_OPEN];
+    uint16_t nb_open;
+
+    // Jump points of the last path, from the destination
+    poi_t jumps[PATH_GRID_MAX_JUMPS];
+    uint8_t nb_jumps;
+
+    // Statistics of the last processing
+    uint32_t nb_expanded;                               // Jump points expanded
+} path_grid_t;
+
+#endif /* PATH_GRID_ENABLE */
+
 
 #endif  /* _PATH_H_ */
 
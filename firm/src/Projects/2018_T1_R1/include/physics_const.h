@@ -82,6 +82,7 @@
 #define PHYS_CS_D_QUAD_NEG_SPEED            ((uint32_t)  1200)
 #define PHYS_CS_D_QUAD_POS_ACCEL            ((uint32_t)    40)
 #define PHYS_CS_D_QUAD_NEG_ACCEL            ((uint32_t)    40)
+#define PHYS_CS_D_QUAD_JERK                 ((uint32_t)    10)
 
 /* Control System in Angle filters parameters */
 #define PHYS_CS_A_PID_KP                    ((int16_t)   2500)
@@ -96,6 +97,48 @@
 #define PHYS_CS_A_QUAD_NEG_SPEED            ((uint32_t)  1200)
 #define PHYS_CS_A_QUAD_POS_ACCEL            ((uint32_t)    24)
 #define PHYS_CS_A_QUAD_NEG_ACCEL            ((uint32_t)    24)
+#define PHYS_CS_A_QUAD_JERK                 ((uint32_t)     6)
+
+/* Feed-forward from the planned speed and acceleration, in PWM per
+ * quadramp unit. Values TO BE IDENTIFIED, 0 to disable */
+#define PHYS_CS_D_FF_KV                     ((float)      0.0)
+#define PHYS_CS_D_FF_KA                     ((float)      0.0)
+#define PHYS_CS_A_FF_KV                     ((float)      0.0)
+#define PHYS_CS_A_FF_KA                     ((float)      0.0)
+
+/* Cascaded position / speed loops, used instead of the single position pid
+ * when enabled. The outer pid gives a speed consign (per Aversive period)
+ * and runs every PHYS_CS_CASCADE_OUTER_DIVIDER samples, the inner one gives
+ * the PWM from the wheels speed, estimated over PHYS_CS_SPEED_WINDOW
+ * samples. Values from a model of the motors, TO BE ADJUSTED */
+#define PHYS_CS_D_CASCADE                   ((bool)     false)
+#define PHYS_CS_D_POS_KP                    ((int16_t)     64)
+#define PHYS_CS_D_POS_MAX_OUT               ((int32_t)   1200)
+#define PHYS_CS_D_POS_OUT_SHIFT             ((uint8_t)      6)
+#define PHYS_CS_D_SPEED_KP                  ((int16_t)   3072)
+#define PHYS_CS_D_SPEED_KI                  ((int16_t)   3072)
+#define PHYS_CS_D_SPEED_MAX_I               ((int32_t)   2000)
+#define PHYS_CS_D_SPEED_MAX_OUT             ((int32_t)   3999)
+#define PHYS_CS_D_SPEED_OUT_SHIFT           ((uint8_t)      8)
+#define PHYS_CS_A_CASCADE                   ((bool)     false)
+#define PHYS_CS_A_POS_KP                    ((int16_t)     64)
+#define PHYS_CS_A_POS_MAX_OUT               ((int32_t)   1200)
+#define PHYS_CS_A_POS_OUT_SHIFT             ((uint8_t)      6)
+#define PHYS_CS_A_SPEED_KP                  ((int16_t)   3072)
+#define PHYS_CS_A_SPEED_KI                  ((int16_t)   3072)
+#define PHYS_CS_A_SPEED_MAX_I               ((int32_t)   2000)
+#define PHYS_CS_A_SPEED_MAX_OUT             ((int32_t)   3999)
+#define PHYS_CS_A_SPEED_OUT_SHIFT           ((uint8_t)      8)
+#define PHYS_CS_CASCADE_OUTER_DIVIDER       ((uint16_t)     4)
+#define PHYS_CS_SPEED_WINDOW                8
+
+/* Battery voltage the gains are tuned at, 0 to disable the compensation.
+ * Below the minimum, the measurement is considered wrong and the PWM is not
+ * compensated. Disabled until the divider of the measurement is adjusted
+ * (14800 mV for the pack the gains were tuned with) */
+#define PHYS_MOT_VBAT_NOMINAL_MV            ((uint32_t)     0)
+#define PHYS_MOT_VBAT_MIN_MV                ((uint32_t)  9000)
+#define PHYS_MOT_VBAT_MAX_GAIN              ((float)      1.5)
 
 /* Trajectory Manager parameters */
 #define PHYS_TRAJ_D_DEFAULT_SPEED           ((int16_t)    1500)
@@ -103,6 +146,8 @@
 #define PHYS_TRAJ_DEFAULT_WIN_D             ((double)    30.0)
 #define PHYS_TRAJ_DEFAULT_WIN_A_DEG         ((double)     5.0)
 #define PHYS_TRAJ_DEFAULT_WIN_A_START_DEG   ((double)    30.0)
+#define PHYS_TRAJ_PATH_LOOKAHEAD_MM         ((double)   150.0)
+#define PHYS_TRAJ_PATH_LAT_ACCEL            ((double)    24.0)
 
 /* Blocking detection filter constants */
 #define PHYS_BD_K1                          ((int32_t)      5)
@@ -146,6 +191,11 @@
 #define ROBOT_BASE_WIDTH        250 // Distance between the two encoder wheels
 #define ROBOT_RADIUS            170 // In Idle position the robot can fit in a cylinder of this radius.
 
+// Path-finder obstacles are defined with their true geometry, and inflated
+// by the robot radius plus this clearance (mm)
+#define PHYS_PF_CLEARANCE        20
+#define PHYS_PF_MARGIN          (ROBOT_RADIUS + PHYS_PF_CLEARANCE)
+
 #define TRAJECTORY_NEAR_WINDOW_D  200
 #define TRAJECTORY_NEAR_WINDOW_A  10
 
@@ -170,9 +220,22 @@
 #define OPPONENT2_POS_INIT_Y      180
 
 // Sizes for other robots
-// Lengths of one small segment of the octogon.
-#define TEAMMATE_SIZE   150
-#define OPPONENT1_SIZE  200
-#define OPPONENT2_SIZE  150
+// Lengths of one small segment of the octogon of their footprint
+// (the path-finder adds our own robot radius).
+#define TEAMMATE_SIZE   100
+#define OPPONENT1_SIZE  130
+#define OPPONENT2_SIZE  100
+
+// Path-finder soft costs around the opponents (see path_hazard_t).
+// Paths passing closer than the radius from their center (mm) are charged up
+// to the penalty (ms), which fades out with the age of their position.
+// Their position in PHYS_PF_OPP_PREDICT_MS is predicted from their speed
+// (limited to PHYS_PF_OPP_MAX_SPEED mm/s) and charged as well.
+#define PHYS_PF_OPP_RADIUS              600
+#define PHYS_PF_OPP_PENALTY_MS         1500
+#define PHYS_PF_OPP_PREDICT_PENALTY_MS  750
+#define PHYS_PF_OPP_MAX_AGE_MS         5000
+#define PHYS_PF_OPP_PREDICT_MS         1000
+#define PHYS_PF_OPP_MAX_SPEED          1000
 
 #endif /* PHYSICS_CONST_H_ */
@@ -47,6 +47,17 @@
 // Match duration (RUN state)
 #define MATCH_DURATION_MSEC             100000U
 
+// Number of POIs linked by the precomputed path table, and resulting
+// number of POIs pairs (paths are the same in both directions)
+#define PHYS_NB_POI_PATHS               13U
+#define PHYS_NB_POI_PAIRS               (PHYS_NB_POI_PATHS*(PHYS_NB_POI_PATHS-1)/2)
+
+// Maximum distance between the robot and a POI for using the path table (mm)
+#define PHYS_POI_PATH_TOLERANCE         30
+
+// Number of best ranked AI tasks whose paths are computed in background
+#define PLANNER_NB_CANDIDATES           3U
+
 
 // Place-holder for physicals definitions (robot or game elements)
 // Warning: all coordinates are expressed with the GREEN point of view.
@@ -54,6 +65,13 @@
 // (0;0) point is always the same, whatever the color is.
 // This origin is placed on the top-left side of the table,
 // (same than the rules drawings)
+// Precomputed path between 2 POIs, on the static map
+typedef struct {
+  int8_t nb_checkpoints;                      // Intermediate checkpoints, PATH_RESULT_ERROR if none
+  uint16_t distance;                          // Length of the path (mm)
+  poi_t checkpoints[PATH_MAX_CHECKPOINTS-1];  // From the POI with the lowest index
+} phys_poi_path_t;
+
 typedef struct {
 
   // Game elements
@@ -81,6 +99,10 @@ typedef struct {
   path_poly_t* pf_opponent1;          // First opponent's robot
   path_poly_t* pf_opponent2;          // Second opponent's robot
 
+  // Path-finder table between the main POIs (computed for our color)
+  poi_t pf_pois[PHYS_NB_POI_PATHS];
+  phys_poi_path_t pf_poi_paths[PHYS_NB_POI_PAIRS];
+
 } phys_t;
 
 // IDs for each object
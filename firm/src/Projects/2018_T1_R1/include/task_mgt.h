@@ -49,8 +49,13 @@
 
 // Priorities
 #define TASK_PRIORITY_MIN        0x00
+#define TASK_PRIORITY_LOWEST     0x01   // Lowest one a task can still be selected with
 #define TASK_PRIORITY_DEFAULT    0x10
-#define TASK_PRIORITY_MAX        0xFF
+#define TASK_PRIORITY_MAX        0xFFFF
+
+// Default time spent by a task once at its destination, added to its travel
+// time when computing its value per second
+#define TASK_DEFAULT_DURATION_MS  2000
 
 // Maximum amount of dependencies that a given task can have.
 // Dependences are inherited from dependant tasks.
@@ -111,9 +116,15 @@ struct task
   uint8_t nb_dependencies;                        // Number of dependencies
   task_t* dependencies[TASK_MAX_DEPENDENCIES];    // Array of pointers on dependencies
   uint16_t value;     // Value given to a task so it'll affect its priority
-  uint8_t priority;  // Task priority calculated after the current task is finished
+  uint16_t priority;  // Task priority calculated after the current task is finished
   uint8_t trials;     // Counter to measure the number of attempts for a task
 
+  const poi_t* dest;      // First destination of the task (POI, see ai_get_task_dest()), NULL if none
+  wp_speed_e dest_speed;  // Motion used to go to the destination
+  wp_type_e dest_type;
+  uint16_t duration_ms;   // Time spent once at destination
+  uint32_t travel_ms;     // Travel time to the destination, updated with the priorities
+
   // TBC: probablye not useful anymore
   /*uint8_t nb_elt;        // Number of elements in the chain
   uint8_t nb_elt_done;   // Number of elements already performed
@@ -124,6 +135,19 @@ struct task
 
 };
 
+/*
+ * Path followed by the robot, as queued by ai_move_with_pf(). The waypoints
+ * tickets (adding order in the motion queue) tell which checkpoints are
+ * already reached.
+ */
+typedef struct {
+  bool active;                              // Checkpoints are not all reached
+  wp_t dest;                                // Destination (color-updated)
+  uint8_t nb_checkpoints;                   // Number of queued checkpoints
+  wp_t checkpoints[PATH_MAX_CHECKPOINTS];   // Queued checkpoints, destination included
+  uint32_t first_ticket;                    // Motion ticket of the 1st checkpoint
+} ai_path_t;
+
 /*
  * Task management structure: used to store all necessary informations for
  * the tasks execution handling. Only one object is used and managed by the
@@ -137,6 +161,9 @@ typedef struct {
   // points on the IDLE task
   task_t* active_task;
 
+  // Path followed by the current motion, checked when obstacles move
+  ai_path_t path;
+
 
 
 } task_mgt_t;
@@ -0,0 +1,52 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       host_check.h
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Common definitions of the host checks.
+ *   Failed checks are reported and counted, a check program exits with a
+ *   failure status when at least one of them failed.
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _HOST_CHECK_H_
+#define _HOST_CHECK_H_
+
+#include "../../src/Projects/2018_T1_R1/include/main.h"
+
+#define HOST_EOL "\n"
+
+// Count and report a failed check, without stopping
+#define HOST_CHECK(cond, ...) {                           \
+  if(!(cond)) {                                           \
+    host_nb_failed++;                                     \
+    printf("FAIL %s:%d: ", __FILE__, __LINE__);           \
+    printf(__VA_ARGS__);                                  \
+    printf(HOST_EOL);                                     \
+  }                                                       \
+}
+
+// Exit value of a check program
+#define HOST_CHECK_RESULT() ((host_nb_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+extern TickType_t host_ticks;
+extern uint32_t host_nb_notify;
+extern uint32_t host_nb_failed;
+
+extern robot_t robot;
+extern match_t match;
+extern path_t pf;
+extern phys_t phys;
+
+void host_table_init(match_color_e color);
+bool host_is_in_polys(int32_t x, int32_t y);
+bool host_result_is_free(int32_t src_x, int32_t src_y, int8_t nb_checkpoints);
+
+#endif /* _HOST_CHECK_H_ */
@@ -0,0 +1,132 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       host_stubs.c
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Host implementation of the FreeRTOS kernel functions and of the firmware
+ *   globals used by the path-finder and physicals modules, so that they can
+ *   be linked and checked on Linux (see the Makefile).
+ *   Mutexes are always free and notifications are only counted. The tick
+ *   count is the host_ticks variable, moved by the checks themselves.
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#include "host_check.h"
+
+// -----------------------------------------------------------------------------
+// GLOBALS
+// -----------------------------------------------------------------------------
+
+// Normally owned by the sequencer
+robot_t robot;
+match_t match;
+TaskHandle_t handle_task_sequencer = (TaskHandle_t) 1;
+
+uint32_t SystemCoreClock = 216000000UL;
+
+// Kernel tick count returned by xTaskGetTickCount()
+TickType_t host_ticks = 1000;
+
+// Number of task notifications sent
+uint32_t host_nb_notify = 0;
+
+// Number of failed checks
+uint32_t host_nb_failed = 0;
+
+// -----------------------------------------------------------------------------
+// FREERTOS KERNEL
+// -----------------------------------------------------------------------------
+
+QueueHandle_t xQueueCreateMutex(const uint8_t ucQueueType) {
+  return (QueueHandle_t) 1;
+}
+
+BaseType_t xQueueGenericReceive(QueueHandle_t xQueue, void * const pvBuffer,
+                                TickType_t xTicksToWait, const BaseType_t xJustPeek) {
+  return pdTRUE;
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue, const void * const pvItemToQueue,
+                             TickType_t xTicksToWait, const BaseType_t xCopyPosition) {
+  return pdTRUE;
+}
+
+BaseType_t xTaskGenericNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue,
+                              eNotifyAction eAction, uint32_t *pulPreviousNotificationValue) {
+  host_nb_notify++;
+  return pdPASS;
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return host_ticks;
+}
+
+void vAssertCalled(uint32_t ulLine, const char *pcFile) {
+  printf("ASSERT %s:%u"HOST_EOL, pcFile, ulLine);
+  abort();
+}
+
+// -----------------------------------------------------------------------------
+// FIRMWARE
+// -----------------------------------------------------------------------------
+
+// The robot stands at the origin
+void motion_get_pose(struct robot_pose* pose) {
+  memset(pose, 0, sizeof(*pose));
+}
+
+// -----------------------------------------------------------------------------
+// CHECKS HELPERS
+// -----------------------------------------------------------------------------
+
+// Set the table up for a match color, the same way than ai_init() does
+void host_table_init(match_color_e color) {
+  match.color = color;
+  path_init();
+  phys_init();
+  phys_update_color_pois();
+  phys_update_color_polys();
+  phys_build_poi_paths();
+}
+
+// Returns true when a point (mm) is inside one of the polygons
+bool host_is_in_polys(int32_t x, int32_t y) {
+
+  uint8_t idx;
+  path_proc_pt_t p = {.x = x/10, .y = y/10};
+
+  path_update_inflated_polys();
+
+  for(idx = 1; idx < pf.cur_poly_idx; idx++) {
+    if((!pf.static_only || (pf.static_polys & PATH_POLY_MASK(idx))) &&
+       (path_orient_pt_in_poly(&p, &pf.polys[idx]) == PATH_PT_POLY_INSIDE))
+      return true;
+  }
+
+  return false;
+}
+
+// Returns true when all the segments of the current result, from the given
+// source point, are free. The first one may only leave the polygons the
+// source is inside of.
+bool host_result_is_free(int32_t src_x, int32_t src_y, int8_t nb_checkpoints) {
+
+  int8_t k;
+
+  for(k = 0; k < nb_checkpoints; k++) {
+    if(!path_is_segment_free(src_x, src_y, pf.u.res[k].x, pf.u.res[k].y) &&
+       ((k > 0) || !host_is_in_polys(src_x, src_y)))
+      return false;
+    src_x = pf.u.res[k].x;
+    src_y = pf.u.res[k].y;
+  }
+
+  return true;
+}
@@ -0,0 +1,613 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       path_checks.c
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Regression checks of the path-finder, on the table polygons of both
+ *   colors and on small hand-made layouts:
+ *   - A* search against the former sweep search (same graph).
+ *   - Orientation kernel on collinear, touching and large coordinates cases,
+ *     and against a floating-point reference on the table polygons.
+ *   - Smoothed paths: collision-free, not longer and with no more checkpoints
+ *     than the search results, from the start pose too.
+ *   - Start pose inside the teammate polygon.
+ *   - Table of the paths between the POIs.
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#include "host_check.h"
+
+// State of the checks random generator
+static uint32_t checks_rand_state = 1;
+
+// Same generator than path_bench_rand()
+static int32_t checks_rand(int32_t min, int32_t max) {
+  checks_rand_state = checks_rand_state * 1103515245UL + 12345UL;
+  return min + (int32_t) ((checks_rand_state >> 8) % (uint32_t) (max - min));
+}
+
+// -----------------------------------------------------------------------------
+// SEARCH
+// -----------------------------------------------------------------------------
+
+// Number of objectives searched, and reached
+static uint16_t checks_nb_searches;
+static uint16_t checks_nb_reached;
+
+// Reference search: the sweep relaxation of the former path_compute_dijkstra(),
+// repeated over all the rays until no point is improved, on the same graph and
+// ray weights, without any rotation cost.
+// Returns the time from the destination (point 0) to the robot (point 1), or
+// PATH_TIME_UNREACHABLE. The path of the robot is given in path[] (mm), when
+// it has no more than PATH_MAX_CHECKPOINTS checkpoints.
+static uint32_t check_sweep_search(uint16_t nb_rays, poi_t* path, uint8_t* nb_path) {
+
+  uint32_t time[PATH_MAX_POINTS];
+  path_pt_idx_t parent[PATH_MAX_POINTS];
+  path_pt_idx_t pt;
+  path_pt_idx_t g1;
+  path_pt_idx_t g2;
+  uint16_t i;
+  bool finished = false;
+
+  for(pt = 0; pt < pf.cur_pt_idx; pt++)
+    time[pt] = PATH_TIME_UNREACHABLE;
+  time[0] = 0;
+
+  while(!finished) {
+    finished = true;
+    for(i = 0; i < nb_rays; i++) {
+      g1 = pf.u.rays[i].pt1;
+      g2 = pf.u.rays[i].pt2;
+      if((time[g1] != PATH_TIME_UNREACHABLE) && (time[g1] + pf.weight[i] < time[g2])) {
+        time[g2] = time[g1] + pf.weight[i];
+        parent[g2] = g1;
+        finished = false;
+      }
+      if((time[g2] != PATH_TIME_UNREACHABLE) && (time[g2] + pf.weight[i] < time[g1])) {
+        time[g1] = time[g2] + pf.weight[i];
+        parent[g1] = g2;
+        finished = false;
+      }
+    }
+  }
+
+  *nb_path = 0;
+  if(time[1] != PATH_TIME_UNREACHABLE) {
+    for(pt = 1; pt != 0; pt = parent[pt]) {
+      if(*nb_path >= PATH_MAX_CHECKPOINTS) {
+        *nb_path = 0;
+        break;
+      }
+      path[*nb_path].x = 10 * pf.pts[parent[pt]].x;
+      path[*nb_path].y = 10 * pf.pts[parent[pt]].y;
+      (*nb_path)++;
+    }
+  }
+
+  return time[1];
+}
+
+// The A* search must reach the same objectives than the former search.
+// Without rotation costs, both minimise the sum of the ray weights so the
+// times must be the same. With them, the A* path must not be slower than the
+// one of the former search, charged with the same rotations (estimated again,
+// each one may differ by 1 ms).
+static void check_search(match_color_e color, int32_t src_x, int32_t src_y,
+                         int32_t dst_x, int32_t dst_y) {
+
+  poi_t path[PATH_MAX_CHECKPOINTS];
+  uint8_t nb_path;
+  uint16_t nb_rays;
+  uint32_t time;
+  uint32_t turn_start_ms;
+  int16_t heading;
+  uint32_t path_time;
+  bool reached;
+
+  path_set_objective(src_x, src_y, dst_x, dst_y);
+  nb_rays = path_compute_rays(pf.polys, pf.cur_poly_idx, pf.u.rays);
+  path_compute_rays_weight(pf.u.rays, nb_rays, pf.weight);
+  pf.nb_rays = nb_rays;
+
+  time = check_sweep_search(nb_rays, path, &nb_path);
+  path_compute_adjacency(pf.u.rays, nb_rays);
+
+  // Free rotations
+  turn_start_ms = pf.turn_start_ms;
+  pf.turn_start_ms = UINT32_MAX;
+  path_compute_astar(0, 0, 0, 1);
+  pf.turn_start_ms = turn_start_ms;
+
+  reached = (pf.pts[1].valid == PATH_DIJ_PT_VISITED);
+  checks_nb_searches++;
+  checks_nb_reached += reached;
+  HOST_CHECK(reached == (time != PATH_TIME_UNREACHABLE),
+             "color %u: (%d,%d)->(%d,%d) reached by the %s search only",
+             color, src_x, src_y, dst_x, dst_y, reached ? "A*" : "former");
+  HOST_CHECK(!reached || (pf.est_time_ms == time),
+             "color %u: (%d,%d)->(%d,%d) A* time %u instead of %u",
+             color, src_x, src_y, dst_x, dst_y, pf.est_time_ms, time);
+
+  if(!reached || !nb_path)
+    return;
+
+  // Rotations of the former path
+  memcpy(pf.u.res, path, nb_path * sizeof(poi_t));
+  path_time = time + 2 * nb_path + path_estimate_time(10 * pf.pts[1].x, 10 * pf.pts[1].y, nb_path);
+  heading = pf.heading;
+  path_set_heading(PATH_HEADING_NONE);
+  pf.turn_start_ms = UINT32_MAX;
+  path_time -= path_estimate_time(10 * pf.pts[1].x, 10 * pf.pts[1].y, nb_path);
+  pf.turn_start_ms = turn_start_ms;
+  path_set_heading(heading);
+
+  // Rotations charged
+  path_compute_astar(0, 0, 0, 1);
+  time = pf.est_time_ms;
+
+  HOST_CHECK(pf.pts[1].valid == PATH_DIJ_PT_VISITED,
+             "color %u: (%d,%d)->(%d,%d) not reached with rotations", color, src_x, src_y, dst_x, dst_y);
+  HOST_CHECK(time <= path_time,
+             "color %u: (%d,%d)->(%d,%d) A* time %u, former path %u",
+             color, src_x, src_y, dst_x, dst_y, time, path_time);
+}
+
+// Search checks between all the POIs of the table, then between random points
+static void check_searches(match_color_e color, uint16_t nb_random) {
+
+  uint8_t src;
+  uint8_t dst;
+  uint16_t k;
+
+  host_table_init(color);
+  path_set_motion(WP_SPEED_NORMAL, WP_GOTO_FWD);
+  path_set_heading(phys.reset.a);
+
+  for(src = 0; src < PHYS_NB_POI_PATHS; src++) {
+    for(dst = 0; dst < PHYS_NB_POI_PATHS; dst++) {
+      if(src != dst)
+        check_search(color, phys.pf_pois[src].x, phys.pf_pois[src].y,
+                     phys.pf_pois[dst].x, phys.pf_pois[dst].y);
+    }
+  }
+
+  for(k = 0; k < nb_random; k++) {
+    check_search(color, checks_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50),
+                 checks_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50),
+                 checks_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50),
+                 checks_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50));
+  }
+}
+
+// -----------------------------------------------------------------------------
+// ORIENTATION KERNEL
+// -----------------------------------------------------------------------------
+
+// Segments crossing status of 4 points (mm/10)
+static path_seg_cross_e check_segments(int32_t s1x, int32_t s1y, int32_t s2x, int32_t s2y,
+                                       int32_t t1x, int32_t t1y, int32_t t2x, int32_t t2y) {
+  path_proc_pt_t s1 = {.x = s1x, .y = s1y};
+  path_proc_pt_t s2 = {.x = s2x, .y = s2y};
+  path_proc_pt_t t1 = {.x = t1x, .y = t1y};
+  path_proc_pt_t t2 = {.x = t2x, .y = t2y};
+  return path_orient_segments(&s1, &s2, &t1, &t2);
+}
+
+// Orientation of c relatively to [a;b], computed on doubles (exact below 2^26)
+static int8_t check_ref_orient(const path_proc_pt_t* a, const path_proc_pt_t* b, const path_proc_pt_t* c) {
+  double z = (double) (b->x - a->x) * (c->y - a->y) - (double) (b->y - a->y) * (c->x - a->x);
+  return (z > 0) - (z < 0);
+}
+
+// Hand-made cases of each classification
+static void check_orient_cases(void) {
+
+  path_poly_t* sq;
+  path_proc_pt_t p;
+
+  // Segments
+  HOST_CHECK(check_segments(0, 0, 10, 10, 0, 10, 10, 0) == PATH_SEG_CROSS, "orient: X");
+  HOST_CHECK(check_segments(0, 0, 10, 0, 0, 5, 10, 5) == PATH_SEG_NO_CROSS, "orient: parallel");
+  HOST_CHECK(check_segments(0, 0, 10, 0, 11, 0, 20, 0) == PATH_SEG_NO_CROSS, "orient: collinear apart");
+  HOST_CHECK(check_segments(0, 0, 10, 0, 5, 0, 20, 0) == PATH_SEG_PARALLEL_CROSS, "orient: collinear overlap");
+  HOST_CHECK(check_segments(0, 0, 10, 0, 10, 0, 20, 0) == PATH_SEG_PARALLEL_CROSS, "orient: collinear end to end");
+  HOST_CHECK(check_segments(0, 0, 10, 0, 2, 0, 8, 0) == PATH_SEG_PARALLEL_CROSS, "orient: collinear inside");
+  HOST_CHECK(check_segments(0, 0, 10, 0, 5, 0, 5, 10) == PATH_SEG_CROSS_POINT, "orient: T");
+  HOST_CHECK(check_segments(0, 0, 10, 0, 10, 0, 10, 10) == PATH_SEG_CROSS_POINT, "orient: L");
+  HOST_CHECK(check_segments(0, 0, 10, 0, 11, -5, 11, 5) == PATH_SEG_NO_CROSS, "orient: T apart");
+  HOST_CHECK(check_segments(0, 0, 0, 0, -5, 0, 5, 0) == PATH_SEG_NO_CROSS, "orient: dummy segment");
+
+  // Nearly parallel, with products out of 32 bits
+  HOST_CHECK(check_segments(0, 0, 60000, 60001, 0, 1, 60000, 60002) == PATH_SEG_NO_CROSS,
+             "orient: large parallel");
+  HOST_CHECK(check_segments(0, 0, 60000, 60001, 0, 1, 60000, 60000) == PATH_SEG_CROSS,
+             "orient: large nearly parallel");
+  HOST_CHECK(check_segments(-60000, 0, 60000, 1, 0, -60000, 1, 60000) == PATH_SEG_CROSS,
+             "orient: large X");
+
+  // Point and polygon
+  path_init();
+  sq = path_add_new_poly(4);
+  path_poly_set_points(sq, 0, 1000, 1000);
+  path_poly_set_points(sq, 1, 2000, 1000);
+  path_poly_set_points(sq, 2, 2000, 2000);
+  path_poly_set_points(sq, 3, 1000, 2000);
+
+  p.x = 150; p.y = 150;
+  HOST_CHECK(path_orient_pt_in_poly(&p, sq) == PATH_PT_POLY_INSIDE, "orient: point inside");
+  p.x = 250; p.y = 150;
+  HOST_CHECK(path_orient_pt_in_poly(&p, sq) == PATH_PT_POLY_OUTSIDE, "orient: point outside");
+  p.x = 200; p.y = 150;
+  HOST_CHECK(path_orient_pt_in_poly(&p, sq) == PATH_PT_POLY_ON_EDGE, "orient: point on edge");
+  p.x = 200; p.y = 200;
+  HOST_CHECK(path_orient_pt_in_poly(&p, sq) == PATH_PT_POLY_ON_EDGE, "orient: point on vertex");
+  p.x = 250; p.y = 100;
+  HOST_CHECK(path_orient_pt_in_poly(&p, sq) == PATH_PT_POLY_OUTSIDE, "orient: point aligned with an edge");
+
+  // Segment and polygon
+  HOST_CHECK(!path_is_segment_free(1000, 1000, 2000, 2000), "orient: diagonal is free");
+  HOST_CHECK(!path_is_segment_free(500, 1500, 2500, 1500), "orient: crossing segment is free");
+  HOST_CHECK(!path_is_segment_free(500, 1500, 1500, 1500), "orient: segment ending inside is free");
+  HOST_CHECK(path_is_segment_free(500, 500, 1000, 1000), "orient: segment to a corner is not free");
+  HOST_CHECK(path_is_segment_free(500, 1500, 1000, 1500), "orient: segment to an edge is not free");
+  HOST_CHECK(path_is_segment_free(500, 2000, 1000, 1500), "orient: segment to an edge (slanted) is not free");
+  HOST_CHECK(path_is_segment_free(0, 1000, 3000, 1000), "orient: segment along an edge is not free");
+  HOST_CHECK(path_is_segment_free(2500, 1500, 1500, 2500), "orient: segment by a corner is not free");
+  HOST_CHECK(!path_is_segment_free(2500, 1490, 1490, 2500), "orient: segment cutting a corner is free");
+}
+
+// Segments between the table polygons vertices (collinear and touching cases)
+// and random points, against the floating-point reference
+static void check_orient_table(match_color_e color, uint16_t nb_random) {
+
+  path_proc_pt_t pts[4];
+  path_seg_cross_e expected;
+  path_seg_cross_e ret;
+  int8_t o1;
+  int8_t o2;
+  int8_t o3;
+  int8_t o4;
+  uint16_t k;
+  uint8_t i;
+
+  host_table_init(color);
+  path_update_inflated_polys();
+
+  for(k = 0; k < nb_random; k++) {
+
+    // Each point is a polygon vertex or a random point, half of the time
+    for(i = 0; i < 4; i++) {
+      if(checks_rand(0, 2)) {
+        pts[i] = pf.pts[checks_rand(PATH_OBJECTIVE_POINTS, pf.cur_pt_idx)];
+      } else {
+        pts[i].x = checks_rand(TABLE_X_MIN, TABLE_X_MAX) / 10;
+        pts[i].y = checks_rand(TABLE_Y_MIN, TABLE_Y_MAX) / 10;
+      }
+    }
+
+    o1 = check_ref_orient(&pts[2], &pts[3], &pts[0]);
+    o2 = check_ref_orient(&pts[2], &pts[3], &pts[1]);
+    o3 = check_ref_orient(&pts[0], &pts[1], &pts[2]);
+    o4 = check_ref_orient(&pts[0], &pts[1], &pts[3]);
+
+    if(((pts[0].x == pts[1].x) && (pts[0].y == pts[1].y)) ||
+       ((pts[2].x == pts[3].x) && (pts[2].y == pts[3].y)))
+      expected = PATH_SEG_NO_CROSS;
+    else if(!o1 && !o2)
+      expected = ((MAX(MIN(pts[0].x, pts[1].x), MIN(pts[2].x, pts[3].x)) <=
+                   MIN(MAX(pts[0].x, pts[1].x), MAX(pts[2].x, pts[3].x))) &&
+                  (MAX(MIN(pts[0].y, pts[1].y), MIN(pts[2].y, pts[3].y)) <=
+                   MIN(MAX(pts[0].y, pts[1].y), MAX(pts[2].y, pts[3].y)))) ?
+                 PATH_SEG_PARALLEL_CROSS : PATH_SEG_NO_CROSS;
+    else if((o1 * o2 > 0) || (o3 * o4 > 0))
+      expected = PATH_SEG_NO_CROSS;
+    else if(!o1 || !o2 || !o3 || !o4)
+      expected = PATH_SEG_CROSS_POINT;
+    else
+      expected = PATH_SEG_CROSS;
+
+    ret = path_orient_segments(&pts[0], &pts[1], &pts[2], &pts[3]);
+    HOST_CHECK(ret == expected, "color %u: [%d,%d;%d,%d] [%d,%d;%d,%d] crossing %u instead of %u",
+               color, pts[0].x, pts[0].y, pts[1].x, pts[1].y,
+               pts[2].x, pts[2].y, pts[3].x, pts[3].y, ret, expected);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// SMOOTHING
+// -----------------------------------------------------------------------------
+
+// Checkpoints of the results, before and after smoothing
+static uint16_t checks_nb_raw_checkpoints;
+static uint16_t checks_nb_smooth_checkpoints;
+
+// Length (mm) of the first checkpoints of the result from a source point
+static float check_result_length(int32_t src_x, int32_t src_y, int8_t nb_checkpoints) {
+
+  int8_t k;
+  float length = 0;
+
+  for(k = 0; k < nb_checkpoints; k++) {
+    length += hypotf(pf.u.res[k].x - src_x, pf.u.res[k].y - src_y);
+    src_x = pf.u.res[k].x;
+    src_y = pf.u.res[k].y;
+  }
+
+  return length;
+}
+
+// Smooth the search result of an objective, it must still be free, reach the
+// destination, and not be longer (but by the clearance of its checkpoints)
+static void check_smooth(match_color_e color, int32_t src_x, int32_t src_y,
+                         int32_t dst_x, int32_t dst_y) {
+
+  uint16_t nb_rays;
+  int8_t nb_raw;
+  int8_t nb_smooth;
+  float raw_length;
+
+  path_set_objective(src_x, src_y, dst_x, dst_y);
+  src_x = 10 * pf.pts[1].x;
+  src_y = 10 * pf.pts[1].y;
+
+  nb_rays = path_compute_rays(pf.polys, pf.cur_poly_idx, pf.u.rays);
+  path_compute_rays_weight(pf.u.rays, nb_rays, pf.weight);
+  pf.nb_rays = nb_rays;
+  path_compute_adjacency(pf.u.rays, nb_rays);
+  path_compute_astar(0, 0, 0, 1);
+
+  nb_raw = path_get_result(pf.polys, pf.u.rays);
+  if(nb_raw == PATH_RESULT_ERROR)
+    return;
+
+  raw_length = check_result_length(src_x, src_y, nb_raw);
+  nb_smooth = path_smooth(src_x, src_y, nb_raw);
+
+  checks_nb_raw_checkpoints += nb_raw;
+  checks_nb_smooth_checkpoints += nb_smooth;
+
+  HOST_CHECK((nb_smooth > 0) && (nb_smooth <= nb_raw),
+             "color %u: (%d,%d)->(%d,%d) %d checkpoints smoothed into %d",
+             color, src_x, src_y, dst_x, dst_y, nb_raw, nb_smooth);
+  HOST_CHECK((pf.u.res[nb_smooth-1].x == 10 * pf.pts[0].x) && (pf.u.res[nb_smooth-1].y == 10 * pf.pts[0].y),
+             "color %u: (%d,%d)->(%d,%d) smoothed path misses the destination",
+             color, src_x, src_y, dst_x, dst_y);
+  HOST_CHECK(host_result_is_free(src_x, src_y, nb_smooth),
+             "color %u: (%d,%d)->(%d,%d) smoothed path crosses a polygon",
+             color, src_x, src_y, dst_x, dst_y);
+  HOST_CHECK(check_result_length(src_x, src_y, nb_smooth) <=
+             raw_length + 1 + 2 * PATH_SMOOTH_CLEARANCE_MM * nb_smooth,
+             "color %u: (%d,%d)->(%d,%d) smoothed path is longer",
+             color, src_x, src_y, dst_x, dst_y);
+}
+
+// Square in the middle of the table: collinear checkpoints are merged,
+// shortcuts crossing the square are not taken
+static void check_smooth_cases(void) {
+
+  path_poly_t* sq;
+
+  path_init();
+  sq = path_add_new_poly(4);
+  path_poly_set_points(sq, 0, 1000, 1000);
+  path_poly_set_points(sq, 1, 2000, 1000);
+  path_poly_set_points(sq, 2, 2000, 2000);
+  path_poly_set_points(sq, 3, 1000, 2000);
+
+  // Along the square
+  pf.u.res[0].x = 1000; pf.u.res[0].y = 900;
+  pf.u.res[1].x = 1500; pf.u.res[1].y = 900;
+  pf.u.res[2].x = 2500; pf.u.res[2].y = 900;
+  HOST_CHECK(path_smooth(500, 900, 3) == 1, "smooth: collinear checkpoints kept");
+  HOST_CHECK((pf.u.res[0].x == 2500) && (pf.u.res[0].y == 900), "smooth: destination moved");
+
+  // To a corner of the square, then a detour along its edge that can be cut
+  pf.u.res[0].x = 1000; pf.u.res[0].y = 1000;
+  pf.u.res[1].x = 2000; pf.u.res[1].y = 1000;
+  pf.u.res[2].x = 2200; pf.u.res[2].y = 500;
+  pf.u.res[3].x = 2500; pf.u.res[3].y = 1000;
+  HOST_CHECK(path_smooth(500, 1500, 4) == 2, "smooth: detour not cut");
+  HOST_CHECK((pf.u.res[0].x == 1000) && (pf.u.res[0].y == 1000),
+             "smooth: corner of the square dropped");
+  HOST_CHECK(host_result_is_free(500, 1500, 2), "smooth: path crosses the square");
+}
+
+// Smoothing checks between all the POIs of the table (start pose included),
+// then between random points
+static void check_smooths(match_color_e color, uint16_t nb_random) {
+
+  uint8_t src;
+  uint8_t dst;
+  uint16_t k;
+
+  host_table_init(color);
+  path_set_motion(WP_SPEED_NORMAL, WP_GOTO_FWD);
+  path_set_heading(phys.reset.a);
+
+  for(src = 0; src < PHYS_NB_POI_PATHS; src++) {
+    for(dst = 0; dst < PHYS_NB_POI_PATHS; dst++) {
+      if(src != dst)
+        check_smooth(color, phys.pf_pois[src].x, phys.pf_pois[src].y,
+                     phys.pf_pois[dst].x, phys.pf_pois[dst].y);
+    }
+  }
+
+  for(k = 0; k < nb_random; k++) {
+    check_smooth(color, checks_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50),
+                 checks_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50),
+                 checks_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50),
+                 checks_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50));
+  }
+}
+
+// -----------------------------------------------------------------------------
+// START POSE
+// -----------------------------------------------------------------------------
+
+// The robot starts next to the teammate, inside its inflated polygon: it must
+// still leave the start area, and the task going there must be reachable.
+static void check_start_pose(match_color_e color) {
+
+  int8_t nb_checkpoints;
+  poi_t goal;
+
+  host_table_init(color);
+  path_set_motion(WP_SPEED_VERY_SLOW, WP_GOTO_FWD);
+  path_set_heading(phys.reset.a);
+
+  // Otherwise this check is pointless
+  HOST_CHECK(!path_is_segment_free(phys.reset.x, phys.reset.y, phys.exit_start.x, phys.exit_start.y),
+             "color %u: start pose is not inside a polygon anymore", color);
+
+  nb_checkpoints = path_find(phys.reset.x, phys.reset.y, phys.exit_start.x, phys.exit_start.y);
+  HOST_CHECK(nb_checkpoints != PATH_RESULT_ERROR, "color %u: no path out of the start area", color);
+
+  // Only the first segment leaves the polygon
+  HOST_CHECK(host_result_is_free(phys.reset.x, phys.reset.y, nb_checkpoints),
+             "color %u: path out of the start area crosses a polygon", color);
+
+  goal = phys.exit_start;
+  path_set_motion(WP_SPEED_NORMAL, WP_GOTO_FWD);
+  HOST_CHECK(path_compute_travel_times(phys.reset.x, phys.reset.y, &goal, 1) == 1,
+             "color %u: start exit has no travel time", color);
+}
+
+// Robot inside a single square: it leaves through the nearest corner
+static void check_escape_nearest_vertex(void) {
+
+  path_poly_t* poly;
+  int8_t nb_checkpoints;
+
+  path_init();
+  poly = path_add_new_poly(4);
+  path_poly_set_points(poly, 0, 800, 800);
+  path_poly_set_points(poly, 1, 1200, 800);
+  path_poly_set_points(poly, 2, 1200, 1200);
+  path_poly_set_points(poly, 3, 800, 1200);
+
+  path_set_objective(1150, 850, 2000, 1500);
+  nb_checkpoints = path_process();
+
+  HOST_CHECK(nb_checkpoints == 2, "escape: %d checkpoints instead of 2", nb_checkpoints);
+  HOST_CHECK((pf.u.res[0].x == 1200) && (pf.u.res[0].y == 800),
+             "escape: left through (%d,%d) instead of (1200,800)", pf.u.res[0].x, pf.u.res[0].y);
+
+  // The destination stays unreachable from inside a polygon
+  path_set_objective(2000, 1500, 1150, 850);
+  HOST_CHECK(path_process() == PATH_RESULT_ERROR, "escape: destination inside a polygon reached");
+}
+
+// -----------------------------------------------------------------------------
+// POI PATHS TABLE
+// -----------------------------------------------------------------------------
+
+// The table is built one pair at a time: the path-finder must be left as it
+// was, and the paths of the table must be free
+static void check_poi_paths(match_color_e color) {
+
+  uint8_t src;
+  uint8_t dst;
+  uint8_t nb_paths = 0;
+  int8_t nb_checkpoints;
+
+  host_table_init(color);
+
+  HOST_CHECK(!pf.static_only, "color %u: static only map left after the POI paths", color);
+
+  for(src = 0; src < PHYS_NB_POI_PATHS; src++) {
+    for(dst = 0; dst < PHYS_NB_POI_PATHS; dst++) {
+
+      if(src == dst)
+        continue;
+
+      nb_checkpoints = phys_get_poi_path(phys.pf_pois[src].x, phys.pf_pois[src].y,
+                                         phys.pf_pois[dst].x, phys.pf_pois[dst].y);
+      if(nb_checkpoints == PATH_RESULT_ERROR)
+        continue;
+
+      nb_paths++;
+      HOST_CHECK(host_result_is_free(phys.pf_pois[src].x, phys.pf_pois[src].y, nb_checkpoints),
+                 "color %u: POI path %u->%u crosses a polygon", color, src, dst);
+    }
+  }
+
+  HOST_CHECK(nb_paths > 0, "color %u: empty POI paths table", color);
+}
+
+// -----------------------------------------------------------------------------
+// OPPONENTS SOFT COSTS
+// -----------------------------------------------------------------------------
+
+// Returns the number of active hazards
+static uint8_t check_nb_hazards(void) {
+
+  uint8_t idx;
+  uint8_t nb = 0;
+
+  for(idx = 0; idx < PATH_MAX_HAZARDS; idx++) {
+    if(pf.hazards[idx].active)
+      nb++;
+  }
+
+  return nb;
+}
+
+// The initial guesses of the opponents positions do not charge the paths,
+// only their detections do, the second one with a prediction
+static void check_opponent_hazards(match_color_e color) {
+
+  host_table_init(color);
+  HOST_CHECK(check_nb_hazards() == 0,
+             "color %u: %u hazards from the initial opponents positions", color, check_nb_hazards());
+
+  phys_set_opponent_position(1, 1500, 1000);
+  HOST_CHECK(pf.hazards[0].active && !pf.hazards[1].active,
+             "color %u: first detection hazards %u/%u instead of 1/0",
+             color, pf.hazards[0].active, pf.hazards[1].active);
+
+  // 50 mm in 100 ms: predicted 500 mm further in 1 s
+  host_ticks += pdMS_TO_TICKS(100);
+  phys_set_opponent_position(1, 1550, 1000);
+  HOST_CHECK(pf.hazards[1].active && (pf.hazards[1].x == 205) && (pf.hazards[1].y == 100),
+             "color %u: prediction at (%d,%d) instead of (205,100)",
+             color, pf.hazards[1].x, pf.hazards[1].y);
+
+  // Dropped with the mirrored positions
+  phys_update_color_polys();
+  HOST_CHECK(check_nb_hazards() == 0,
+             "color %u: %u hazards left after the color update", color, check_nb_hazards());
+}
+
+int main(int argc, char** argv) {
+
+  check_orient_cases();
+  check_orient_table(MATCH_COLOR_GREEN, 5000);
+  check_orient_table(MATCH_COLOR_ORANGE, 5000);
+  check_searches(MATCH_COLOR_GREEN, 500);
+  check_searches(MATCH_COLOR_ORANGE, 500);
+  check_smooth_cases();
+  check_smooths(MATCH_COLOR_GREEN, 500);
+  check_smooths(MATCH_COLOR_ORANGE, 500);
+  check_poi_paths(MATCH_COLOR_GREEN);
+  check_poi_paths(MATCH_COLOR_ORANGE);
+  check_start_pose(MATCH_COLOR_GREEN);
+  check_start_pose(MATCH_COLOR_ORANGE);
+  check_escape_nearest_vertex();
+  check_opponent_hazards(MATCH_COLOR_GREEN);
+  check_opponent_hazards(MATCH_COLOR_ORANGE);
+
+  printf("# path checks: %u searches compared (%u reached), "
+         "%u checkpoints smoothed into %u, %u failed"HOST_EOL,
+         checks_nb_searches, checks_nb_reached,
+         checks_nb_raw_checkpoints, checks_nb_smooth_checkpoints, host_nb_failed);
+
+  return HOST_CHECK_RESULT();
+}
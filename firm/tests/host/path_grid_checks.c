@@ -0,0 +1,225 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       path_grid_checks.c
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Checks of the grid backend (built with PATH_GRID_ENABLE): on the table
+ *   of both colors, with and without random obstacles, the jump-point search
+ *   must agree with the visibility graph on which destinations are reachable,
+ *   and its paths must be free.
+ *   The grid blocks every cell an edge crosses, so it may close a gap narrower
+ *   than GRID_GAP_MM the visibility graph goes through: a destination only
+ *   reached by the visibility graph is accepted when it is not reached anymore
+ *   with all the polygons grown by GRID_GAP_MM (or when the source is then
+ *   inside one of them).
+ *   Sources inside a polygon are skipped, only the visibility graph leaves it.
+ *
+ *   Usage: path_grid_checks [nb_scenarios [seed]]
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#include "host_check.h"
+
+#if !PATH_GRID_ENABLE
+#error "The grid checks must be built with PATH_GRID_ENABLE"
+#endif
+
+// Narrowest gap (mm) the grid search is expected to go through
+#define GRID_GAP_MM (3 * PATH_GRID_CELL_MM)
+
+// Random obstacles of the current scenario
+typedef struct {
+  path_poly_t* poly;
+  int32_t x;
+  int32_t y;
+  int32_t w;
+  int32_t h;
+} grid_obstacle_t;
+
+static grid_obstacle_t grid_obstacles[PATH_MAX_POLYS];
+static uint8_t grid_nb_obstacles;
+
+// Number of destinations only reached by the visibility graph, through a gap
+static uint16_t grid_nb_gaps;
+
+// State of the scenarios random generator
+static uint32_t grid_rand_state;
+
+// Same generator than path_bench_rand()
+static int32_t grid_rand(int32_t min, int32_t max) {
+  grid_rand_state = grid_rand_state * 1103515245UL + 12345UL;
+  return min + (int32_t) ((grid_rand_state >> 8) % (uint32_t) (max - min));
+}
+
+// Set the points of the random obstacles, grown by a margin (mm)
+static void grid_set_obstacles(int16_t margin) {
+
+  uint8_t idx;
+  grid_obstacle_t* obs;
+
+  for(idx = 0; idx < grid_nb_obstacles; idx++) {
+    obs = &grid_obstacles[idx];
+    path_poly_set_points(obs->poly, 0, obs->x - obs->w - margin, obs->y - obs->h - margin);
+    path_poly_set_points(obs->poly, 1, obs->x + obs->w + margin, obs->y - obs->h - margin);
+    path_poly_set_points(obs->poly, 2, obs->x + obs->w + margin, obs->y + obs->h + margin);
+    path_poly_set_points(obs->poly, 3, obs->x - obs->w - margin, obs->y + obs->h + margin);
+  }
+}
+
+// Grow (or shrink back) all the polygons by a margin (mm): the inflated ones
+// of the table and the random obstacles
+static void grid_grow_polys(int16_t margin) {
+
+  uint8_t idx;
+
+  for(idx = 1; idx < pf.cur_poly_idx; idx++) {
+    if(pf.polys[idx].src_n) {
+      pf.polys[idx].margin += margin;
+      pf.polys[idx].inflate = true;
+    }
+  }
+
+  grid_set_obstacles((margin > 0) ? margin : 0);
+  pf.cache_valid = false;
+  path_new_epoch();
+}
+
+// Random rectangle obstacles, away from the table edges
+static void grid_add_obstacles(uint8_t nb_polys) {
+
+  grid_obstacle_t* obs;
+
+  for(grid_nb_obstacles = 0; grid_nb_obstacles < nb_polys; grid_nb_obstacles++) {
+
+    obs = &grid_obstacles[grid_nb_obstacles];
+    obs->x = grid_rand(300, TABLE_X_MAX - 300);
+    obs->y = grid_rand(300, TABLE_Y_MAX - 300);
+    obs->w = grid_rand(50, 200);
+    obs->h = grid_rand(50, 200);
+
+    obs->poly = path_add_new_poly(4);
+    if(obs->poly == NULL)
+      break;
+  }
+
+  grid_set_obstacles(0);
+}
+
+// Solve the same objective with both backends and compare them.
+// Returns false when the objective was skipped.
+static bool grid_compare(match_color_e color, uint16_t scenario,
+                         int32_t src_x, int32_t src_y, int32_t dst_x, int32_t dst_y) {
+
+  int8_t nb_checkpoints;
+  int8_t nb_grid_checkpoints;
+
+  if(host_is_in_polys(src_x, src_y))
+    return false;
+
+  path_set_objective(src_x, src_y, dst_x, dst_y);
+
+  path_set_backend(PATH_BACKEND_VISIBILITY);
+  pf.cache_valid = false;
+  nb_checkpoints = path_process();
+
+  path_set_backend(PATH_BACKEND_GRID);
+  path_grid_invalidate();
+  nb_grid_checkpoints = path_process();
+
+  path_set_backend(PATH_BACKEND_VISIBILITY);
+
+  HOST_CHECK((nb_checkpoints != PATH_RESULT_ERROR) || (nb_grid_checkpoints == PATH_RESULT_ERROR),
+             "color %u scenario %u: (%d,%d)->(%d,%d) reached by the grid only",
+             color, scenario, src_x, src_y, dst_x, dst_y);
+
+  // Only through a narrow gap?
+  if((nb_checkpoints != PATH_RESULT_ERROR) && (nb_grid_checkpoints == PATH_RESULT_ERROR)) {
+    grid_nb_gaps++;
+    grid_grow_polys(GRID_GAP_MM);
+    HOST_CHECK(host_is_in_polys(src_x, src_y) || (path_process() == PATH_RESULT_ERROR),
+               "color %u scenario %u: (%d,%d)->(%d,%d) reached by the visibility graph only",
+               color, scenario, src_x, src_y, dst_x, dst_y);
+    grid_grow_polys(-GRID_GAP_MM);
+  }
+
+  if(nb_grid_checkpoints != PATH_RESULT_ERROR) {
+    HOST_CHECK(nb_grid_checkpoints <= PATH_MAX_CHECKPOINTS,
+               "color %u scenario %u: %d grid checkpoints", color, scenario, nb_grid_checkpoints);
+    HOST_CHECK(host_result_is_free(src_x, src_y, nb_grid_checkpoints),
+               "color %u scenario %u: grid path crosses a polygon", color, scenario);
+  }
+
+  return true;
+}
+
+// Run the comparisons on the table of a color: between all the POIs, then
+// between random points with random obstacles.
+// Returns the number of compared objectives.
+static uint16_t grid_run(match_color_e color, uint16_t nb_scenarios, uint32_t seed) {
+
+  uint16_t scenario;
+  uint16_t nb_compared = 0;
+  uint8_t nb_polys;
+  uint8_t nb_points;
+  uint8_t nb_src_points;
+  uint8_t src;
+  uint8_t dst;
+
+  host_table_init(color);
+  nb_polys = pf.cur_poly_idx;
+  nb_points = pf.cur_pt_idx;
+  nb_src_points = pf.cur_src_idx;
+  grid_rand_state = seed;
+
+  for(src = 0; src < PHYS_NB_POI_PATHS; src++) {
+    for(dst = 0; dst < PHYS_NB_POI_PATHS; dst++) {
+      if(src != dst)
+        nb_compared += grid_compare(color, src * PHYS_NB_POI_PATHS + dst,
+                                    phys.pf_pois[src].x, phys.pf_pois[src].y,
+                                    phys.pf_pois[dst].x, phys.pf_pois[dst].y);
+    }
+  }
+
+  for(scenario = 0; scenario < nb_scenarios; scenario++) {
+
+    grid_add_obstacles(scenario % (PATH_MAX_POLYS - nb_polys + 1));
+
+    nb_compared += grid_compare(color, scenario,
+                                grid_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50),
+                                grid_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50),
+                                grid_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50),
+                                grid_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50));
+
+    // Remove the random obstacles
+    pf.cur_poly_idx = nb_polys;
+    pf.cur_pt_idx = nb_points;
+    pf.cur_src_idx = nb_src_points;
+    pf.cache_valid = false;
+    path_grid_invalidate();
+    path_new_epoch();
+  }
+
+  return nb_compared;
+}
+
+int main(int argc, char** argv) {
+
+  uint16_t nb_scenarios = (argc > 1) ? atoi(argv[1]) : 200;
+  uint32_t seed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+  uint16_t nb_compared;
+
+  nb_compared = grid_run(MATCH_COLOR_GREEN, nb_scenarios, seed);
+  nb_compared += grid_run(MATCH_COLOR_ORANGE, nb_scenarios, seed);
+
+  printf("# grid checks: %u objectives compared (%u through a narrow gap), %u failed"HOST_EOL,
+         nb_compared, grid_nb_gaps, host_nb_failed);
+
+  return HOST_CHECK_RESULT();
+}
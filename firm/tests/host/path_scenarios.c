@@ -0,0 +1,170 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       path_scenarios.c
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Host version of the path-finder benchmark ('seq pfbench' shell command).
+ *   The same random scenarios (same generator, same obstacles for a seed) are
+ *   processed on the table of both colors, and reported as CSV lines:
+ *
+ *     color,scenario,polys,points,rays,iterations,time_us,checkpoints,est_ms
+ *
+ *   On top of the benchmark, each path found is checked: it must not have
+ *   more than PATH_MAX_CHECKPOINTS checkpoints, all its segments must be free
+ *   and its estimated time must be set.
+ *
+ *   Usage: path_scenarios [nb_scenarios [seed]]
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#include "host_check.h"
+
+// State of the scenarios random generator
+static uint32_t scenarios_rand_state;
+
+// Same generator than path_bench_rand()
+static int32_t scenarios_rand(int32_t min, int32_t max) {
+  scenarios_rand_state = scenarios_rand_state * 1103515245UL + 12345UL;
+  return min + (int32_t) ((scenarios_rand_state >> 8) % (uint32_t) (max - min));
+}
+
+// Host time (us)
+static uint32_t scenarios_time_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t) (ts.tv_sec * 1000000UL + ts.tv_nsec / 1000);
+}
+
+// Same obstacles than path_bench_add_obstacles()
+static void scenarios_add_obstacles(uint8_t nb_polys) {
+
+  uint8_t idx;
+  int32_t x;
+  int32_t y;
+  int32_t w;
+  int32_t h;
+  path_poly_t* poly;
+
+  for(idx = 0; idx < nb_polys; idx++) {
+
+    x = scenarios_rand(300, TABLE_X_MAX - 300);
+    y = scenarios_rand(300, TABLE_Y_MAX - 300);
+    w = scenarios_rand(50, 200);
+    h = scenarios_rand(50, 200);
+
+    poly = path_add_new_poly((idx & 1) ? 8 : 4);
+    if(poly == NULL)
+      break;
+
+    if(idx & 1) {
+      path_poly_set_points(poly, 0, x -   w/2, y - 3*w/2);
+      path_poly_set_points(poly, 1, x +   w/2, y - 3*w/2);
+      path_poly_set_points(poly, 2, x + 3*w/2, y -   w/2);
+      path_poly_set_points(poly, 3, x + 3*w/2, y +   w/2);
+      path_poly_set_points(poly, 4, x +   w/2, y + 3*w/2);
+      path_poly_set_points(poly, 5, x -   w/2, y + 3*w/2);
+      path_poly_set_points(poly, 6, x - 3*w/2, y +   w/2);
+      path_poly_set_points(poly, 7, x - 3*w/2, y -   w/2);
+    } else {
+      path_poly_set_points(poly, 0, x - w, y - h);
+      path_poly_set_points(poly, 1, x + w, y - h);
+      path_poly_set_points(poly, 2, x + w, y + h);
+      path_poly_set_points(poly, 3, x - w, y + h);
+      path_poly_set_static(poly, true);
+    }
+  }
+}
+
+// Run the scenarios on the table of a color.
+// Returns the number of scenarios without path.
+static uint16_t scenarios_run(match_color_e color, uint16_t nb_scenarios, uint32_t seed) {
+
+  uint16_t scenario;
+  uint16_t nb_errors = 0;
+  uint32_t max_time_us = 0;
+  uint32_t time_us;
+  uint8_t nb_polys;
+  uint8_t nb_points;
+  uint8_t nb_src_points;
+  int32_t src_x;
+  int32_t src_y;
+  int8_t nb_checkpoints;
+
+  host_table_init(color);
+  nb_polys = pf.cur_poly_idx;
+  nb_points = pf.cur_pt_idx;
+  nb_src_points = pf.cur_src_idx;
+  scenarios_rand_state = seed;
+
+  for(scenario = 0; scenario < nb_scenarios; scenario++) {
+
+    scenarios_add_obstacles(scenario % (PATH_MAX_POLYS - nb_polys + 1));
+
+    src_x = scenarios_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50);
+    src_y = scenarios_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50);
+    path_set_objective(src_x, src_y,
+                       scenarios_rand(TABLE_X_MIN + 50, TABLE_X_MAX - 50),
+                       scenarios_rand(TABLE_Y_MIN + 50, TABLE_Y_MAX - 50));
+
+    // Full processing, rays cache rebuilt included
+    pf.cache_valid = false;
+    time_us = scenarios_time_us();
+    nb_checkpoints = path_process();
+    time_us = scenarios_time_us() - time_us;
+    max_time_us = MAX(max_time_us, time_us);
+
+    printf("%u,%u,%u,%u,%u,%u,%u,%d,%u"HOST_EOL,
+           color, scenario, pf.cur_poly_idx, pf.cur_pt_idx, pf.nb_rays,
+           pf.nb_astar_iterations, time_us, nb_checkpoints,
+           (nb_checkpoints == PATH_RESULT_ERROR) ? 0 : pf.est_time_ms);
+
+    if(nb_checkpoints == PATH_RESULT_ERROR) {
+      nb_errors++;
+    } else {
+      HOST_CHECK(nb_checkpoints <= PATH_MAX_CHECKPOINTS,
+                 "color %u scenario %u: %d checkpoints", color, scenario, nb_checkpoints);
+      HOST_CHECK(host_result_is_free(src_x, src_y, nb_checkpoints),
+                 "color %u scenario %u: path crosses a polygon", color, scenario);
+      HOST_CHECK(pf.est_time_ms > 0,
+                 "color %u scenario %u: no estimated time", color, scenario);
+    }
+
+    // Remove the random obstacles, as path_bench_print() does
+    pf.static_polys &= PATH_POLY_MASK(nb_polys) - 1;
+    pf.cur_poly_idx = nb_polys;
+    pf.cur_pt_idx = nb_points;
+    pf.cur_src_idx = nb_src_points;
+    pf.cache_valid = false;
+#if PATH_GRID_ENABLE
+    path_grid_invalidate();
+#endif
+    path_new_epoch();
+  }
+
+  printf("# color %u: %u scenarios, %u without path, max %u us"HOST_EOL,
+         color, nb_scenarios, nb_errors, max_time_us);
+
+  return nb_errors;
+}
+
+int main(int argc, char** argv) {
+
+  uint16_t nb_scenarios = (argc > 1) ? atoi(argv[1]) : 200;
+  uint32_t seed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+
+  printf("color,scenario,polys,points,rays,iterations,time_us,checkpoints,est_ms"HOST_EOL);
+
+  scenarios_run(MATCH_COLOR_GREEN, nb_scenarios, seed);
+  scenarios_run(MATCH_COLOR_ORANGE, nb_scenarios, seed);
+
+  printf("# %u failed checks"HOST_EOL, host_nb_failed);
+
+  return HOST_CHECK_RESULT();
+}
@@ -0,0 +1,199 @@
+/* -----------------------------------------------------------------------------
+ * BlueBoard
+ * I-Grebot
+ * -----------------------------------------------------------------------------
+ * @file       quadramp_checks.c
+ * @author     I-Grebot
+ * @date       2026/10/17
+ * -----------------------------------------------------------------------------
+ * @brief
+ *   Host checks of the quadramp consign filter (Aversive), with the distance
+ *   ramp settings of the robot: the speed, acceleration and jerk limits are
+ *   held, the output converges to the input without overshoot, and the speed
+ *   ends without a step when the input is not moved further than var_end
+ *   was planned for.
+ * -----------------------------------------------------------------------------
+ * Versionning informations
+ * Repository: https://github.com/I-Grebot/blueboard.git
+ * -----------------------------------------------------------------------------
+ */
+
+#include "host_check.h"
+
+// Ramp settings, given per period of QR_DIVIDER calls
+#define QR_SPEED          1200
+#define QR_ACC            40
+#define QR_DIVIDER        50
+
+// Calls after which a ramp must be finished
+#define QR_MAX_CALLS      20000
+
+// Float margin of the limits (per call)
+#define QR_EPS            1e-4f
+
+// Number of ramps checked
+static uint32_t qr_nb_ramps = 0;
+
+// Braking distance of a symmetric S-curve, reference of quadramp_braking_var()
+static double check_braking_distance(double v, double ve, double a, double j)
+{
+  double dv = v - ve;
+
+  if(dv <= 0)
+    return 0;
+
+  if(j == 0)
+    return (v*v - ve*ve) / (2*a);
+
+  if(dv >= a*a/j)
+    return (v + ve) / 2 * (a/j + dv/a);
+
+  return (v + ve) * sqrt(dv/j);
+}
+
+// Speed from which the braking distance is d, by bisection
+static double check_braking_var_ref(double d, double ve, double a, double j)
+{
+  double lo = ve, hi = ve + 1, mid;
+  uint8_t k;
+
+  while(check_braking_distance(hi, ve, a, j) < d)
+    hi = 2*hi;
+
+  for(k = 0; k < 100; k++) {
+    mid = (lo + hi) / 2;
+    if(check_braking_distance(mid, ve, a, j) < d)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+// quadramp_braking_var() is the inverse of the braking distance, on both
+// sides of the short/long brakings limit
+static void check_braking_var(void)
+{
+  static const float ends[] = {0, 1, 12, 600};
+  static const float jerks[] = {0, 0.01f, 1, 10};
+  uint8_t e, k;
+  float d, v, prev;
+  double ref;
+
+  for(e = 0; e < sizeof(ends)/sizeof(ends[0]); e++) {
+    for(k = 0; k < sizeof(jerks)/sizeof(jerks[0]); k++) {
+      prev = ends[e];
+      for(d = 0.5f; d < 1e6f; d *= 1.1f) {
+        v = quadramp_braking_var(d, ends[e], QR_ACC, jerks[k]);
+        ref = check_braking_var_ref(d, ends[e], QR_ACC, jerks[k]);
+        HOST_CHECK(fabs(v - ref) <= 1e-4 * ref + 1e-3,
+                   "braking var %.4f from %.0f over %.3f (jerk %.2f), not %.4f",
+                   v, ends[e], d, jerks[k], ref);
+        HOST_CHECK(v >= prev, "braking var %.4f decreasing at %.3f", v, d);
+        prev = v;
+      }
+    }
+  }
+}
+
+// Runs a ramp to the input, moved to next_in when the output reaches
+// switch_out (no move when 0), and checks the limits on each call
+static void check_ramp(const char* name, uint32_t jerk, uint32_t var_end,
+                       int32_t in, int32_t switch_out, int32_t next_in)
+{
+  struct quadramp_filter q;
+  float v_max = (float) QR_SPEED / QR_DIVIDER;
+  float acc_max = (float) QR_ACC / (QR_DIVIDER * QR_DIVIDER);
+  float jerk_max = (float) jerk / (QR_DIVIDER * QR_DIVIDER * QR_DIVIDER);
+  float v_min = INFINITY;
+  float prev_var = 0;
+  float prev_acc = 0;
+  float sign = (in < 0) ? -1 : 1;
+  int32_t out, prev_out = 0;
+  uint32_t call;
+
+  quadramp_init(&q);
+  quadramp_set_1st_order_vars(&q, QR_SPEED, QR_SPEED);
+  quadramp_set_2nd_order_vars(&q, QR_ACC, QR_ACC);
+  quadramp_set_3rd_order_var(&q, jerk);
+  quadramp_set_end_var(&q, var_end);
+  quadramp_set_period_divider(&q, QR_DIVIDER);
+
+  for(call = 0; call < QR_MAX_CALLS; call++) {
+
+    if(switch_out && (sign * prev_out >= sign * switch_out)) {
+      in = next_in;
+      switch_out = 0;
+      quadramp_set_end_var(&q, 0);
+    }
+
+    out = quadramp_do_filter(&q, in);
+
+    HOST_CHECK(sign * (in - out) >= 0, "%s: output %d passed the input %d",
+               name, out, in);
+    HOST_CHECK(fabsf(q.previous_var) <= v_max + QR_EPS,
+               "%s: speed %.4f above %.4f at %u", name, q.previous_var, v_max, call);
+
+    // The acceleration and the jerk are limited up to the last call, the
+    // speed being brought to 0 within the ramp
+    if(jerk || var_end) {
+      HOST_CHECK(fabsf(q.previous_var - prev_var) <= acc_max + QR_EPS,
+                 "%s: speed step %.4f -> %.4f above %.4f at %u",
+                 name, prev_var, q.previous_var, acc_max, call);
+    }
+    if(jerk && (out != in)) {
+      HOST_CHECK(fabsf(q.previous_acc - prev_acc) <= jerk_max + QR_EPS,
+                 "%s: acceleration step %.5f -> %.5f above %.5f at %u",
+                 name, prev_acc, q.previous_acc, jerk_max, call);
+    }
+
+    // Passed junction: the robot keeps moving
+    if(!switch_out && (in == next_in) && (out != in) && (fabsf(q.previous_var) < v_min))
+      v_min = fabsf(q.previous_var);
+
+    prev_var = q.previous_var;
+    prev_acc = q.previous_acc;
+    prev_out = out;
+
+    if(quadramp_is_finished(&q))
+      break;
+  }
+
+  HOST_CHECK(call < QR_MAX_CALLS && out == in,
+             "%s: not finished after %u calls, output %d for %d", name, call, out, in);
+  if(next_in && (next_in != in)) {
+    HOST_CHECK(v_min > acc_max,
+               "%s: stopped at the junction, speed %.4f", name, v_min);
+  }
+
+  qr_nb_ramps++;
+}
+
+int main(void) {
+
+  check_braking_var();
+
+  // Input set once, from a standstill to a standstill
+  check_ramp("trapezoid", 0, 0, 100000, 0, 0);
+  check_ramp("jerk", 10, 0, 100000, 0, 0);
+  check_ramp("jerk short", 10, 0, 3000, 0, 0);
+  check_ramp("jerk tiny", 10, 0, 7, 0, 0);
+  check_ramp("jerk neg", 10, 0, -50000, 0, 0);
+  check_ramp("jerk low", 1, 0, 20000, 0, 0);
+
+  // End speed, the input never being moved further
+  check_ramp("end", 0, 600, 100000, 0, 0);
+  check_ramp("jerk end", 10, 600, 100000, 0, 0);
+  check_ramp("jerk end short", 10, 600, 3000, 0, 0);
+  check_ramp("jerk end neg", 10, 600, -50000, 0, 0);
+
+  // Junction: the input is moved further near the first one
+  check_ramp("junction", 10, (uint32_t) quadramp_braking_var(50000, 0, QR_ACC, 10),
+             50000, 45000, 100000);
+  check_ramp("junction end", 0, 600, 50000, 45000, 100000);
+
+  printf("# quadramp checks: %u ramps, %u failed"HOST_EOL, qr_nb_ramps, host_nb_failed);
+
+  return HOST_CHECK_RESULT();
+}